@@ -273,8 +273,8 @@ class GameClient:
                 box(
                     f"{C.GAME} DÉBUT DE LA PARTIE",
                     f"Joueur : {C.BOLD}{data['player']}{C.RESET}\n"
-                    f"Plage  : {data['min']} - {data['max']}\n\n"
-                    f"{C.CYAN}💡 Commandes: stats | quit{C.RESET}",
+                    f"Plage  : {data['min']} - {data['max']} ({data.get('difficulty', 'easy')})\n\n"
+                    f"{C.CYAN}💡 Commandes: stats | level <difficulte> | quit{C.RESET}",
                     C.PURPLE
                 )
 
@@ -332,6 +332,11 @@ class GameClient:
                     elif resp_type == 'error':
                         print(f"{C.RED}{C.CROSS} {response['message']}{C.RESET}")
 
+                    # ARRÊT DU SERVEUR: la partie en cours peut se terminer
+                    elif resp_type == 'server_shutdown':
+                        seconds = response.get('deadline_ms', 0) // 1000
+                        print(f"{C.YELLOW}⚠️  {response['message']} ({seconds}s){C.RESET}")
+
                     # BYE
                     elif resp_type == 'bye':
                         print(f"{C.YELLOW}👋 {response['message']}{C.RESET}")
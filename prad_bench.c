@@ -0,0 +1,448 @@
+/**
+ * ============================================================================
+ * BANC DE LATENCE PING-PONG (TENTATIVE → INDICE)
+ * ============================================================================
+ *
+ * @file prad_bench.c
+ * @brief Client de mesure des chiffres de README.md: N connexions envoient
+ *        chacune M tentatives, une à la fois, et chronomètrent chaque indice
+ *        reçu (TCP, socket Unix de jeu, WebSocket natif ou proxy-server.js)
+ *
+ * PROTOCOLE:
+ * ---------
+ * Chaque connexion prend un nom, passe en difficulté "hard" (plage de 10^9:
+ * la tentative fixe ne gagne pratiquement jamais), attend les autres, puis
+ * envoie "7" et attend la ligne d'indice, M fois. Les latences de toutes les
+ * connexions sont triées ensemble (p50, p99); le débit est compté sur la
+ * durée totale. Avec -p, le CPU du processus mesuré (serveur ou proxy) est
+ * rapporté au nombre de messages, comme celui du banc lui-même.
+ *
+ * COMPILATION:
+ * -----------
+ * gcc -o prad_bench prad_bench.c -pthread -Wall -Wextra -O2
+ *
+ * EXÉCUTION:
+ * ---------
+ * ./server -o guess_rate=1000000 -o guess_burst=1000000 -o log_level=error &
+ * ./prad_bench [-t hôte:port | -u chemin | -w hôte:port] [-c connexions]
+ *              [-m tentatives] [-p pid] [-n] [-s]
+ *
+ * Au-delà de 8 connexions depuis une adresse non locale, relever aussi
+ * max_connections_per_ip. Les séries publiées sont des médianes de 5 à 7
+ * exécutions: une seule exécution varie de 20 à 30 % sur une machine
+ * partagée.
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE // memmem
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/resource.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+/* ============================================================================
+ * CONSTANTES DE CONFIGURATION
+ * ============================================================================ */
+#define MAX_CONNECTIONS         256         // Connexions simultanées au plus
+#define READ_BUFFER             8192        // Réception par connexion (greeting compris)
+#define DEFAULT_MESSAGES        20000       // Tentatives par connexion (-m)
+#define WS_KEY                  "dGhlIHNhbXBsZSBub25jZQ==" // Clé d'exemple de la RFC 6455
+
+/* ============================================================================
+ * STRUCTURES DE DONNÉES
+ * ============================================================================ */
+
+/**
+ * @enum transport_t
+ * @brief Chemin mesuré
+ */
+typedef enum {
+    TRANSPORT_TCP,                       // Port de jeu (-t)
+    TRANSPORT_UNIX,                      // Socket Unix de jeu (-u)
+    TRANSPORT_WS                         // WebSocket: ws_port ou proxy (-w)
+} transport_t;
+
+/**
+ * @struct bench_t
+ * @brief Paramètres communs à toutes les connexions
+ */
+typedef struct {
+    transport_t transport;               // Chemin mesuré
+    char host[256];                      // Hôte (TCP, WebSocket)
+    char port[8];                        // Port (TCP, WebSocket)
+    const char *path;                    // Socket Unix
+    int connections;                     // Connexions simultanées
+    int messages;                        // Tentatives par connexion
+    int nagle;                           // 1 = sans TCP_NODELAY
+    int split;                           // 1 = "7" et "\n" en deux écritures
+    double *latencies;                   // connections × messages, en µs
+    pthread_barrier_t start;             // Toutes prêtes avant la mesure
+} bench_t;
+
+/**
+ * @struct connection_t
+ * @brief Connexion mesurée et son buffer de réception
+ */
+typedef struct {
+    int id;                              // Index (nom et latences)
+    int fd;                              // Socket
+    char buffer[READ_BUFFER];            // Octets reçus pas encore consommés
+    size_t len;                          // Octets dans buffer
+} connection_t;
+
+static bench_t bench = {
+    .transport = TRANSPORT_TCP, .host = "127.0.0.1", .port = "8080",
+    .connections = 1, .messages = DEFAULT_MESSAGES
+};
+
+/* ============================================================================
+ * UTILITAIRES
+ * ============================================================================ */
+
+/**
+ * @brief Horloge monotone en nanosecondes
+ */
+static long long now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+/**
+ * @brief Temps CPU d'un processus (utilisateur + système), en µs
+ * @param pid Processus
+ * @return Temps consommé, -1 si /proc illisible
+ */
+static double process_cpu_us(int pid) {
+    char path[64], line[1024];
+    unsigned long user, system;
+
+    snprintf(path, sizeof(path), "/proc/%d/stat", pid);
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        return -1;
+    }
+    char *read = fgets(line, sizeof(line), file);
+    fclose(file);
+
+    // Champs 14 et 15, comptés après le nom entre parenthèses
+    char *fields = read ? strrchr(line, ')') : NULL;
+    if (!fields || sscanf(fields + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+                          &user, &system) != 2) {
+        return -1;
+    }
+    return (double)(user + system) * 1e6 / (double)sysconf(_SC_CLK_TCK);
+}
+
+/**
+ * @brief Temps CPU du banc lui-même, en µs
+ */
+static double self_cpu_us(void) {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1e6 +
+           usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+}
+
+/**
+ * @brief Ordre croissant des latences (qsort)
+ */
+static int compare_latency(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/* ============================================================================
+ * CONNEXION ET ÉCHANGES
+ * ============================================================================ */
+
+/**
+ * @brief Ouvre une connexion (poignée de main WebSocket comprise)
+ * @return Socket connecté, -1 en cas d'erreur
+ */
+static int bench_dial(void) {
+    int fd = -1;
+
+    if (bench.transport == TRANSPORT_UNIX) {
+        struct sockaddr_un addr = {.sun_family = AF_UNIX};
+        snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", bench.path);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+            close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+    struct addrinfo *result = NULL;
+    if (getaddrinfo(bench.host, bench.port, &hints, &result) != 0) {
+        return -1;
+    }
+    fd = socket(result->ai_family, SOCK_STREAM, 0);
+    int nodelay = !bench.nagle;
+    if (fd >= 0 && (connect(fd, result->ai_addr, result->ai_addrlen) < 0 ||
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay)) < 0)) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(result);
+
+    if (fd >= 0 && bench.transport == TRANSPORT_WS) {
+        char request[512];
+        int len = snprintf(request, sizeof(request),
+                           "GET / HTTP/1.1\r\nHost: %s:%s\r\nUpgrade: websocket\r\n"
+                           "Connection: Upgrade\r\nSec-WebSocket-Key: " WS_KEY "\r\n"
+                           "Sec-WebSocket-Version: 13\r\n\r\n", bench.host, bench.port);
+        if (send(fd, request, (size_t)len, MSG_NOSIGNAL) != len) {
+            close(fd);
+            return -1;
+        }
+    }
+    return fd;
+}
+
+/**
+ * @brief Envoie une ligne (trame texte masquée en WebSocket, sans "\n")
+ * @param conn Connexion
+ * @param line Ligne terminée par "\n"
+ * @return 0 si envoyée, -1 sinon
+ */
+static int bench_send(connection_t *conn, const char *line) {
+    size_t len = strlen(line);
+
+    if (bench.transport == TRANSPORT_WS) {
+        uint8_t frame[6 + 125];
+        const uint8_t mask[4] = {1, 2, 3, 4};
+        len--;
+        frame[0] = 0x81;
+        frame[1] = (uint8_t)(0x80 | len);
+        memcpy(frame + 2, mask, sizeof(mask));
+        for (size_t i = 0; i < len; i++) {
+            frame[6 + i] = (uint8_t)line[i] ^ mask[i & 3];
+        }
+        return (send(conn->fd, frame, 6 + len, MSG_NOSIGNAL) == (ssize_t)(6 + len)) ? 0 : -1;
+    }
+
+    // Requête découpée: mesure de tcp_quickack et de Nagle côté serveur
+    if (bench.split && len > 1) {
+        if (send(conn->fd, line, len - 1, MSG_NOSIGNAL) != (ssize_t)(len - 1)) {
+            return -1;
+        }
+        line += len - 1;
+        len = 1;
+    }
+    return (send(conn->fd, line, len, MSG_NOSIGNAL) == (ssize_t)len) ? 0 : -1;
+}
+
+/**
+ * @brief Consomme les lignes reçues jusqu'à celle qui contient un motif
+ * @param conn Connexion
+ * @param pattern Motif attendu ("\"type\":\"hint\"", ...)
+ * @return 0 si trouvée, -1 si connexion fermée ou partie gagnée
+ *
+ * Cherche par memmem: en WebSocket, l'en-tête de trame précède le JSON
+ * et peut contenir des octets nuls.
+ */
+static int bench_expect(connection_t *conn, const char *pattern) {
+    size_t pattern_len = strlen(pattern);
+
+    while (1) {
+        char *newline;
+        while ((newline = memchr(conn->buffer, '\n', conn->len))) {
+            size_t line_len = (size_t)(newline - conn->buffer) + 1;
+            int found = memmem(conn->buffer, line_len, pattern, pattern_len) != NULL;
+            int won = memmem(conn->buffer, line_len, "\"victory\"", 9) != NULL;
+            memmove(conn->buffer, newline + 1, conn->len - line_len);
+            conn->len -= line_len;
+            if (found) {
+                return 0;
+            }
+            if (won) {
+                fprintf(stderr, "❌ Connexion %d: tentative gagnante, relancer la mesure\n",
+                        conn->id);
+                return -1;
+            }
+        }
+
+        if (conn->len == sizeof(conn->buffer)) {
+            conn->len = 0; // Ligne plus longue que le buffer: sans intérêt ici
+        }
+        ssize_t n = recv(conn->fd, conn->buffer + conn->len, sizeof(conn->buffer) - conn->len, 0);
+        if (n <= 0) {
+            return -1;
+        }
+        conn->len += (size_t)n;
+    }
+}
+
+/**
+ * @brief Thread d'une connexion: préparation, puis M allers-retours chronométrés
+ * @param arg connection_t
+ * @return NULL (quitte le processus en cas d'erreur)
+ */
+static void *bench_connection(void *arg) {
+    connection_t *conn = arg;
+    double *latencies = bench.latencies + (size_t)conn->id * (size_t)bench.messages;
+    char name[16];
+
+    // Nom en lettres seules (validate_name), distinct par connexion
+    snprintf(name, sizeof(name), "Bench%c%c\n", 'a' + conn->id / 26 % 26, 'a' + conn->id % 26);
+    conn->fd = bench_dial();
+    if (conn->fd < 0 ||
+        bench_expect(conn, "\"type\":\"prompt\"") < 0 ||
+        bench_send(conn, name) < 0 ||
+        bench_expect(conn, "\"type\":\"game_start\"") < 0 ||
+        bench_send(conn, "level hard\n") < 0 ||
+        bench_expect(conn, "\"type\":\"game_start\"") < 0) {
+        fprintf(stderr, "❌ Connexion %d: préparation impossible (serveur, limites?)\n", conn->id);
+        exit(EXIT_FAILURE);
+    }
+
+    pthread_barrier_wait(&bench.start);
+    for (int i = 0; i < bench.messages; i++) {
+        long long sent = now_ns();
+        if (bench_send(conn, "7\n") < 0 || bench_expect(conn, "\"type\":\"hint\"") < 0) {
+            fprintf(stderr, "❌ Connexion %d: perdue après %d tentatives\n", conn->id, i);
+            exit(EXIT_FAILURE);
+        }
+        latencies[i] = (double)(now_ns() - sent) / 1000.0;
+    }
+
+    close(conn->fd);
+    return NULL;
+}
+
+/* ============================================================================
+ * PROGRAMME PRINCIPAL
+ * ============================================================================ */
+
+/**
+ * @brief Sépare "hôte:port" ou "[v6]:port"
+ * @param spec Adresse
+ * @return 0 si valide, -1 sinon
+ */
+static int parse_address(const char *spec) {
+    const char *colon = strrchr(spec, ':');
+    const char *host = spec;
+    size_t host_len = colon ? (size_t)(colon - spec) : 0;
+
+    if (!colon || host_len == 0 || strlen(colon + 1) >= sizeof(bench.port)) {
+        return -1;
+    }
+    if (host[0] == '[' && host[host_len - 1] == ']') {
+        host++;
+        host_len -= 2;
+    }
+    if (host_len >= sizeof(bench.host)) {
+        return -1;
+    }
+    memcpy(bench.host, host, host_len);
+    bench.host[host_len] = '\0';
+    snprintf(bench.port, sizeof(bench.port), "%s", colon + 1);
+    return 0;
+}
+
+/**
+ * @brief Affiche l'aide
+ * @param program Nom du programme
+ */
+static void usage(const char *program) {
+    fprintf(stderr,
+        "Usage: %s [-t hôte:port | -u chemin | -w hôte:port] [-c connexions] [-m tentatives]\n"
+        "          [-p pid] [-n] [-s]\n"
+        "  -t  Port de jeu TCP (défaut: 127.0.0.1:8080)\n"
+        "  -u  Socket Unix de jeu (clé unix_socket)\n"
+        "  -w  WebSocket: ws_port du serveur, ou proxy-server.js (127.0.0.1:8081)\n"
+        "  -c  Connexions simultanées (défaut: 1, %d au plus)\n"
+        "  -m  Tentatives par connexion (défaut: %d)\n"
+        "  -p  Processus dont le CPU est rapporté par message (serveur ou proxy)\n"
+        "  -n  Sans TCP_NODELAY côté banc (Nagle)\n"
+        "  -s  Requête en deux écritures, \"7\" puis \"\\n\" (TCP)\n",
+        program, MAX_CONNECTIONS, DEFAULT_MESSAGES);
+}
+
+/**
+ * @brief Point d'entrée du banc
+ * @return EXIT_SUCCESS ou EXIT_FAILURE
+ */
+int main(int argc, char **argv) {
+    static connection_t connections[MAX_CONNECTIONS];
+    pthread_t threads[MAX_CONNECTIONS];
+    int pid = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:u:w:c:m:p:nsh")) != -1) {
+        switch (opt) {
+            case 't':
+            case 'w':
+                bench.transport = (opt == 't') ? TRANSPORT_TCP : TRANSPORT_WS;
+                if (parse_address(optarg) < 0) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'u': bench.transport = TRANSPORT_UNIX; bench.path = optarg; break;
+            case 'c': bench.connections = atoi(optarg); break;
+            case 'm': bench.messages = atoi(optarg); break;
+            case 'p': pid = atoi(optarg); break;
+            case 'n': bench.nagle = 1; break;
+            case 's': bench.split = 1; break;
+            default: usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    if (optind != argc || bench.connections < 1 || bench.connections > MAX_CONNECTIONS ||
+        bench.messages < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    size_t total = (size_t)bench.connections * (size_t)bench.messages;
+    bench.latencies = malloc(total * sizeof(double));
+    if (!bench.latencies) {
+        perror("❌ Mémoire");
+        return EXIT_FAILURE;
+    }
+    pthread_barrier_init(&bench.start, NULL, (unsigned)bench.connections + 1);
+    for (int i = 0; i < bench.connections; i++) {
+        connections[i].id = i;
+        pthread_create(&threads[i], NULL, bench_connection, &connections[i]);
+    }
+
+    // Mesure: de la dernière connexion prête à la dernière réponse
+    pthread_barrier_wait(&bench.start);
+    double server_before = pid ? process_cpu_us(pid) : 0;
+    double self_before = self_cpu_us();
+    long long started = now_ns();
+    for (int i = 0; i < bench.connections; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    long long elapsed = now_ns() - started;
+    double self_used = self_cpu_us() - self_before;
+    double server_used = pid ? process_cpu_us(pid) - server_before : 0;
+
+    qsort(bench.latencies, total, sizeof(double), compare_latency);
+    static const char *const names[] = {"tcp", "unix", "ws"};
+    printf("%-4s connexions=%d messages=%zu  p50=%.1fµs p99=%.1fµs  débit=%.0f msg/s  "
+           "cpu_banc=%.2fµs/msg",
+           names[bench.transport], bench.connections, total, bench.latencies[total / 2],
+           bench.latencies[total * 99 / 100], (double)total / ((double)elapsed / 1e9),
+           self_used / (double)total);
+    if (pid) {
+        printf(" cpu_pid=%.2fµs/msg", server_used / (double)total);
+    }
+    printf("\n");
+
+    free(bench.latencies);
+    return EXIT_SUCCESS;
+}
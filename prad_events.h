@@ -0,0 +1,123 @@
+/**
+ * ============================================================================
+ * JOURNAL D'ÉVÉNEMENTS DE JEU (AJOUT SEUL, SEGMENTS PROJETABLES)
+ * ============================================================================
+ *
+ * @file prad_events.h
+ * @brief Format des segments du journal écrit par le serveur
+ *
+ * Le serveur (lancé avec PRAD_EVENT_LOG=<répertoire>) ajoute chaque
+ * événement de jeu dans des segments de taille fixe nommés
+ * PRAD_EVENTS_FILE_FORMAT d'après le numéro du premier événement. Chaque
+ * segment contient un en-tête, un index clairsemé (numéro, date) toutes les
+ * PRAD_EVENTS_INDEX_STRIDE entrées, puis des enregistrements de 64 octets.
+ *
+ * Lecture en continu (tail) depuis le numéro N, sans échange avec le serveur:
+ *   1. projeter (mmap, PROT_READ) le segment de base N - N % PRAD_EVENTS_SEGMENT_RECORDS
+ *   2. lire header.committed (acquire): les enregistrements [0, committed)
+ *      sont complets et ne changeront plus
+ *   3. si committed == capacity et sealed != 0, passer au segment suivant
+ *      (base + capacity); sinon réessayer plus tard
+ * Pour partir d'une date, parcourir l'index du segment puis les au plus
+ * PRAD_EVENTS_INDEX_STRIDE enregistrements suivants.
+ *
+ * Les parties en difficulté autre que la première (difficulty != 0) peuvent
+ * dépasser 32 bits: lire alors value64, value étant saturé.
+ * ============================================================================
+ */
+
+#ifndef PRAD_EVENTS_H
+#define PRAD_EVENTS_H
+
+#include <stdint.h>
+
+#define PRAD_EVENTS_MAGIC           0x56455250u  // "PREV" en petit-boutiste
+#define PRAD_EVENTS_VERSION         1            // Incrémentée à chaque changement de format
+#define PRAD_EVENTS_SEGMENT_RECORDS 65536        // Enregistrements par segment (4 Mio)
+#define PRAD_EVENTS_INDEX_STRIDE    1024         // Un point d'index toutes les N entrées
+#define PRAD_EVENTS_INDEX_ENTRIES   (PRAD_EVENTS_SEGMENT_RECORDS / PRAD_EVENTS_INDEX_STRIDE)
+#define PRAD_EVENTS_FILE_FORMAT     "events-%020llu.log"
+#define PRAD_EVENTS_NAME_LENGTH     12           // Nom du joueur (terminé par \0)
+
+/**
+ * @enum prad_event_type_t
+ * @brief Nature d'un événement
+ */
+typedef enum {
+    PRAD_EVENT_CONNECT = 1,              // Connexion acceptée (addr)
+    PRAD_EVENT_NAME = 2,                 // Nom accepté (name)
+    PRAD_EVENT_GAME_START = 3,           // Partie démarrée (value = cible, -1 si partagée)
+    PRAD_EVENT_GUESS = 4,                // Tentative (value = nombre proposé)
+    PRAD_EVENT_VICTORY = 5,              // Victoire (value = nombre trouvé, score)
+    PRAD_EVENT_DISCONNECT = 6            // Fin de session
+} prad_event_type_t;
+
+/**
+ * @enum prad_event_mode_t
+ * @brief Mode de jeu de la session au moment de l'événement
+ */
+typedef enum {
+    PRAD_EVENT_MODE_SOLO = 0,            // Partie individuelle
+    PRAD_EVENT_MODE_RACE = 1,            // Salon, course
+    PRAD_EVENT_MODE_TOURNAMENT = 2       // Salon, tournoi par tours
+} prad_event_mode_t;
+
+/**
+ * @struct prad_event_t
+ * @brief Enregistrement de taille fixe (64 octets)
+ */
+typedef struct {
+    uint64_t seq;                        // Numéro global, croissant et sans trou
+    int64_t time_us;                     // Date (microsecondes Unix)
+    uint32_t client_id;                  // Identifiant de session
+    uint16_t type;                       // prad_event_type_t
+    uint8_t mode;                        // prad_event_mode_t
+    uint8_t difficulty;                  // Index dans PRAD_DIFFICULTIES (prad_scoring.h)
+    int32_t value;                       // Selon le type, saturé sur 32 bits
+    int32_t attempts;                    // Tentatives de la partie
+    int32_t duration;                    // Durée en secondes (victoire)
+    int32_t score;                       // Score (victoire)
+    uint32_t addr;                       // Adresse IPv4 source (ordre réseau), 0 si IPv6
+    char name[PRAD_EVENTS_NAME_LENGTH];  // Nom du joueur (vide avant NAME)
+    int64_t value64;                     // Valeur complète (0 avant les difficultés)
+} prad_event_t;
+
+/**
+ * @struct prad_event_index_t
+ * @brief Point d'index: premier événement d'un bloc de PRAD_EVENTS_INDEX_STRIDE
+ */
+typedef struct {
+    uint64_t seq;                        // Numéro de l'événement
+    int64_t time_us;                     // Sa date
+} prad_event_index_t;
+
+/**
+ * @struct prad_events_header_t
+ * @brief En-tête d'un segment (64 octets)
+ */
+typedef struct {
+    uint32_t magic;                      // PRAD_EVENTS_MAGIC
+    uint32_t version;                    // PRAD_EVENTS_VERSION
+    uint32_t record_size;                // sizeof(prad_event_t)
+    uint32_t capacity;                   // PRAD_EVENTS_SEGMENT_RECORDS
+    uint64_t base_seq;                   // Numéro du premier enregistrement
+    uint64_t committed;                  // Enregistrements complets (publié en release)
+    uint32_t sealed;                     // 1 = segment plein, le suivant existe
+    uint32_t index_stride;               // PRAD_EVENTS_INDEX_STRIDE
+    uint8_t reserved[24];                // Extensions futures (zéro)
+} prad_events_header_t;
+
+/**
+ * @struct prad_events_segment_t
+ * @brief Contenu complet d'un fichier segment
+ */
+typedef struct {
+    prad_events_header_t header;
+    prad_event_index_t index[PRAD_EVENTS_INDEX_ENTRIES];
+    prad_event_t records[PRAD_EVENTS_SEGMENT_RECORDS];
+} prad_events_segment_t;
+
+_Static_assert(sizeof(prad_event_t) == 64, "prad_event_t doit faire 64 octets");
+_Static_assert(sizeof(prad_events_header_t) == 64, "en-tête de segment de 64 octets");
+
+#endif // PRAD_EVENTS_H
@@ -0,0 +1,509 @@
+/**
+ * ============================================================================
+ * RECALCUL PARALLÈLE DU LEADERBOARD DEPUIS LE JOURNAL D'ÉVÉNEMENTS
+ * ============================================================================
+ *
+ * @file prad_rebuild.c
+ * @brief Outil hors ligne: rejoue toutes les victoires du journal avec la
+ *        politique de score de leur mode (prad_scoring.h) et produit un
+ *        instantané chargeable à chaud par le serveur ("swap <fichier>" sur
+ *        son socket d'administration, clé admin_socket)
+ *
+ * ALGORITHME:
+ * ----------
+ * Les segments du journal sont distribués dynamiquement aux threads (un
+ * compteur atomique); chaque thread parcourt ses segments projetés en
+ * mémoire, recalcule les scores et garde son propre top-K par mode de jeu
+ * et par difficulté dans un tas minimum. Les top-K partiels sont ensuite fusionnés et triés: le coût est
+ * linéaire dans le nombre de parties, sans tri global.
+ *
+ * COMPILATION:
+ * -----------
+ * gcc -o prad_rebuild prad_rebuild.c -pthread -Wall -Wextra -O2
+ *
+ * EXÉCUTION:
+ * ---------
+ * ./prad_rebuild [-j threads] [-s solo=classic,race=time,...] <journal> <sortie>
+ *
+ * Les politiques doivent être celles du serveur (PRAD_SCORING) au moment
+ * du remplacement; le serveur refuse l'instantané sinon.
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "prad_events.h"
+#include "prad_rebuild.h"
+
+/* ============================================================================
+ * CONSTANTES DE CONFIGURATION
+ * ============================================================================ */
+#define TOP_K                   PRAD_SHM_MAX_SCORES // Taille du classement
+#define MAX_THREADS             256         // Threads de recalcul au plus
+
+/* ============================================================================
+ * STRUCTURES DE DONNÉES
+ * ============================================================================ */
+
+/**
+ * @struct ranked_t
+ * @brief Victoire recalculée candidate au classement
+ */
+typedef struct {
+    prad_event_t event;                  // Événement d'origine
+    int32_t score;                       // Score recalculé
+} ranked_t;
+
+/**
+ * @struct partition_t
+ * @brief Résultat partiel d'un thread
+ */
+typedef struct {
+    ranked_t top[PRAD_SCORING_MODES][PRAD_DIFFICULTY_LEVELS][TOP_K]; // Tas minimum par
+                                         // mode et difficulté (racine = plus faible)
+    int count[PRAD_SCORING_MODES][PRAD_DIFFICULTY_LEVELS]; // Entrées de chaque tas
+    uint64_t games;                      // Victoires rejouées
+    uint64_t total_attempts;             // Somme des tentatives
+    uint64_t scanned;                    // Événements lus
+    uint64_t last_seq;                   // Plus grand numéro lu (+1)
+    int32_t best_attempts;               // Meilleur nombre de tentatives
+} partition_t;
+
+/**
+ * @struct rebuild_t
+ * @brief Travail partagé entre les threads
+ */
+typedef struct {
+    const char *dir;                     // Répertoire du journal
+    unsigned long long *bases;           // Segments à traiter (numéros de base)
+    int segment_count;                   // Nombre de segments
+    int next_segment;                    // Prochain segment à prendre (atomique)
+    prad_scoring_formula_t formulas[PRAD_SCORING_MODES]; // Politique de chaque mode
+} rebuild_t;
+
+/**
+ * @struct worker_t
+ * @brief Paramètres d'un thread de recalcul
+ */
+typedef struct {
+    rebuild_t *job;                      // Travail partagé
+    partition_t result;                  // Résultat partiel
+} worker_t;
+
+/* ============================================================================
+ * POLITIQUES DE SCORE (MÊMES LIGNES QUE LE SERVEUR)
+ * ============================================================================ */
+
+#define POLICY_NAME(id, initial, per_attempt, per_second, scaled) #id,
+static const char *const policy_names[] = { PRAD_SCORING_POLICIES(POLICY_NAME) };
+#undef POLICY_NAME
+
+#define POLICY_FORMULA(id, initial, per_attempt, per_second, scaled) \
+    {initial, per_attempt, per_second, scaled},
+static const prad_scoring_formula_t policy_formulas[] = { PRAD_SCORING_POLICIES(POLICY_FORMULA) };
+#undef POLICY_FORMULA
+
+#define POLICY_COUNT (int)(sizeof(policy_names) / sizeof(policy_names[0]))
+
+/* ============================================================================
+ * CLASSEMENT (TOP-K)
+ * ============================================================================ */
+
+/**
+ * @brief Ordre du classement: score décroissant, puis partie la plus ancienne
+ * @return 1 si a est classé avant b
+ */
+static int ranks_before(const ranked_t *a, const ranked_t *b) {
+    if (a->score != b->score) {
+        return a->score > b->score;
+    }
+    return a->event.seq < b->event.seq;
+}
+
+/**
+ * @brief Propose une victoire au top-K d'un mode (tas minimum)
+ * @param heap Tas du mode
+ * @param count Entrées du tas
+ * @param candidate Victoire recalculée
+ */
+static void top_offer(ranked_t *heap, int *count, const ranked_t *candidate) {
+    int i;
+
+    if (*count < TOP_K) {
+        // Insertion puis remontée
+        i = (*count)++;
+        heap[i] = *candidate;
+        while (i > 0 && ranks_before(&heap[(i - 1) / 2], &heap[i])) {
+            ranked_t swap = heap[i];
+            heap[i] = heap[(i - 1) / 2];
+            heap[(i - 1) / 2] = swap;
+            i = (i - 1) / 2;
+        }
+        return;
+    }
+
+    if (!ranks_before(candidate, &heap[0])) {
+        return;
+    }
+
+    // Remplacement de la racine puis descente
+    heap[0] = *candidate;
+    i = 0;
+    for (;;) {
+        int weakest = i;
+        int left = 2 * i + 1, right = 2 * i + 2;
+        if (left < TOP_K && ranks_before(&heap[weakest], &heap[left])) {
+            weakest = left;
+        }
+        if (right < TOP_K && ranks_before(&heap[weakest], &heap[right])) {
+            weakest = right;
+        }
+        if (weakest == i) {
+            break;
+        }
+        ranked_t swap = heap[i];
+        heap[i] = heap[weakest];
+        heap[weakest] = swap;
+        i = weakest;
+    }
+}
+
+/**
+ * @brief Comparateur qsort: ordre du classement
+ */
+static int compare_ranked(const void *a, const void *b) {
+    return ranks_before(a, b) ? -1 : ranks_before(b, a) ? 1 : 0;
+}
+
+/* ============================================================================
+ * PARCOURS DU JOURNAL
+ * ============================================================================ */
+
+/**
+ * @brief Recalcule un segment du journal dans une partition
+ * @param job Travail partagé
+ * @param base Numéro de base du segment
+ * @param part Partition du thread
+ * @return 0 si succès, -1 si segment illisible
+ */
+static int scan_segment(const rebuild_t *job, unsigned long long base, partition_t *part) {
+    char path[512];
+    char file[64];
+
+    snprintf(file, sizeof(file), PRAD_EVENTS_FILE_FORMAT, base);
+    snprintf(path, sizeof(path), "%s/%s", job->dir, file);
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return -1;
+    }
+    void *map = mmap(NULL, sizeof(prad_events_segment_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    const prad_events_segment_t *segment = map;
+    if (segment->header.magic != PRAD_EVENTS_MAGIC ||
+        segment->header.version != PRAD_EVENTS_VERSION ||
+        segment->header.base_seq != base) {
+        munmap(map, sizeof(prad_events_segment_t));
+        return -1;
+    }
+
+    uint64_t committed = __atomic_load_n(&segment->header.committed, __ATOMIC_ACQUIRE);
+    madvise(map, sizeof(prad_events_segment_t), MADV_SEQUENTIAL);
+
+    for (uint64_t i = 0; i < committed; i++) {
+        const prad_event_t *event = &segment->records[i];
+        if (event->type != PRAD_EVENT_VICTORY || event->mode >= PRAD_SCORING_MODES ||
+            event->difficulty >= PRAD_DIFFICULTY_LEVELS) {
+            continue;
+        }
+
+        const prad_scoring_formula_t *formula = &job->formulas[event->mode];
+        ranked_t candidate;
+        candidate.event = *event;
+        candidate.score = prad_score_formula(event->attempts, event->duration,
+                                             prad_difficulty_bits(event->difficulty),
+                                             formula->initial, formula->per_attempt,
+                                             formula->per_second, formula->scaled);
+
+        part->games++;
+        part->total_attempts += (uint64_t)event->attempts;
+        if (event->attempts < part->best_attempts) {
+            part->best_attempts = event->attempts;
+        }
+        top_offer(part->top[event->mode][event->difficulty],
+                  &part->count[event->mode][event->difficulty], &candidate);
+    }
+
+    part->scanned += committed;
+    if (committed > 0 && base + committed > part->last_seq) {
+        part->last_seq = base + committed;
+    }
+
+    munmap(map, sizeof(prad_events_segment_t));
+    return 0;
+}
+
+/**
+ * @brief Thread de recalcul: prend des segments jusqu'à épuisement
+ * @param arg worker_t
+ * @return NULL
+ */
+static void *rebuild_worker(void *arg) {
+    worker_t *worker = arg;
+    rebuild_t *job = worker->job;
+
+    for (;;) {
+        int index = __atomic_fetch_add(&job->next_segment, 1, __ATOMIC_RELAXED);
+        if (index >= job->segment_count) {
+            break;
+        }
+        if (scan_segment(job, job->bases[index], &worker->result) < 0) {
+            fprintf(stderr, "⚠️  Segment %llu illisible, ignoré\n", job->bases[index]);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Liste les segments du journal
+ * @param dir Répertoire
+ * @param count Nombre de segments trouvés
+ * @return Tableau des numéros de base (à libérer), NULL si erreur
+ */
+static unsigned long long *list_segments(const char *dir, int *count) {
+    DIR *listing = opendir(dir);
+    if (!listing) {
+        return NULL;
+    }
+
+    int capacity = 64;
+    unsigned long long *bases = malloc(capacity * sizeof(*bases));
+    struct dirent *entry;
+    *count = 0;
+
+    while (bases && (entry = readdir(listing)) != NULL) {
+        unsigned long long base;
+        char tail;
+        if (sscanf(entry->d_name, "events-%20llu.lo%c", &base, &tail) != 2 || tail != 'g') {
+            continue;
+        }
+        if (*count == capacity) {
+            capacity *= 2;
+            unsigned long long *grown = realloc(bases, capacity * sizeof(*bases));
+            if (!grown) {
+                free(bases);
+                bases = NULL;
+                break;
+            }
+            bases = grown;
+        }
+        bases[(*count)++] = base;
+    }
+
+    closedir(listing);
+    return bases;
+}
+
+/* ============================================================================
+ * PROGRAMME PRINCIPAL
+ * ============================================================================ */
+
+/**
+ * @brief Affiche l'aide
+ * @param program Nom du programme
+ */
+static void usage(const char *program) {
+    fprintf(stderr,
+        "Usage: %s [-j threads] [-s mode=politique,...] <journal> <sortie>\n"
+        "  -j  Threads de recalcul (défaut: nombre de cœurs)\n"
+        "  -s  Politique par mode (défaut: %s)\n"
+        "      Modes: solo, race, tournament. Politiques:",
+        program, PRAD_SCORING_DEFAULT);
+    for (int p = 0; p < POLICY_COUNT; p++) {
+        fprintf(stderr, " %s", policy_names[p]);
+    }
+    fprintf(stderr, "\n");
+}
+
+/**
+ * @brief Point d'entrée de l'outil de recalcul
+ * @return EXIT_SUCCESS ou EXIT_FAILURE
+ */
+int main(int argc, char **argv) {
+    rebuild_t job;
+    int policies[PRAD_SCORING_MODES] = {0};
+    long threads = sysconf(_SC_NPROCESSORS_ONLN);
+    int opt;
+
+    memset(&job, 0, sizeof(job));
+    prad_scoring_parse(PRAD_SCORING_DEFAULT, policy_names, POLICY_COUNT, policies);
+
+    while ((opt = getopt(argc, argv, "j:s:h")) != -1) {
+        switch (opt) {
+            case 'j': threads = strtol(optarg, NULL, 10); break;
+            case 's':
+                if (prad_scoring_parse(optarg, policy_names, POLICY_COUNT, policies) < 0) {
+                    usage(argv[0]);
+                    return EXIT_FAILURE;
+                }
+                break;
+            default: usage(argv[0]); return EXIT_FAILURE;
+        }
+    }
+    for (int mode = 0; mode < PRAD_SCORING_MODES; mode++) {
+        job.formulas[mode] = policy_formulas[policies[mode]];
+    }
+    if (argc - optind != 2 || threads < 1) {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (threads > MAX_THREADS) {
+        threads = MAX_THREADS;
+    }
+
+    job.dir = argv[optind];
+    const char *output = argv[optind + 1];
+
+    job.bases = list_segments(job.dir, &job.segment_count);
+    if (!job.bases) {
+        perror("❌ Lecture du journal");
+        return EXIT_FAILURE;
+    }
+    if (threads > job.segment_count && job.segment_count > 0) {
+        threads = job.segment_count;
+    }
+
+    struct timespec started, finished;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+
+    // Recalcul partitionné
+    worker_t *workers = calloc((size_t)threads, sizeof(worker_t));
+    pthread_t *ids = calloc((size_t)threads, sizeof(pthread_t));
+    if (!workers || !ids) {
+        perror("❌ Allocation");
+        return EXIT_FAILURE;
+    }
+    for (long t = 0; t < threads; t++) {
+        workers[t].job = &job;
+        workers[t].result.best_attempts = INT32_MAX;
+        if (pthread_create(&ids[t], NULL, rebuild_worker, &workers[t]) != 0) {
+            perror("❌ Création d'un thread");
+            return EXIT_FAILURE;
+        }
+    }
+
+    // Fusion des top-K partiels, classement par classement
+    static ranked_t merged[PRAD_SCORING_MODES][PRAD_DIFFICULTY_LEVELS][MAX_THREADS * TOP_K];
+    int merged_count[PRAD_SCORING_MODES][PRAD_DIFFICULTY_LEVELS] = {{0}};
+    partition_t total = {.best_attempts = INT32_MAX};
+
+    for (long t = 0; t < threads; t++) {
+        pthread_join(ids[t], NULL);
+        partition_t *part = &workers[t].result;
+
+        for (int mode = 0; mode < PRAD_SCORING_MODES; mode++) {
+            for (int level = 0; level < PRAD_DIFFICULTY_LEVELS; level++) {
+                memcpy(&merged[mode][level][merged_count[mode][level]], part->top[mode][level],
+                       part->count[mode][level] * sizeof(ranked_t));
+                merged_count[mode][level] += part->count[mode][level];
+            }
+        }
+        total.games += part->games;
+        total.total_attempts += part->total_attempts;
+        total.scanned += part->scanned;
+        if (part->best_attempts < total.best_attempts) {
+            total.best_attempts = part->best_attempts;
+        }
+        if (part->last_seq > total.last_seq) {
+            total.last_seq = part->last_seq;
+        }
+    }
+
+    // Instantané
+    prad_board_file_t board;
+    memset(&board, 0, sizeof(board));
+    board.magic = PRAD_BOARD_FILE_MAGIC;
+    board.version = PRAD_BOARD_FILE_VERSION;
+    memcpy(board.formulas, job.formulas, sizeof(board.formulas));
+    board.games = total.games;
+    board.total_attempts = total.total_attempts;
+    board.last_seq = total.last_seq;
+    board.best_attempts = (total.games > 0) ? total.best_attempts : 0;
+    board.mode_count = PRAD_SCORING_MODES;
+    board.level_count = PRAD_DIFFICULTY_LEVELS;
+
+    for (int mode = 0; mode < PRAD_SCORING_MODES; mode++) {
+        for (int level = 0; level < PRAD_DIFFICULTY_LEVELS; level++) {
+            prad_shm_ranking_t *ranking = &board.boards[mode][level];
+            ranked_t *ranked = merged[mode][level];
+            int count = merged_count[mode][level];
+
+            qsort(ranked, count, sizeof(ranked_t), compare_ranked);
+            ranking->count = (count < TOP_K) ? count : TOP_K;
+            for (int i = 0; i < ranking->count; i++) {
+                prad_shm_score_t *entry = &ranking->scores[i];
+                memcpy(entry->name, ranked[i].event.name, sizeof(ranked[i].event.name));
+                entry->name[PRAD_SHM_NAME_LENGTH] = '\0';
+                entry->score = ranked[i].score;
+                entry->attempts = ranked[i].event.attempts;
+                entry->duration = ranked[i].event.duration;
+                entry->timestamp = ranked[i].event.time_us / 1000000;
+            }
+        }
+    }
+
+    // Écriture atomique (fichier temporaire puis renommage)
+    char temporary[512];
+    snprintf(temporary, sizeof(temporary), "%s.tmp", output);
+    FILE *file = fopen(temporary, "wb");
+    if (!file || fwrite(&board, sizeof(board), 1, file) != 1 || fclose(file) != 0 ||
+        rename(temporary, output) < 0) {
+        perror("❌ Écriture de l'instantané");
+        return EXIT_FAILURE;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    double seconds = (finished.tv_sec - started.tv_sec) +
+                     (finished.tv_nsec - started.tv_nsec) / 1e9;
+
+    printf("✅ %d segments, %llu événements, %llu victoires en %.2fs (%ld threads, %.1f M évts/s)\n",
+           job.segment_count, (unsigned long long)total.scanned,
+           (unsigned long long)total.games, seconds, threads,
+           seconds > 0 ? total.scanned / seconds / 1e6 : 0.0);
+    for (int mode = 0; mode < PRAD_SCORING_MODES; mode++) {
+        for (int level = 0; level < PRAD_DIFFICULTY_LEVELS; level++) {
+            const prad_shm_ranking_t *ranking = &board.boards[mode][level];
+            if (ranking->count == 0) {
+                continue;
+            }
+            printf("🏆 %s %s (%s)\n", prad_mode_name(mode), prad_difficulty_name(level),
+                   policy_names[policies[mode]]);
+            for (int i = 0; i < ranking->count; i++) {
+                printf("  %2d. %-10s %6d pts  (%d essais, %ds)\n", i + 1,
+                       ranking->scores[i].name, ranking->scores[i].score,
+                       ranking->scores[i].attempts, ranking->scores[i].duration);
+            }
+        }
+    }
+    printf("📦 Instantané écrit: %s (swap %s sur le socket admin_socket)\n", output, output);
+
+    free(job.bases);
+    free(workers);
+    free(ids);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,50 @@
+/**
+ * ============================================================================
+ * INSTANTANÉ DE LEADERBOARD RECALCULÉ HORS LIGNE
+ * ============================================================================
+ *
+ * @file prad_rebuild.h
+ * @brief Format du fichier produit par prad_rebuild et chargé à chaud par
+ *        la commande "swap <fichier>" du socket d'administration du serveur
+ *
+ * Après un changement de formule de score, prad_rebuild relit tout le
+ * journal d'événements (prad_events.h), recalcule chaque victoire avec la
+ * politique de son mode (prad_scoring.h) et écrit les nouveaux classements
+ * (un par mode et par difficulté) et les statistiques de parties dans ce
+ * format. Le serveur refuse un fichier dont une politique diffère de la
+ * sienne pour le même mode.
+ * ============================================================================
+ */
+
+#ifndef PRAD_REBUILD_H
+#define PRAD_REBUILD_H
+
+#include <stdint.h>
+
+#include "prad_shm.h"
+#include "prad_scoring.h"
+
+#define PRAD_BOARD_FILE_MAGIC   0x44425250u  // "PRBD" en petit-boutiste
+#define PRAD_BOARD_FILE_VERSION 3            // Incrémentée à chaque changement de format
+
+/**
+ * @struct prad_board_file_t
+ * @brief Contenu du fichier instantané
+ */
+typedef struct {
+    uint32_t magic;                      // PRAD_BOARD_FILE_MAGIC
+    uint32_t version;                    // PRAD_BOARD_FILE_VERSION
+    prad_scoring_formula_t formulas[PRAD_SCORING_MODES]; // Politique appliquée, par mode
+    uint64_t games;                      // Parties gagnées rejouées
+    uint64_t total_attempts;             // Somme des tentatives
+    uint64_t last_seq;                   // Dernier événement lu (+1), 0 si aucun
+    int32_t best_attempts;               // Meilleur nombre de tentatives (0 = aucun)
+    int32_t mode_count;                  // PRAD_SCORING_MODES
+    int32_t level_count;                 // PRAD_DIFFICULTY_LEVELS
+    prad_shm_ranking_t boards[PRAD_SCORING_MODES][PRAD_DIFFICULTY_LEVELS]; // Classements
+} prad_board_file_t;
+
+_Static_assert(PRAD_SCORING_MODES == PRAD_SHM_MODES, "prad_shm.h doit suivre les modes");
+_Static_assert(PRAD_DIFFICULTY_LEVELS == PRAD_SHM_LEVELS, "prad_shm.h doit suivre les difficultés");
+
+#endif // PRAD_REBUILD_H
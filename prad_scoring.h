@@ -0,0 +1,184 @@
+/**
+ * ============================================================================
+ * POLITIQUES DE SCORE (SPÉCIALISÉES À LA COMPILATION) ET DIFFICULTÉS
+ * ============================================================================
+ *
+ * @file prad_scoring.h
+ * @brief Formules de score et plages de jeu partagées par le serveur et
+ *        prad_rebuild
+ *
+ * Chaque politique est une ligne de PRAD_SCORING_POLICIES: le serveur en
+ * génère une fonction par politique dont les constantes sont repliées par
+ * le compilateur (aucun test de configuration par appel). La politique de
+ * chaque mode de jeu est choisie au démarrage ("solo=classic,race=time,...")
+ * et résolue une fois par salon.
+ *
+ * Formule commune, bornée à 0:
+ *   score = initial - tentatives × pénalité - durée × poids_temps
+ * Pour les politiques "scaled", la pénalité est ramenée à la taille de la
+ * plage: pénalité × PRAD_SCORING_REFERENCE_BITS / ceil(log2(plage)).
+ *
+ * Chaque niveau de difficulté de PRAD_DIFFICULTIES fixe la plage d'une
+ * partie (jusqu'à 64 bits) et a son propre leaderboard dans chaque mode.
+ * ============================================================================
+ */
+
+#ifndef PRAD_SCORING_H
+#define PRAD_SCORING_H
+
+#include <stdint.h>
+#include <string.h>
+
+#define PRAD_SCORING_MODES          3       // Solo, course, tournoi (prad_event_mode_t)
+#define PRAD_SCORING_REFERENCE_BITS 7       // ceil(log2(101)): plage 0-100
+#define PRAD_SCORING_DEFAULT        "solo=classic,race=time,tournament=attempts"
+#define PRAD_DIFFICULTY_LEVELS      4       // Lignes de PRAD_DIFFICULTIES
+
+/**
+ * Niveaux de difficulté: X(nom, minimum, maximum), le premier par défaut
+ */
+#define PRAD_DIFFICULTIES(X)              \
+    X(easy,    0, 100)                    \
+    X(medium,  0, 10000)                  \
+    X(hard,    0, 1000000000)             \
+    X(extreme, 0, INT64_MAX)
+
+/**
+ * Liste des politiques: X(nom, initial, pénalité/tentative, poids/seconde, plage)
+ *   classic  : formule historique 10000 - tentatives × 100 - temps
+ *   time     : pondérée par le temps (courses)
+ *   attempts : tentatives seules (tournois: la durée dépend des tours)
+ *   scaled   : pénalité ramenée à la difficulté (plages larges)
+ */
+#define PRAD_SCORING_POLICIES(X)          \
+    X(classic,  10000, 100,  1, 0)        \
+    X(time,     10000,  50, 10, 0)        \
+    X(attempts, 10000, 100,  0, 0)        \
+    X(scaled,   10000, 100,  1, 1)
+
+/**
+ * @struct prad_scoring_formula_t
+ * @brief Paramètres d'une politique (enregistrés dans les instantanés)
+ */
+typedef struct {
+    int32_t initial;                     // Score de départ
+    int32_t per_attempt;                 // Pénalité par tentative
+    int32_t per_second;                  // Pénalité par seconde
+    int32_t scaled;                      // 1 = pénalité ramenée à la plage
+} prad_scoring_formula_t;
+
+/**
+ * Bits d'une plage: ceil(log2(max - min + 1)), au moins 1, soit le nombre de
+ * tentatives d'une recherche dichotomique parfaite. Calculé sur max - min
+ * (non signé) pour ne jamais déborder; constant si les bornes le sont.
+ */
+#define PRAD_RANGE_BITS(min, max) \
+    (64 - __builtin_clzll(((uint64_t)(max) - (uint64_t)(min)) | 1))
+
+/**
+ * @brief Formule commune, instanciée avec des constantes par politique
+ * @param attempts Nombre de tentatives
+ * @param duration Durée en secondes
+ * @param bits Bits de la plage de la partie (PRAD_RANGE_BITS)
+ * @param initial Score de départ
+ * @param per_attempt Pénalité par tentative
+ * @param per_second Pénalité par seconde
+ * @param scaled 1 = pénalité ramenée à la plage
+ * @return Score (0 au minimum)
+ */
+static inline int prad_score_formula(int attempts, int duration, int bits, int initial,
+                                     int per_attempt, int per_second, int scaled) {
+    int64_t penalty = per_attempt;
+    if (scaled) {
+        penalty = penalty * PRAD_SCORING_REFERENCE_BITS / bits;
+    }
+    int64_t score = (int64_t)initial - (int64_t)attempts * penalty
+                  - (int64_t)duration * per_second;
+    return (score > 0) ? (int)score : 0;
+}
+
+/**
+ * @brief Nom d'un mode de jeu (prad_event_mode_t)
+ * @param mode Mode
+ * @return "solo", "race" ou "tournament"
+ */
+static inline const char *prad_mode_name(int mode) {
+    static const char *const names[PRAD_SCORING_MODES] = {"solo", "race", "tournament"};
+    return (mode >= 0 && mode < PRAD_SCORING_MODES) ? names[mode] : "?";
+}
+
+/**
+ * @brief Nom d'un niveau de difficulté
+ * @param level Index dans PRAD_DIFFICULTIES
+ * @return "easy", "medium", ...
+ */
+static inline const char *prad_difficulty_name(int level) {
+#define PRAD_DIFFICULTY_NAME(id, min, max) #id,
+    static const char *const names[PRAD_DIFFICULTY_LEVELS] = {
+        PRAD_DIFFICULTIES(PRAD_DIFFICULTY_NAME)
+    };
+#undef PRAD_DIFFICULTY_NAME
+    return (level >= 0 && level < PRAD_DIFFICULTY_LEVELS) ? names[level] : "?";
+}
+
+/**
+ * @brief Bits de la plage d'un niveau de difficulté
+ * @param level Index dans PRAD_DIFFICULTIES
+ * @return PRAD_RANGE_BITS du niveau (niveau par défaut si inconnu)
+ */
+static inline int prad_difficulty_bits(int level) {
+#define PRAD_DIFFICULTY_BITS(id, min, max) PRAD_RANGE_BITS(min, max),
+    static const int bits[PRAD_DIFFICULTY_LEVELS] = { PRAD_DIFFICULTIES(PRAD_DIFFICULTY_BITS) };
+#undef PRAD_DIFFICULTY_BITS
+    return bits[(level >= 0 && level < PRAD_DIFFICULTY_LEVELS) ? level : 0];
+}
+
+/**
+ * @brief Lit une affectation "mode=politique,..." (modes absents inchangés)
+ * @param spec Chaîne de configuration
+ * @param names Noms des politiques connues
+ * @param count Nombre de politiques connues
+ * @param policies Index de politique par mode (entrée: défauts)
+ * @return 0 si valide, -1 sinon (policies inchangé)
+ */
+static inline int prad_scoring_parse(const char *spec, const char *const *names, int count,
+                                     int policies[PRAD_SCORING_MODES]) {
+    int parsed[PRAD_SCORING_MODES];
+    memcpy(parsed, policies, sizeof(parsed));
+
+    while (*spec) {
+        const char *equal = strchr(spec, '=');
+        if (!equal) {
+            return -1;
+        }
+        const char *value = equal + 1;
+        size_t value_len = strcspn(value, ",");
+
+        int mode = -1, policy = -1;
+        for (int m = 0; m < PRAD_SCORING_MODES; m++) {
+            if (strlen(prad_mode_name(m)) == (size_t)(equal - spec) &&
+                strncmp(spec, prad_mode_name(m), (size_t)(equal - spec)) == 0) {
+                mode = m;
+            }
+        }
+        for (int p = 0; p < count; p++) {
+            if (strlen(names[p]) == value_len && strncmp(value, names[p], value_len) == 0) {
+                policy = p;
+            }
+        }
+        if (mode < 0 || policy < 0) {
+            return -1;
+        }
+        parsed[mode] = policy;
+
+        spec = value + value_len;
+        if (*spec == ',') {
+            spec++;
+        }
+    }
+
+    memcpy(policies, parsed, sizeof(parsed));
+    return 0;
+}
+
+#endif // PRAD_SCORING_H
@@ -0,0 +1,97 @@
+/**
+ * ============================================================================
+ * BIBLIOTHÈQUE DE LECTURE DU SEGMENT PARTAGÉ DU SERVEUR
+ * ============================================================================
+ *
+ * @file prad_shm.c
+ * @brief Lecteur seqlock du leaderboard et des statistiques (voir prad_shm.h)
+ * ============================================================================
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "prad_shm.h"
+
+/**
+ * @brief Ouvre et projette le segment en lecture seule
+ * @param reader Lecteur à initialiser
+ * @return 0 si succès, -1 sinon (errno positionné)
+ */
+int prad_shm_open(prad_shm_reader_t *reader) {
+    reader->board = NULL;
+
+    int fd = shm_open(PRAD_SHM_NAME, O_RDONLY, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || (size_t)info.st_size < sizeof(prad_shm_board_t)) {
+        close(fd);
+        errno = EPROTO;
+        return -1;
+    }
+
+    void *map = mmap(NULL, sizeof(prad_shm_board_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return -1;
+    }
+
+    reader->board = map;
+    return 0;
+}
+
+/**
+ * @brief Copie un état cohérent du segment
+ * @param reader Lecteur ouvert
+ * @param out Copie cohérente
+ * @return 0 si succès, -1 si format inconnu ou écrivain bloqué en cours d'écriture
+ *
+ * La copie est recommencée tant que le compteur de séquence est impair ou
+ * a changé pendant la copie.
+ */
+int prad_shm_read(const prad_shm_reader_t *reader, prad_shm_board_t *out) {
+    const prad_shm_board_t *board = reader->board;
+
+    if (!board || board->magic != PRAD_SHM_MAGIC || board->version != PRAD_SHM_VERSION) {
+        errno = EPROTO;
+        return -1;
+    }
+
+    for (int tries = 0; tries < PRAD_SHM_READ_TRIES; tries++) {
+        uint32_t before = __atomic_load_n(&board->sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            sched_yield();
+            continue;
+        }
+
+        memcpy(out, board, sizeof(*out));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+        if (__atomic_load_n(&board->sequence, __ATOMIC_RELAXED) == before) {
+            out->sequence = before;
+            return 0;
+        }
+    }
+
+    errno = EAGAIN;
+    return -1;
+}
+
+/**
+ * @brief Libère la projection du segment
+ * @param reader Lecteur ouvert
+ */
+void prad_shm_close(prad_shm_reader_t *reader) {
+    if (reader->board) {
+        munmap((void *)reader->board, sizeof(prad_shm_board_t));
+        reader->board = NULL;
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * ============================================================================
+ * EXPORT EN MÉMOIRE PARTAGÉE DU LEADERBOARD ET DES STATISTIQUES
+ * ============================================================================
+ *
+ * @file prad_shm.h
+ * @brief Format du segment POSIX publié par le serveur et API de lecture
+ *
+ * Le serveur (seul écrivain) publie le leaderboard et les statistiques dans
+ * le segment PRAD_SHM_NAME, protégé par un seqlock: le compteur `sequence`
+ * est impair pendant une écriture. Les lecteurs copient le segment et
+ * recommencent si le compteur a changé entre-temps; ils ne coûtent rien au
+ * serveur et peuvent interroger à n'importe quelle fréquence.
+ *
+ * Utilisation côté lecteur:
+ *   gcc -o kiosk kiosk.c prad_shm.c      (ajouter -lrt sur glibc < 2.34)
+ *
+ *   prad_shm_reader_t reader;
+ *   prad_shm_board_t board;
+ *   if (prad_shm_open(&reader) == 0 && prad_shm_read(&reader, &board) == 0) {
+ *       printf("%d parties, %d scores solo\n", board.total_games, board.boards[0][0].count);
+ *   }
+ *   prad_shm_close(&reader);
+ * ============================================================================
+ */
+
+#ifndef PRAD_SHM_H
+#define PRAD_SHM_H
+
+#include <stdint.h>
+
+#define PRAD_SHM_NAME        "/prad_board"   // Nom du segment POSIX
+#define PRAD_SHM_MAGIC       0x44415250u     // "PRAD" en petit-boutiste
+#define PRAD_SHM_VERSION     3               // Incrémentée à chaque changement de format
+#define PRAD_SHM_MAX_SCORES  10              // Égal à TOP_SCORES du serveur
+#define PRAD_SHM_MODES       3               // Leaderboards: solo, course, tournoi
+#define PRAD_SHM_LEVELS      4               // ... et par difficulté (prad_scoring.h)
+#define PRAD_SHM_NAME_LENGTH 11              // Égal à MAX_NAME_LENGTH du serveur
+#define PRAD_SHM_READ_TRIES  1000            // Tentatives avant abandon d'une lecture
+
+/**
+ * @struct prad_shm_score_t
+ * @brief Entrée du leaderboard exportée
+ */
+typedef struct {
+    char name[PRAD_SHM_NAME_LENGTH + 1]; // Nom du joueur (terminé par \0)
+    int32_t score;                       // Score calculé
+    int32_t attempts;                    // Nombre de tentatives
+    int32_t duration;                    // Durée en secondes
+    int64_t timestamp;                   // Fin de la partie (secondes Unix)
+} prad_shm_score_t;
+
+/**
+ * @struct prad_shm_ranking_t
+ * @brief Leaderboard d'un mode de jeu et d'une difficulté
+ */
+typedef struct {
+    int32_t count;                       // Entrées valides dans scores
+    prad_shm_score_t scores[PRAD_SHM_MAX_SCORES]; // Classement, score décroissant
+} prad_shm_ranking_t;
+
+/**
+ * @struct prad_shm_board_t
+ * @brief Contenu du segment partagé
+ */
+typedef struct {
+    uint32_t magic;                      // PRAD_SHM_MAGIC
+    uint32_t version;                    // PRAD_SHM_VERSION
+    uint32_t sequence;                   // Seqlock: impair = écriture en cours
+    uint32_t server_pid;                 // Processus écrivain
+    int64_t server_start;                // Démarrage du serveur (secondes Unix)
+    int64_t updated;                     // Dernière publication (secondes Unix)
+    int32_t active_clients;              // Clients connectés
+    int32_t total_served;                // Total clients servis
+    int32_t total_games;                 // Parties terminées
+    int32_t best_attempts;               // Meilleur nombre de tentatives (0 = aucun)
+    float avg_attempts;                  // Moyenne de tentatives
+    int32_t mode_count;                  // PRAD_SHM_MODES
+    int32_t level_count;                 // PRAD_SHM_LEVELS
+    prad_shm_ranking_t boards[PRAD_SHM_MODES][PRAD_SHM_LEVELS]; // Leaderboards triés
+} prad_shm_board_t;
+
+/**
+ * @struct prad_shm_reader_t
+ * @brief Projection en lecture seule du segment
+ */
+typedef struct {
+    const prad_shm_board_t *board;       // Segment projeté (NULL = fermé)
+} prad_shm_reader_t;
+
+/**
+ * @brief Ouvre et projette le segment en lecture seule
+ * @param reader Lecteur à initialiser
+ * @return 0 si succès, -1 sinon (errno positionné)
+ */
+int prad_shm_open(prad_shm_reader_t *reader);
+
+/**
+ * @brief Copie un état cohérent du segment
+ * @param reader Lecteur ouvert
+ * @param out Copie cohérente
+ * @return 0 si succès, -1 si format inconnu ou écrivain bloqué en cours d'écriture
+ */
+int prad_shm_read(const prad_shm_reader_t *reader, prad_shm_board_t *out);
+
+/**
+ * @brief Libère la projection du segment
+ * @param reader Lecteur ouvert
+ */
+void prad_shm_close(prad_shm_reader_t *reader);
+
+#endif // PRAD_SHM_H
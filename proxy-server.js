@@ -14,6 +14,11 @@ const net = require("net");
 const WEBSOCKET_PORT = 8081;
 const TCP_SERVER_HOST = "localhost";
 const TCP_SERVER_PORT = 8080;
+// Socket Unix du serveur C (clé unix_socket), préféré à TCP s'il est défini
+const UNIX_SOCKET_PATH = process.env.PRAD_UNIX_SOCKET || "";
+const MAX_RESUME_ATTEMPTS = 3; // Reconnexions TCP tentées par session
+const RESUME_DELAY_MS = 200; // Délai de base entre deux tentatives
+const MAX_PENDING_MESSAGES = 32; // Messages gardés avant la connexion au serveur
 
 // Compteurs et statistiques
 let activeConnections = 0;
@@ -68,7 +73,9 @@ log(
 );
 log(
   "INFO",
-  `Prêt à se connecter au serveur TCP: ${TCP_SERVER_HOST}:${TCP_SERVER_PORT}`,
+  UNIX_SOCKET_PATH
+    ? `Prêt à se connecter au serveur C: ${UNIX_SOCKET_PATH} (repli sur ${TCP_SERVER_HOST}:${TCP_SERVER_PORT})`
+    : `Prêt à se connecter au serveur TCP: ${TCP_SERVER_HOST}:${TCP_SERVER_PORT}`,
   colors.blue,
 );
 log("INFO", "En attente de connexions WebSocket...", colors.blue);
@@ -92,53 +99,210 @@ wss.on("connection", (ws, req) => {
     colors.cyan,
   );
 
-  // Créer une connexion TCP vers le serveur C
-  const tcpClient = new net.Socket();
+  // État de la session côté proxy (reprise transparente)
+  let tcpClient = null;
   let tcpConnected = false;
+  let resumeToken = null; // Jeton reçu dans game_start
+  let gameOver = false; // victory/bye reçu: pas de reprise
+  let resuming = false; // Messages filtrés jusqu'à "resumed"
+  let resumeAttempts = 0;
+  let lineBuffer = "";
+  let pending = []; // Lignes du navigateur reçues avant l'accueil du serveur
+  let serverReady = false; // Premières données du serveur reçues
+
+  // En-tête PROXY (v1): adresse du navigateur, pour que les limites par
+  // adresse du serveur ne s'appliquent pas à tous les joueurs du proxy
+  const browserAddress = (clientIP || "").replace(/^::ffff:(?=\d+\.)/, "");
+  const proxyHeader = net.isIPv4(browserAddress)
+    ? `PROXY TCP4 ${browserAddress} 0.0.0.0 ${req.socket.remotePort} ${WEBSOCKET_PORT}\r\n`
+    : net.isIPv6(browserAddress)
+      ? `PROXY TCP6 ${browserAddress} :: ${req.socket.remotePort} ${WEBSOCKET_PORT}\r\n`
+      : "PROXY UNKNOWN\r\n";
+
+  // Inspecte les lignes JSON du serveur pour suivre l'état de la partie
+  function trackServerLines(text) {
+    lineBuffer += text;
+    const lines = lineBuffer.split("\n");
+    lineBuffer = lines.pop();
+
+    const forwarded = [];
+    for (const line of lines) {
+      if (!line) continue;
+      let data = null;
+      try {
+        data = JSON.parse(line);
+      } catch (e) {
+        // Ligne non JSON: transmise telle quelle
+      }
 
-  // Connexion au serveur TCP
-  tcpClient.connect(TCP_SERVER_PORT, TCP_SERVER_HOST, () => {
-    tcpConnected = true;
-    log(
-      "TCP",
-      `Client #${clientId}: Connexion TCP établie avec le serveur C`,
-      colors.blue,
-    );
-  });
-
-  // Recevoir les données du serveur TCP
-  tcpClient.on("data", (data) => {
-    const message = data.toString("utf8");
+      if (data && (data.type === "game_start" || data.type === "resumed")) {
+        resumeToken = data.resume || resumeToken;
+        gameOver = false;
+        if (data.type === "resumed" && resuming) {
+          resuming = false;
+          resumeAttempts = 0;
+          log(
+            "RESUME",
+            `Client #${clientId}: Partie reprise après coupure TCP`,
+            colors.green,
+          );
+          continue; // Reprise invisible pour le navigateur
+        }
+      } else if (data && (data.type === "victory" || data.type === "bye")) {
+        gameOver = true;
+      } else if (data && resuming && data.type === "error") {
+        // Jeton refusé: abandonner la reprise, la session repart de zéro
+        resuming = false;
+        resumeToken = null;
+      }
 
-    // Log plus concis pour les longs messages
-    const preview =
-      message.length > 100 ? message.substring(0, 100) + "..." : message;
-    const lines = preview.split("\n").length;
-    log(
-      "TCP→WS",
-      `Client #${clientId}: ${lines} lignes (${message.length} bytes)`,
-      colors.yellow,
-    );
+      // Pendant une reprise, l'accueil éventuellement rejoué est masqué
+      if (resuming) continue;
+      forwarded.push(line);
+    }
+    return forwarded.length ? forwarded.join("\n") + "\n" : "";
+  }
 
-    // Envoyer au client WebSocket
-    if (ws.readyState === WebSocket.OPEN) {
-      ws.send(message);
+  // Créer (ou recréer) la connexion vers le serveur C: socket Unix si
+  // configuré (pas de pile TCP de bouclage), sinon ou à défaut TCP
+  function connectTcp(withResume, useUnix = UNIX_SOCKET_PATH !== "") {
+    const socket = new net.Socket();
+    tcpClient = socket;
+    resuming = withResume;
+    lineBuffer = "";
+    serverReady = false;
+
+    const onConnect = () => {
+      tcpConnected = true;
+      // Seul dans le socket jusqu'à l'accueil: le serveur le lit comme une ligne
+      socket.write(proxyHeader);
+      log(
+        "TCP",
+        `Client #${clientId}: Connexion ${useUnix ? "Unix" : "TCP"} établie avec le serveur C`,
+        colors.blue,
+      );
+    };
+    if (useUnix) {
+      socket.connect(UNIX_SOCKET_PATH, onConnect);
+    } else {
+      socket.connect(TCP_SERVER_PORT, TCP_SERVER_HOST, onConnect);
     }
-  });
+
+    // Recevoir les données du serveur TCP
+    socket.on("data", (data) => {
+      if (!serverReady) {
+        // Messages du navigateur arrivés avant l'accueil (resume de
+        // ws.onopen, ...): transmis dans l'ordre
+        serverReady = true;
+        for (const line of pending) {
+          socket.write(line);
+        }
+        pending = [];
+      }
+      const message = trackServerLines(data.toString("utf8"));
+      if (!message) return;
+
+      // Log plus concis pour les longs messages
+      const preview =
+        message.length > 100 ? message.substring(0, 100) + "..." : message;
+      const lines = preview.split("\n").length;
+      log(
+        "TCP→WS",
+        `Client #${clientId}: ${lines} lignes (${message.length} bytes)`,
+        colors.yellow,
+      );
+
+      // Envoyer au client WebSocket
+      if (ws.readyState === WebSocket.OPEN) {
+        ws.send(message);
+      }
+    });
+
+    // Gestion de la fermeture TCP
+    socket.on("close", () => {
+      if (socket !== tcpClient) return;
+      tcpConnected = false;
+      log(
+        "TCP",
+        `Client #${clientId}: Connexion TCP fermée par le serveur`,
+        colors.yellow,
+      );
+
+      // Partie en cours et navigateur toujours là: reprise transparente
+      if (
+        ws.readyState === WebSocket.OPEN &&
+        resumeToken &&
+        !gameOver &&
+        resumeAttempts < MAX_RESUME_ATTEMPTS
+      ) {
+        resumeAttempts++;
+        // Première ligne après l'en-tête; l'accueil rejoué par le serveur
+        // est masqué jusqu'à "resumed"
+        pending.unshift(`resume ${resumeToken}\n`);
+        setTimeout(() => connectTcp(true), RESUME_DELAY_MS * resumeAttempts);
+        return;
+      }
+
+      // Fermer le WebSocket si encore ouvert
+      if (ws.readyState === WebSocket.OPEN) {
+        ws.close(1000, "TCP connection closed by server");
+      }
+    });
+
+    // Gestion des erreurs TCP
+    socket.on("error", (error) => {
+      // Socket Unix absent ou sans serveur: nouvel essai immédiat en TCP
+      if (useUnix && !tcpConnected && socket === tcpClient) {
+        log(
+          "WARNING",
+          `Client #${clientId}: socket Unix indisponible (${error.code}), repli sur TCP`,
+          colors.yellow,
+        );
+        connectTcp(withResume, false);
+        return;
+      }
+      log(
+        "ERROR",
+        `Client #${clientId}: TCP error: ${error.message}`,
+        colors.red,
+      );
+
+      // Informer le client WebSocket (sauf si une reprise reste possible)
+      const canResume =
+        resumeToken && !gameOver && resumeAttempts < MAX_RESUME_ATTEMPTS;
+      if (ws.readyState === WebSocket.OPEN && !canResume) {
+        const errorMsg = `❌ ERREUR de connexion au serveur: ${error.message}\n`;
+        ws.send(errorMsg);
+        ws.close(1011, "TCP connection error");
+      }
+    });
+
+    // Timeout de connexion TCP
+    socket.setTimeout(60000); // 60 secondes
+    socket.on("timeout", () => {
+      log("TIMEOUT", `Client #${clientId}: TCP timeout (60s)`, colors.red);
+      gameOver = true; // Inactivité: pas de reprise automatique
+      socket.end();
+    });
+  }
+
+  connectTcp(false);
 
   // Recevoir les messages du client WebSocket
   ws.on("message", (message) => {
     const msg = message.toString("utf8").trim();
     log("WS→TCP", `Client #${clientId}: "${msg}"`, colors.cyan);
 
-    // Envoyer au serveur TCP
-    if (tcpConnected) {
-      const dataToSend = msg.endsWith("\n") ? msg : msg + "\n";
+    // Envoyer au serveur TCP, ou garder jusqu'à la connexion (ou reprise)
+    const dataToSend = msg.endsWith("\n") ? msg : msg + "\n";
+    if (tcpConnected && serverReady) {
       tcpClient.write(dataToSend);
+    } else if (pending.length < MAX_PENDING_MESSAGES) {
+      pending.push(dataToSend);
     } else {
       log(
         "ERROR",
-        `Client #${clientId}: TCP non connecté, impossible d'envoyer`,
+        `Client #${clientId}: TCP non connecté, file d'attente pleine`,
         colors.red,
       );
       if (ws.readyState === WebSocket.OPEN) {
@@ -162,7 +326,7 @@ wss.on("connection", (ws, req) => {
       colors.cyan,
     );
 
-    // Fermer la connexion TCP
+    // Fermer la connexion TCP (le serveur suspend la partie en cours)
     if (tcpConnected) {
       tcpClient.end();
     }
@@ -172,44 +336,6 @@ wss.on("connection", (ws, req) => {
   ws.on("error", (error) => {
     log("ERROR", `Client WS #${clientId}: ${error.message}`, colors.red);
   });
-
-  // Gestion de la fermeture TCP
-  tcpClient.on("close", () => {
-    tcpConnected = false;
-    log(
-      "TCP",
-      `Client #${clientId}: Connexion TCP fermée par le serveur`,
-      colors.yellow,
-    );
-
-    // Fermer le WebSocket si encore ouvert
-    if (ws.readyState === WebSocket.OPEN) {
-      ws.close(1000, "TCP connection closed by server");
-    }
-  });
-
-  // Gestion des erreurs TCP
-  tcpClient.on("error", (error) => {
-    log(
-      "ERROR",
-      `Client #${clientId}: TCP error: ${error.message}`,
-      colors.red,
-    );
-
-    // Informer le client WebSocket
-    if (ws.readyState === WebSocket.OPEN) {
-      const errorMsg = `❌ ERREUR de connexion au serveur: ${error.message}\n`;
-      ws.send(errorMsg);
-      ws.close(1011, "TCP connection error");
-    }
-  });
-
-  // Timeout de connexion TCP
-  tcpClient.setTimeout(60000); // 60 secondes
-  tcpClient.on("timeout", () => {
-    log("TIMEOUT", `Client #${clientId}: TCP timeout (60s)`, colors.red);
-    tcpClient.end();
-  });
 });
 
 // Gestion des erreurs du serveur WebSocket
@@ -280,7 +406,7 @@ console.log(
     colors.reset,
 );
 console.log(colors.magenta + "💡 Configuration:");
-console.log(`   - Plage: 0-100 (fixe)`);
+console.log(`   - Plage: selon la difficulté (0-100 par défaut, "level" pour changer)`);
 console.log(`   - Noms: 3-10 lettres uniquement`);
 console.log(`   - Score: 10000 - (essais×100) - temps`);
 console.log(`   - Prix: 🏆 Plat offert au 1er!\n` + colors.reset);
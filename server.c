@@ -16,10 +16,23 @@
  * Ce serveur implémente un jeu de devinette distribué avec les fonctionnalités:
  * - Multi-threading POSIX pour gérer plusieurs clients simultanément
  * - Système de scoring compétitif: Score = 10000 - (tentatives × 100) - temps
- * - Leaderboard persistant des 10 meilleurs scores
- * - Validation stricte des entrées (nom: 3-10 lettres, nombre: 0-100)
+ * - Politiques de score par mode (PRAD_SCORING), spécialisées à la compilation
+ * - Leaderboard persistant des 10 meilleurs scores, un par mode et difficulté
+ * - Validation stricte des entrées (nom: 3-10 lettres, nombre dans la plage)
+ * - Niveaux de difficulté jusqu'à une plage de 64 bits (commande "level")
  * - Statistiques serveur en temps réel
- * - Gestion propre des signaux (SIGINT, SIGTERM)
+ * - Reprise d'une partie après déconnexion (jeton "resume" de game_start)
+ * - Salons multi-joueurs (course) et tournois par tours résolus par lot
+ * - Mode spectateur (leaderboard et victoires en direct, un seul thread)
+ * - Export en mémoire partagée (seqlock) pour les tableaux de bord locaux
+ * - Journal d'événements de jeu en segments projetables (PRAD_EVENT_LOG)
+ * - Export SQLite des parties terminées, par lots (PRAD_WITH_SQLITE)
+ * - Remplacement à chaud du leaderboard recalculé par prad_rebuild, par le
+ *   socket Unix d'administration (clé "admin_socket", même utilisateur)
+ * - Arrêt progressif sur SIGINT / SIGTERM: parties en cours terminées avant
+ *   l'échéance, journaux et export vidés
+ * - Fichier de configuration et options en ligne de commande, rechargement
+ *   à chaud des limites, délais, débits et niveau de log (SIGHUP)
  *
  * ARCHITECTURE:
  * ------------
@@ -28,15 +41,24 @@
  * COMPILATION:
  * -----------
  * gcc -o server server.c -pthread -Wall -Wextra -O2
+ * gcc -o server server.c -pthread -Wall -Wextra -O2 -DPRAD_WITH_SQLITE -lsqlite3
  *
  * EXÉCUTION:
  * ---------
- * ./server
+ * ./server [-c fichier.conf] [-p port] [-o clé=valeur]... [-u socket | -r socket]
  *
- * Le serveur écoute sur le port 8080 par défaut (modifiable via PORT)
+ * Le serveur écoute sur le port 8080 par défaut (clé "port", option -p), en
+ * IPv4 et IPv6 sur toutes les interfaces ou sur les adresses de la clé
+ * "bind", et aussi sur un socket Unix pour le proxy local (clé "unix_socket").
+ * Avec la clé "ws_port", les navigateurs s'y connectent en WebSocket sans proxy.
+ * kill -HUP <pid> relit le fichier sans couper les sessions.
+ * ./server -u <handoff_socket> remplace un serveur en cours sans coupure.
+ * ./server -r <standby_socket> suit un serveur en cours et prend son port s'il s'arrête.
  * ============================================================================
  */
 
+#define _GNU_SOURCE // struct ucred (SO_PEERCRED) pour la bascule à chaud
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -47,20 +69,130 @@
 #include <signal.h>
 #include <errno.h>
 #include <ctype.h>
+#include <stdint.h>
+#include <stdarg.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <stddef.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/random.h>
+#include <netdb.h>
+#include <netinet/tcp.h>
+
+#include "prad_shm.h"
+#include "prad_events.h"
+#include "prad_rebuild.h"
+#include "prad_scoring.h"
+
+#ifdef PRAD_WITH_SQLITE
+#include <sqlite3.h>
+#endif
 
 /* ============================================================================
  * CONSTANTES DE CONFIGURATION
  * ============================================================================ */
-#define PORT                8080        // Port d'écoute du serveur
-#define MAX_CLIENTS         30          // Nombre maximum de clients simultanés
+#define PORT                8080        // Port d'écoute par défaut (clé "port")
+#define MAX_CLIENTS         30          // Clients simultanés par défaut (clé "max_clients")
 #define BUFFER_SIZE         4096        // Taille du buffer de communication
-#define MIN_NUMBER          0           // Borne inférieure de la plage
-#define MAX_NUMBER          100         // Borne supérieure de la plage
+#define DIFFICULTY_LEVELS   PRAD_DIFFICULTY_LEVELS // Niveaux (prad_scoring.h, le premier par défaut)
+#define BOARD_BIT(mode, level) (1u << ((mode) * DIFFICULTY_LEVELS + (level))) // Leaderboard modifié
 #define MIN_NAME_LENGTH     3           // Longueur minimale du nom (3 lettres)
 #define MAX_NAME_LENGTH     11          // Longueur maximale du nom (10 lettres + \0)
 #define TOP_SCORES          10          // Nombre de scores dans le leaderboard
-#define INITIAL_SCORE       10000       // Score de départ pour le calcul
-#define ATTEMPT_PENALTY     100         // Pénalité par tentative
+#define SCORING_ENV         "PRAD_SCORING" // Politique par mode "solo=classic,race=time,..."
+#define RESUME_SLOTS        256         // Capacité de la table de reprise (puissance de 2)
+#define RESUME_PROBES       8           // Longueur maximale de sondage dans la table
+#define RESUME_TTL          120         // Conservation d'une partie suspendue par défaut (s)
+#define OUTBOX_CAPACITY     64          // Messages diffusés en attente par session
+#define MAX_ROOMS           16          // Nombre maximum de salons simultanés
+#define MAX_ROOM_MEMBERS    512         // Joueurs maximum par salon
+#define MAX_ROOM_NAME       16          // Longueur maximale du nom de salon (15 + \0)
+#define PROXY_HEADER_MAX    108         // En-tête PROXY v1 le plus long (\r\n compris)
+#define ROUND_WINDOW_MS     5000        // Fenêtre d'un tour de tournoi par défaut (ms)
+#define ROUND_TICK_MS       50          // Période de vérification des fins de tour (ms)
+#define MAX_LISTED_WINNERS  32          // Gagnants détaillés dans l'annonce d'un tour
+#define MAX_SPECTATORS      1024        // Spectateurs simultanés maximum
+#define SPECTATOR_RING      256         // Événements conservés pour les spectateurs
+#define MAX_CONNECTIONS_PER_IP 8        // Connexions simultanées par IP par défaut
+#define IP_SHARDS           16          // Fragments de la table des adresses (un mutex chacun)
+#define IP_PROBE_SLOTS      64          // Emplacements sondés par adresse (minimum par fragment)
+#define GUESS_RATE          5           // Tentatives par seconde et par IP (défaut)
+#define GUESS_BURST         10          // Rafale maximale de tentatives (défaut)
+#define STATS_RATE          1           // Requêtes stats par seconde et par IP (défaut)
+#define STATS_BURST         3           // Rafale maximale de requêtes stats (défaut)
+#define STATS_TICK_MS       100         // Durée de partage d'un instantané stats/leaderboard (ms)
+#define STATS_MAX_STALE_MS  1000        // Âge toléré tant que des coups sont en cours (ms)
+#define LAG_PROBE_MS        50          // Période de la sonde de retard d'ordonnancement (ms)
+#define SHED_LEVELS         3           // Paliers de délestage au-delà du niveau normal
+#define SHED_HOLD_MS        1000        // Retard sous le seuil bas avant de descendre d'un palier (ms)
+#define SHED_ENV            "PRAD_SHED_MS" // Seuils de retard "a,b,c" en ms
+#define HAZARD_SLOTS        64          // Lecteurs simultanés protégés sans verrou
+#define HAZARD_FALLBACK     -1          // board_acquire: copie privée (emplacements tous pris)
+#define RETIRED_MAX         (2 * HAZARD_SLOTS) // Instantanés retirés en attente
+#define SHM_REFRESH_MS      1000        // Rafraîchissement des compteurs exportés (ms)
+#define EVENTLOG_ENV        "PRAD_EVENT_LOG" // Répertoire du journal d'événements
+#define EVENTLOG_RING       4096        // Événements en attente d'écriture
+#define EVENTLOG_BATCH      256         // Réveil anticipé de l'écrivain (événements)
+#define EVENTLOG_FLUSH_MS   20          // Délai maximal avant écriture d'un lot (ms)
+#define EXPORT_ENV          "PRAD_SQLITE" // Base SQLite des parties terminées
+#define EXPORT_QUEUE        16384       // Parties en attente d'export
+#define EXPORT_BATCH        512         // Réveil anticipé de l'exportateur (parties)
+#define EXPORT_FLUSH_MS     1000        // Délai maximal avant une transaction (ms)
+#define CONFIG_VALUE_MAX    256         // Longueur maximale d'une valeur texte de configuration
+#define CONFIG_OVERRIDES    32          // Options -p / -o retenues (réappliquées au rechargement)
+#define DRAIN_TIMEOUT       30          // Délai laissé aux parties en cours à l'arrêt par défaut (s)
+#define DRAIN_GRACE_MS      1000        // Fermeture des sessions après l'échéance (ms)
+#define DRAIN_FLUSH_MS      5000        // Écriture des journaux et de l'export à l'arrêt (ms)
+#define HANDOFF_MAGIC       0x46484450u // "PHDF" en petit-boutiste (bascule à chaud)
+#define HANDOFF_VERSION     4           // Incrémentée à chaque changement du protocole de bascule
+#define HANDOFF_READY       0x59444552u // "REDY": le nouveau processus a tout reçu
+#define HANDOFF_WAIT_MS     2000        // Mise en attente des sessions avant transmission (ms)
+#define HANDOFF_TIMEOUT_MS  5000        // Délai de chaque échange de la bascule (ms)
+#define ADMIN_TIMEOUT_MS    10000       // Silence toléré sur le socket d'administration (ms)
+#define WORKERS_MAX         64          // Processus workers maximum (clé "workers")
+#define WORKER_RESPAWN_MS   1000        // Relance différée d'un worker mort au démarrage (ms)
+#define EXPORT_BUSY_MS      5000        // Attente de la base SQLite verrouillée par un autre worker (ms)
+#define CLUSTER_MAGIC       0x4c435250u // "PRCL" en petit-boutiste (réplication entre nœuds)
+#define CLUSTER_PEERS_MAX   16          // Pairs sortants maximum (clé "cluster_peers")
+#define CLUSTER_INBOUND_MAX 32          // Connexions entrantes simultanées maximum
+#define CLUSTER_NODES_MAX   64          // Nœuds dont les compteurs sont suivis
+#define CLUSTER_QUEUE       1024        // Deltas en attente par pair (au-delà: envoi complet)
+#define CLUSTER_FLUSH_MS    100         // Regroupement des deltas avant envoi (ms)
+#define CLUSTER_RETRY_MS    1000        // Reconnexion à un pair injoignable (ms)
+#define CLUSTER_MAX_HOPS    8           // Relais maximum d'un enregistrement
+#define CLUSTER_HELLO_MS    2000        // Présentation attendue d'un pair entrant (ms)
+#define CLUSTER_NONCE       16          // Octets du défi envoyé à un pair entrant
+#define CLUSTER_PEER_ADDRS  4           // Adresses retenues par pair (admission des entrants)
+#define CLUSTER_SECRET_ENV  "PRAD_CLUSTER_SECRET" // Secret partagé des nœuds
+#define STANDBY_MAGIC       0x42535250u // "PRSB" en petit-boutiste (réplique de secours)
+#define STANDBY_VERSION     1           // Incrémentée à chaque changement du protocole de réplique
+#define STANDBY_RING        4096        // Journal en attente d'envoi (au-delà: nouvel état complet)
+#define STANDBY_BATCH       64          // Enregistrements par message
+#define STANDBY_HEARTBEAT_MS 100        // Message minimal vers la réplique (mesure du retard)
+#define STANDBY_RETRY_MS    200         // Nouvelle connexion de la réplique au primaire (ms)
+#define STANDBY_BIND_MS     5           // Nouvel essai du port après la fin du flux (ms)
+#define LOCAL_SOCKET_MODE   0660        // Droits du socket Unix de jeu (proxy du même groupe)
+#define BIND_MAX            8           // Adresses d'écoute maximum (clé "bind")
+#define LISTENERS_MAX       (2 * BIND_MAX) // Écoutes: jeu et WebSocket par adresse
+#define ADDRESS_TEXT_MAX    (INET6_ADDRSTRLEN + 8) // "[adresse]:port" et \0
+#define KEEPALIVE_PROBES    3           // Sondes keepalive sans réponse avant coupure
+#define WEBSOCKET_GUID      "258EAFA5-E914-47DA-95CA-C5AB0DC85B11" // RFC 6455 (Sec-WebSocket-Accept)
+#define WEBSOCKET_REQUEST_MAX 4096      // Requête HTTP de poignée de main maximum (octets)
+#define WEBSOCKET_TIMEOUT_MS 5000       // Poignée de main, ou fin d'une trame commencée (ms)
+#define WEBSOCKET_FDS_MAX   (1 << 20)   // Descripteurs couverts par la table d'état WebSocket
+
+_Static_assert(TOP_SCORES == PRAD_SHM_MAX_SCORES, "prad_shm.h doit suivre TOP_SCORES");
+_Static_assert(PRAD_SHM_MODES == PRAD_SCORING_MODES, "prad_shm.h doit suivre les modes de jeu");
+_Static_assert(MAX_NAME_LENGTH <= PRAD_SHM_NAME_LENGTH + 1, "prad_shm.h doit suivre MAX_NAME_LENGTH");
+_Static_assert(PRAD_SHM_LEVELS == DIFFICULTY_LEVELS, "prad_shm.h doit suivre les difficultés");
+_Static_assert(WORKERS_MAX <= 64, "cluster.next_origin réserve 6 bits à l'index du worker");
 
 /* ============================================================================
  * STRUCTURES DE DONNÉES
@@ -76,8 +208,60 @@ typedef struct {
     int duration;                        // Durée en secondes
     int score;                           // Score calculé
     time_t timestamp;                    // Timestamp de la partie
+    uint64_t origin;                     // Identifiant unique (nœud, worker, numéro), 0 = inconnu
 } score_t;
 
+/**
+ * @enum game_mode_t
+ * @brief Mode de jeu: un leaderboard et une politique de score chacun
+ */
+typedef enum {
+    GAME_SOLO = PRAD_EVENT_MODE_SOLO,    // Partie individuelle
+    GAME_RACE = PRAD_EVENT_MODE_RACE,    // Salon, course
+    GAME_TOURNAMENT = PRAD_EVENT_MODE_TOURNAMENT, // Salon, tournoi par tours
+    GAME_MODES                           // Nombre de modes
+} game_mode_t;
+
+_Static_assert(GAME_MODES == PRAD_SCORING_MODES, "prad_scoring.h doit suivre game_mode_t");
+
+/**
+ * @struct scoring_policy_t
+ * @brief Politique de score: fonction spécialisée et ses paramètres
+ */
+typedef struct {
+    const char *name;                    // Nom ("classic", "time", ...)
+    int (*score)(int attempts, int duration, int bits); // Formule spécialisée
+    prad_scoring_formula_t formula;      // Paramètres (vérification des instantanés)
+} scoring_policy_t;
+
+/**
+ * @struct difficulty_t
+ * @brief Niveau de difficulté: plage de la partie et leaderboard associé
+ *
+ * Les niveaux dont la plage tient sur 32 bits gardent les chemins rapides
+ * (tournois: tableaux de 32 bits comparés par lot).
+ */
+typedef struct {
+    const char *name;                    // Nom ("easy", "medium", ...)
+    int64_t min;                         // Borne inférieure
+    int64_t max;                         // Borne supérieure
+    int bits;                            // ceil(log2(max - min + 1)), pour le score
+    int wide;                            // Plage au-delà de 32 bits signés
+} difficulty_t;
+
+/**
+ * @struct game_record_t
+ * @brief Partie terminée à comptabiliser (statistiques et leaderboard)
+ */
+typedef struct {
+    char name[MAX_NAME_LENGTH];          // Nom du joueur
+    game_mode_t mode;                    // Leaderboard concerné: mode de jeu
+    int level;                           // et difficulté (index dans difficulties)
+    int attempts;                        // Nombre de tentatives
+    int duration;                        // Durée en secondes
+    int score;                           // Score calculé
+} game_record_t;
+
 /**
  * @struct leaderboard_t
  * @brief Structure du tableau des scores avec mutex pour thread-safety
@@ -85,430 +269,8298 @@ typedef struct {
 typedef struct {
     score_t scores[TOP_SCORES];         // Tableau des meilleurs scores
     int count;                           // Nombre de scores enregistrés
-    pthread_mutex_t mutex;               // Mutex pour accès concurrent
 } leaderboard_t;
 
 /**
- * @struct client_data_t
- * @brief Structure contenant toutes les données d'un client
+ * @struct score_ticket_t
+ * @brief Attente, par le déposant, de l'application de sa partie
  */
 typedef struct {
-    int socket;                          // Socket du client
-    int client_id;                       // ID unique du client
-    struct sockaddr_in address;          // Adresse IP du client
-    int target_number;                   // Nombre à deviner
-    int attempts;                        // Compteur de tentatives
-    time_t start_time;                   // Heure de début de partie
+    int done;                            // Partie appliquée par le propriétaire
+    int inserted;                        // Entrée dans le leaderboard
+} score_ticket_t;
+
+/**
+ * @enum cluster_type_t
+ * @brief Nature d'un enregistrement échangé entre nœuds
+ */
+typedef enum {
+    CLUSTER_HELLO = 1,                   // Présentation authentifiée (cluster_hello_t)
+    CLUSTER_SCORE = 2,                   // Entrée d'un leaderboard
+    CLUSTER_STATS = 3,                   // Compteurs de parties d'un nœud
+    CLUSTER_CHALLENGE = 4                // Défi du nœud contacté (cluster_hello_t)
+} cluster_type_t;
+
+/**
+ * @struct cluster_record_t
+ * @brief Enregistrement de réplication de taille fixe (64 octets)
+ */
+typedef struct {
+    uint32_t magic;                      // CLUSTER_MAGIC
+    uint16_t type;                       // cluster_type_t
+    uint8_t mode;                        // Score: mode de jeu
+    uint8_t level;                       // Score: difficulté
+    uint64_t origin;                     // Score: score_t.origin; compteurs, hello: nœud
+    int64_t origin_us;                   // Date de la victoire, ou version des compteurs (µs)
+    int64_t value;                       // Score: date (s); compteurs: parties
+    int64_t total;                       // Compteurs: tentatives
+    int32_t score;                       // Score; compteurs: meilleur nombre de tentatives
+    int32_t attempts;                    // Tentatives de la partie
+    int32_t duration;                    // Durée (s)
+    uint8_t hops;                        // Relais déjà effectués
     char name[MAX_NAME_LENGTH];          // Nom du joueur
-} client_data_t;
+} cluster_record_t;
+
+_Static_assert(sizeof(cluster_record_t) == 64, "cluster_record_t doit faire 64 octets");
 
 /**
- * @struct stats_t
- * @brief Statistiques globales du serveur
+ * @struct cluster_hello_t
+ * @brief Défi (nœud contacté) puis présentation (nœud appelant), 64 octets
+ *
+ * Présentation: mac = HMAC-SHA1(cluster_secret, octets qui précèdent mac),
+ * avec le défi reçu recopié dans nonce. node occupe la place de origin.
  */
 typedef struct {
-    int total_games;                     // Nombre total de parties
-    int total_attempts;                  // Nombre total de tentatives
+    uint32_t magic;                      // CLUSTER_MAGIC
+    uint16_t type;                       // CLUSTER_CHALLENGE ou CLUSTER_HELLO
+    uint16_t reserved;                   // 0
+    uint64_t node;                       // Présentation: nœud appelant
+    uint8_t nonce[CLUSTER_NONCE];        // Défi tiré par le nœud contacté
+    uint8_t mac[20];                     // Présentation: HMAC-SHA1
+    uint8_t padding[12];                 // 0
+} cluster_hello_t;
+
+_Static_assert(sizeof(cluster_hello_t) == sizeof(cluster_record_t),
+               "cluster_hello_t doit faire la taille d'un enregistrement");
+
+/**
+ * @struct score_event_t
+ * @brief Partie terminée en transit vers le thread propriétaire
+ */
+typedef struct score_event {
+    struct score_event *next;            // Chaînage de la pile sans verrou
+    game_record_t record;                // Partie à appliquer
+    int64_t posted_us;                   // Date de dépôt (latence de file)
+    score_ticket_t *ticket;              // Attente du déposant (NULL = aucune)
+    prad_board_file_t *swap;             // Remplacement complet (admin), sinon NULL
+    int barrier;                         // Sans effet: attend les lots précédents (arrêt)
+    prad_board_file_t *dump;             // Barrière: copie de l'état à remplir (bascule)
+    cluster_record_t *remote;            // Entrée reçue d'un autre nœud, sinon NULL
+} score_event_t;
+
+/**
+ * @struct board_snapshot_t
+ * @brief Instantané immuable du leaderboard et des statistiques de parties
+ *
+ * Jamais modifié après publication; libéré par le propriétaire quand plus
+ * aucun pointeur de danger ne le désigne.
+ */
+typedef struct {
+    leaderboard_t boards[GAME_MODES][DIFFICULTY_LEVELS]; // Copie des leaderboards
+    int total_games;                     // Parties terminées
     int best_attempts;                   // Meilleur nombre de tentatives
     float avg_attempts;                  // Moyenne de tentatives
-    time_t server_start_time;            // Timestamp de démarrage
-    pthread_mutex_t mutex;               // Mutex pour accès concurrent
-} stats_t;
-
-/* ============================================================================
- * VARIABLES GLOBALES
- * ============================================================================ */
-static int server_socket = -1;                              // Socket serveur
-static int active_clients = 0;                              // Clients connectés
-static int total_clients_served = 0;                        // Total clients
-static pthread_mutex_t clients_mutex = PTHREAD_MUTEX_INITIALIZER;
-static stats_t global_stats = {0, 0, 999999, 0.0, 0, PTHREAD_MUTEX_INITIALIZER};
-static leaderboard_t leaderboard = {.count = 0, .mutex = PTHREAD_MUTEX_INITIALIZER};
+} board_snapshot_t;
 
-/* ============================================================================
- * PROTOTYPES DES FONCTIONS
- * ============================================================================ */
-void handle_signal(int sig);
-void log_message(const char *level, const char *message);
-int send_message(int socket, const char *message);
-int receive_message(int socket, char *buffer, int size);
-int validate_name(const char *name);
-void update_stats(int attempts);
-int calculate_score(int attempts, int duration);
-void add_to_leaderboard(const char *name, int attempts, int duration, int score);
-void display_server_stats(int socket);
-void display_leaderboard(int socket);
-void send_json_stats(int socket);
-void send_json_leaderboard(int socket);
-void send_json_prompt(int socket, const char *message);
-void send_json_name_accepted(int socket, const char *name);
-void send_json_game_start(int socket, const char *player, int min, int max);
-void send_json_hint(int socket, const char *direction, int attempts);
-void send_json_victory(int socket, const char *player, int number, int attempts, int duration, int score);
-void send_json_error(int socket, const char *message);
-void send_json_bye(int socket, const char *message);
-void *handle_client(void *arg);
+/**
+ * @struct scoreboard_actor_t
+ * @brief Thread unique propriétaire du leaderboard et des statistiques
+ *
+ * Les sessions déposent leurs parties dans une pile MPSC sans verrou; le
+ * propriétaire la vide d'un seul échange atomique, applique le lot puis
+ * publie un instantané immuable pour les lecteurs. Les lecteurs protègent
+ * l'instantané qu'ils lisent par un pointeur de danger: aucun verrou d'un
+ * côté comme de l'autre, et seul le propriétaire libère la mémoire.
+ */
+typedef struct {
+    score_event_t *inbox;                // Pile MPSC (tête, accès atomiques)
+    int wake_fd;                         // eventfd de réveil du propriétaire
+    board_snapshot_t *published;         // Dernier instantané publié (échange atomique)
+    board_snapshot_t *hazards[HAZARD_SLOTS]; // Instantanés en cours de lecture
+    board_snapshot_t *retired[RETIRED_MAX];  // Remplacés, pas encore libérés (propriétaire)
+    int retired_count;                   // Nombre d'instantanés retirés
+    pthread_mutex_t reclaim_mutex;       // Libération vs copies de repli (board_acquire)
+    pthread_mutex_t ticket_mutex;        // Attentes des déposants
+    pthread_cond_t ticket_cond;          // Signalée après chaque lot
+    unsigned long batches;               // Lots appliqués
+    unsigned long applied;               // Parties appliquées
+    unsigned long max_batch;             // Plus grand lot
+    unsigned long dropped;               // Parties perdues (allocation)
+    int64_t latency_total_us;            // Somme des latences de file
+    int64_t latency_max_us;              // Pire latence de file
+} scoreboard_actor_t;
 
-/* ============================================================================
- * IMPLÉMENTATION DES FONCTIONS
- * ============================================================================ */
+/**
+ * @struct payload_t
+ * @brief Message sérialisé une seule fois et partagé par compteur de références
+ */
+typedef struct {
+    int refs;                            // Références (accès atomiques)
+    size_t len;                          // Longueur du message
+    char data[];                         // Message JSON terminé par \n
+} payload_t;
 
 /**
- * @brief Gestionnaire de signaux pour arrêt propre du serveur
- * @param sig Numéro du signal reçu
+ * @struct outbox_t
+ * @brief File circulaire des messages diffusés vers une session
+ *
+ * Les autres threads déposent des références; seul le thread de la session
+ * écrit sur son socket, ce qui préserve l'ordre des messages.
  */
-void handle_signal(int sig) {
-    char msg[100];
-    snprintf(msg, sizeof(msg), "Signal %d reçu, arrêt du serveur", sig);
-    log_message("SHUTDOWN", msg);
+typedef struct {
+    payload_t *items[OUTBOX_CAPACITY];   // Messages en attente
+    unsigned int head;                   // Prochain message à envoyer
+    unsigned int tail;                   // Prochain emplacement libre
+    unsigned int dropped;                // Messages perdus (file pleine)
+    int wake_fd;                         // eventfd de réveil du thread
+    pthread_mutex_t mutex;               // Mutex pour accès concurrent
+} outbox_t;
 
-    if (server_socket >= 0) {
-        close(server_socket);
-    }
+/**
+ * @struct token_bucket_t
+ * @brief Seau à jetons (en millièmes de jeton pour éviter les flottants)
+ */
+typedef struct {
+    int64_t tokens;                      // Jetons disponibles (× 1000)
+    int64_t last_ms;                     // Dernier remplissage (horloge monotone)
+} token_bucket_t;
 
-    pthread_mutex_destroy(&clients_mutex);
-    pthread_mutex_destroy(&global_stats.mutex);
-    pthread_mutex_destroy(&leaderboard.mutex);
+/**
+ * @enum bucket_kind_t
+ * @brief Catégories de requêtes limitées en débit
+ */
+typedef enum {
+    BUCKET_GUESS = 0,                    // Tentatives de jeu
+    BUCKET_STATS = 1                     // Requêtes stats/leaderboard
+} bucket_kind_t;
 
-    printf("\n✅ Serveur arrêté proprement\n\n");
-    exit(0);
-}
+/**
+ * @struct ip_entry_t
+ * @brief Suivi d'une adresse source: connexions ouvertes et seaux à jetons
+ */
+typedef struct {
+    uint64_t key;                        // Clé d'adresse (ip_key), 0 = libre
+    uint8_t shard;                       // Fragment propriétaire
+    int connections;                     // Connexions ouvertes
+    int64_t last_seen_ms;                // Dernière activité
+    token_bucket_t buckets[2];           // Seaux par catégorie (bucket_kind_t)
+} ip_entry_t;
 
 /**
- * @brief Affiche un message de log avec timestamp et niveau
- * @param level Niveau du log (INFO, SUCCESS, WARNING, ERROR)
- * @param message Message à afficher
+ * @struct ip_shard_t
+ * @brief Fragment de la table des adresses (sondage limité au fragment)
  */
-void log_message(const char *level, const char *message) {
-    time_t now = time(NULL);
-    char timestamp[20];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+typedef struct {
+    ip_entry_t *slots;                   // Adresses suivies (ip_shard_slots)
+    pthread_mutex_t mutex;               // Mutex du fragment
+} ip_shard_t;
 
-    // Couleurs ANSI selon le niveau
-    const char *color = "\033[0m";
-    if (strcmp(level, "SUCCESS") == 0) color = "\033[32m";      // Vert
-    else if (strcmp(level, "ERROR") == 0) color = "\033[31m";   // Rouge
-    else if (strcmp(level, "WARNING") == 0) color = "\033[33m"; // Jaune
-    else if (strcmp(level, "INFO") == 0) color = "\033[36m";    // Cyan
+/**
+ * @struct read_snapshot_t
+ * @brief Instantané partagé stats + leaderboard servi aux requêtes de lecture
+ *
+ * Toutes les lectures d'un même tick partagent un seul message sérialisé;
+ * tant que des coups de jeu sont en cours, les lectures se contentent d'un
+ * instantané plus ancien plutôt que de disputer les mutex aux coups.
+ */
+typedef struct {
+    payload_t *payload[GAME_MODES][DIFFICULTY_LEVELS]; // Lignes stats + leaderboard
+    int64_t built_ms[GAME_MODES][DIFFICULTY_LEVELS]; // Date de construction (0 = périmé)
+    unsigned long built;                 // Instantanés construits
+    unsigned long served;                // Lectures servies
+    pthread_mutex_t mutex;               // Protège payload et built_ms
+    pthread_mutex_t build_mutex;         // Une seule reconstruction à la fois
+} read_snapshot_t;
 
-    printf("%s[%s] [%-8s]\033[0m %s\n", color, timestamp, level, message);
-}
+/**
+ * @enum shed_level_t
+ * @brief Paliers de délestage, cumulatifs
+ */
+typedef enum {
+    SHED_NONE = 0,                       // Fonctionnement normal
+    SHED_CACHED_STATS,                   // Lectures servies depuis l'instantané (1 s)
+    SHED_NO_PUSH,                        // Plus de diffusion du leaderboard
+    SHED_REFUSE                          // Nouvelles connexions refusées (retry_after)
+} shed_level_t;
 
 /**
- * @brief Envoie un message au client via socket
- * @param socket Socket du client
- * @param message Message à envoyer
- * @return 0 si succès, -1 si erreur
+ * @struct load_monitor_t
+ * @brief Mesure du retard d'ordonnancement et palier de délestage courant
  */
-int send_message(int socket, const char *message) {
-    size_t len = strlen(message);
-    ssize_t sent = send(socket, message, len, MSG_NOSIGNAL);
-    return (sent == (ssize_t)len) ? 0 : -1;
-}
+typedef struct {
+    int lag_us;                          // Retard lissé (moyenne mobile, µs)
+    int level;                           // Palier courant (shed_level_t)
+    unsigned long refused;               // Connexions refusées par délestage
+} load_monitor_t;
 
 /**
- * @brief Reçoit un message du client avec nettoyage des retours à la ligne
- * @param socket Socket du client
- * @param buffer Buffer de réception
- * @param size Taille du buffer
- * @return Nombre d'octets reçus, -1 si erreur
+ * @enum log_level_t
+ * @brief Sévérité minimale des messages affichés (clé "log_level")
  */
-int receive_message(int socket, char *buffer, int size) {
-    memset(buffer, 0, size);
-    ssize_t bytes_received = recv(socket, buffer, size - 1, 0);
+typedef enum {
+    LOG_INFO = 0,                        // Tout (INFO, SUCCESS, ...)
+    LOG_WARNING,                         // Avertissements et erreurs
+    LOG_ERROR                            // Erreurs et arrêt uniquement
+} log_level_t;
 
-    if (bytes_received <= 0) {
-        return -1;
-    }
+/**
+ * @struct server_config_t
+ * @brief Configuration à l'exécution (défauts < fichier < environnement < options)
+ *
+ * Les champs marqués "rechargeable" sont relus sur SIGHUP et lus sans verrou
+ * (CONFIG_GET); les autres ne prennent effet qu'au démarrage. Les tailles
+ * (BUFFER_SIZE, TOP_SCORES), les plages et les formules restent fixées à la
+ * compilation: elles définissent les formats partagés (prad_*.h).
+ */
+typedef struct {
+    int port;                            // Port d'écoute
+    int max_clients;                     // Clients simultanés (rechargeable)
+    int max_per_ip;                      // Connexions par IP (rechargeable)
+    int guess_rate;                      // Tentatives/s par IP (rechargeable)
+    int guess_burst;                     // Rafale de tentatives (rechargeable)
+    int stats_rate;                      // Requêtes stats/s par IP (rechargeable)
+    int stats_burst;                     // Rafale de requêtes stats (rechargeable)
+    int resume_ttl;                      // Conservation d'une partie suspendue, s (rechargeable)
+    int round_window_ms;                 // Durée d'un tour de tournoi (rechargeable)
+    int shed_ms[SHED_LEVELS];            // Seuils de délestage (rechargeable)
+    int log_level;                       // log_level_t (rechargeable)
+    int drain_timeout;                   // Délai des parties en cours à l'arrêt, s (rechargeable)
+    char event_log[CONFIG_VALUE_MAX];    // Répertoire du journal d'événements
+    char sqlite[CONFIG_VALUE_MAX];       // Base SQLite des parties terminées
+    char scoring[CONFIG_VALUE_MAX];      // Politique par mode
+    char handoff_socket[CONFIG_VALUE_MAX]; // Socket Unix de bascule à chaud
+    char standby_socket[CONFIG_VALUE_MAX]; // Socket Unix de la réplique de secours
+    char unix_socket[CONFIG_VALUE_MAX];  // Socket Unix de jeu (proxy local)
+    char admin_socket[CONFIG_VALUE_MAX]; // Socket Unix d'administration (0600)
+    char bind_addresses[CONFIG_VALUE_MAX]; // Adresses d'écoute (vide = toutes, IPv4 et IPv6)
+    int ws_port;                         // Port WebSocket sur les mêmes adresses (0 = désactivé)
+    int tcp_nodelay;                     // TCP_NODELAY des connexions (rechargeable)
+    int tcp_quickack;                    // ACK immédiat de chaque requête (rechargeable)
+    int tcp_keepalive;                   // Inactivité avant sondes keepalive, s (rechargeable)
+    int busy_poll;                       // SO_BUSY_POLL des connexions, µs (rechargeable)
+    int tcp_defer_accept;                // TCP_DEFER_ACCEPT des écoutes, s (0 = désactivé)
+    int tcp_fastopen;                    // File TCP_FASTOPEN des écoutes (0 = désactivé)
+    int sndbuf;                          // SO_SNDBUF des écoutes, hérité (0 = noyau)
+    int rcvbuf;                          // SO_RCVBUF des écoutes, hérité (0 = noyau)
+    int workers;                         // Processus workers (1 = processus unique)
+    int cluster_port;                    // Port de réplication (0 = nœud isolé)
+    int cluster_node;                    // Identifiant du nœud (0 = cluster_port)
+    char cluster_peers[CONFIG_VALUE_MAX]; // Pairs "hôte:port,..."
+    char cluster_bind[CONFIG_VALUE_MAX]; // Adresse d'écoute de la réplication
+    char cluster_secret[CONFIG_VALUE_MAX]; // Secret partagé (présentation des pairs)
+} server_config_t;
 
-    // Nettoyer les retours à la ligne
-    buffer[strcspn(buffer, "\r\n")] = '\0';
+/**
+ * @enum config_kind_t
+ * @brief Format de la valeur d'une clé de configuration
+ */
+typedef enum {
+    CONFIG_INT,                          // Entier borné
+    CONFIG_TEXT,                         // Chaîne (chemin)
+    CONFIG_SHED,                         // Seuils "a,b,c"
+    CONFIG_LOG_LEVEL,                    // info, warning, error
+    CONFIG_SCORING,                      // "mode=politique,..."
+    CONFIG_BIND,                         // "adresse[:port],..." (bind_parse)
+    CONFIG_SECRET                        // Chaîne jamais journalisée
+} config_kind_t;
 
-    return bytes_received;
-}
+/**
+ * @struct config_key_t
+ * @brief Description d'une clé (fichier, -o, environnement)
+ */
+typedef struct {
+    const char *name;                    // Clé ("max_clients", ...)
+    config_kind_t kind;                  // Format de la valeur
+    size_t offset;                       // Champ dans server_config_t
+    int min;                             // Borne inférieure (CONFIG_INT)
+    int max;                             // Borne supérieure (CONFIG_INT)
+    int reloadable;                      // 1 = appliquée sur SIGHUP
+    const char *env;                     // Variable d'environnement équivalente
+} config_key_t;
 
 /**
- * @brief Valide le nom du joueur selon les règles strictes
- * @param name Nom à valider
- * @return 1 si valide, 0 sinon
+ * @struct event_log_t
+ * @brief Journal d'événements: file en mémoire et segment courant projeté
  *
- * Règles de validation:
- * - Longueur: 3 à 10 caractères
- * - Uniquement des lettres (a-z, A-Z)
- * - Pas de chiffres, espaces ou caractères spéciaux
+ * Les sessions déposent leurs événements dans la file (copie de 64 octets
+ * sous mutex); un thread écrivain les recopie par lots dans le segment et
+ * publie le nouveau nombre d'enregistrements complets en une seule écriture.
  */
-int validate_name(const char *name) {
-    if (!name || name[0] == '\0') {
-        return 0;
-    }
+typedef struct {
+    int enabled;                         // Journal actif (PRAD_EVENT_LOG défini)
+    char dir[256];                       // Répertoire des segments
+    prad_event_t ring[EVENTLOG_RING];    // Événements en attente
+    unsigned int head;                   // Prochain emplacement libre
+    unsigned int tail;                   // Prochain événement à écrire
+    prad_events_segment_t *segment;      // Segment courant (écrivain uniquement)
+    uint64_t next_seq;                   // Numéro du prochain événement
+    unsigned long batches;               // Lots écrits
+    unsigned long written;               // Événements écrits
+    unsigned long dropped;               // Événements perdus (file pleine)
+    int64_t victory_ns;                  // Coût cumulé du dépôt des victoires
+    unsigned long victories;             // Victoires journalisées
+    int closing;                         // Arrêt demandé: vider la file puis s'arrêter
+    int closed;                          // File vidée et segment synchronisé
+    pthread_mutex_t mutex;               // Protège la file
+    pthread_cond_t cond;                 // Réveil de l'écrivain (et fin de l'arrêt)
+} event_log_t;
 
-    size_t len = strlen(name);
+/**
+ * @struct export_row_t
+ * @brief Partie terminée en attente d'export SQL
+ */
+typedef struct {
+    game_record_t record;                // Partie
+    int64_t finished_at;                 // Date d'application (secondes Unix)
+} export_row_t;
 
-    // Vérifier la longueur
-    if (len < MIN_NAME_LENGTH || len >= MAX_NAME_LENGTH) {
-        return 0;
-    }
+/**
+ * @struct export_queue_t
+ * @brief File de l'exportateur SQL, alimentée par le propriétaire du leaderboard
+ *
+ * Les threads de jeu n'y touchent jamais: le propriétaire y recopie chaque
+ * lot appliqué; l'exportateur la vide en une transaction par lot.
+ */
+typedef struct {
+    int enabled;                         // Export actif
+    export_row_t rows[EXPORT_QUEUE];     // Parties en attente
+    unsigned int head;                   // Prochain emplacement libre
+    unsigned int tail;                   // Prochaine partie à exporter
+    unsigned long exported;              // Lignes validées (COMMIT réussi)
+    unsigned long dropped;               // Lignes perdues (file pleine, erreur SQL)
+    unsigned long transactions;          // Transactions validées
+    int rows_per_sec;                    // Débit sur la dernière fenêtre d'une seconde
+    int closing;                         // Arrêt demandé: vider la file puis fermer la base
+    int closed;                          // Base fermée (WAL reporté)
+    pthread_mutex_t mutex;               // Protège la file
+    pthread_cond_t cond;                 // Réveil de l'exportateur (et fin de l'arrêt)
+} export_queue_t;
+
+struct room;
 
-    // Vérifier que ce sont uniquement des lettres
-    for (size_t i = 0; i < len; i++) {
-        if (!isalpha((unsigned char)name[i])) {
-            return 0;
-        }
-    }
+/**
+ * @struct client_data_t
+ * @brief Structure contenant toutes les données d'un client
+ */
+typedef struct client_data {
+    int socket;                          // Socket du client
+    int client_id;                       // ID unique du client
+    struct sockaddr_in6 address;         // Adresse du client (IPv4 mappée en IPv6)
+    int64_t target_number;               // Nombre à deviner
+    const difficulty_t *level;           // Difficulté des parties solo
+    int attempts;                        // Compteur de tentatives
+    time_t start_time;                   // Heure de début de partie
+    char name[MAX_NAME_LENGTH];          // Nom du joueur
+    uint64_t resume_token;               // Jeton de reprise émis dans game_start
+    struct room *room;                   // Salon rejoint (NULL = partie solo)
+    unsigned int room_round;             // Manche du salon jouée par le client
+    unsigned int submitted_turn;         // Dernier tour de tournoi soumis
+    int sub_slot;                        // Index de la soumission dans le tour
+    outbox_t outbox;                     // Messages diffusés en attente
+    ip_entry_t *ip;                      // Suivi de l'adresse source
+    int playing;                         // Accueil terminé, partie en cours
+    int drained;                         // Session fermée par l'arrêt du serveur
+    int adopted;                         // Reçue d'un autre processus (bascule à chaud)
+    int handed_over;                     // Transmise au nouveau processus (socket conservé)
+    int quickack;                        // Réarmer TCP_QUICKACK après chaque lecture
+    struct client_data *prev_session;    // Sessions ouvertes (clients_mutex)
+    struct client_data *next_session;
+} client_data_t;
 
-    return 1;
-}
+/**
+ * @enum room_mode_t
+ * @brief Déroulement d'une partie en salon
+ */
+typedef enum {
+    ROOM_RACE = 0,                       // Course: chaque tentative est jugée aussitôt
+    ROOM_TOURNAMENT = 1                  // Tournoi: tentatives jugées par lot à la fin du tour
+} room_mode_t;
 
 /**
- * @brief Met à jour les statistiques globales du serveur
- * @param attempts Nombre de tentatives de la partie terminée
+ * @struct room_t
+ * @brief Salon multi-joueurs: cible partagée et diffusion des événements
+ *
+ * En mode tournoi, les soumissions du tour sont rangées en structure de
+ * tableaux pour être comparées à la cible en une seule passe vectorisable.
  */
-void update_stats(int attempts) {
-    pthread_mutex_lock(&global_stats.mutex);
+typedef struct room {
+    char name[MAX_ROOM_NAME];            // Nom du salon
+    int in_use;                          // Salon actif
+    room_mode_t mode;                    // Course ou tournoi
+    const scoring_policy_t *scoring;     // Politique résolue à la création
+    const difficulty_t *level;           // Difficulté choisie par le créateur
+    int64_t target_number;               // Nombre à deviner (partagé)
+    unsigned int round;                  // Numéro de manche
+    time_t round_start;                  // Début de la manche
+    int member_count;                    // Nombre de joueurs
+    client_data_t *members[MAX_ROOM_MEMBERS]; // Joueurs présents
+    unsigned int turn;                   // Tour de soumission (tournoi)
+    int64_t turn_deadline_ms;            // Fin du tour (horloge monotone)
+    int sub_count;                       // Soumissions du tour
+    client_data_t *sub_client[MAX_ROOM_MEMBERS]; // Auteurs des soumissions
+    int32_t sub_guess[MAX_ROOM_MEMBERS]; // Nombres proposés (plage de 32 bits)
+    int64_t sub_guess_wide[MAX_ROOM_MEMBERS]; // Nombres proposés (plage large)
+    int32_t sub_attempts[MAX_ROOM_MEMBERS]; // Tentatives de l'auteur
+    pthread_mutex_t mutex;               // Mutex pour accès concurrent
+} room_t;
 
-    global_stats.total_games++;
-    global_stats.total_attempts += attempts;
-    global_stats.avg_attempts = (float)global_stats.total_attempts / global_stats.total_games;
+/**
+ * @struct parked_session_t
+ * @brief État compact d'une partie interrompue, en attente de reprise
+ */
+typedef struct {
+    uint64_t token;                      // Jeton de reprise (0 = emplacement libre)
+    time_t expires;                      // Date d'expiration de l'emplacement
+    time_t start_time;                   // Heure de début de la partie
+    int64_t target_number;               // Nombre à deviner
+    const difficulty_t *level;           // Difficulté de la partie
+    int attempts;                        // Tentatives déjà effectuées
+    char name[MAX_NAME_LENGTH];          // Nom du joueur
+} parked_session_t;
 
-    if (attempts < global_stats.best_attempts) {
-        global_stats.best_attempts = attempts;
-    }
+/**
+ * @struct resume_table_t
+ * @brief Table de hachage à adressage ouvert des parties suspendues
+ *
+ * L'emplacement est dérivé directement du jeton: la reprise coûte au plus
+ * RESUME_PROBES comparaisons, quel que soit le nombre de parties suspendues.
+ */
+typedef struct {
+    parked_session_t slots[RESUME_SLOTS]; // Emplacements (expirés = libres)
+    pthread_mutex_t mutex;               // Mutex pour accès concurrent
+} resume_table_t;
 
-    pthread_mutex_unlock(&global_stats.mutex);
-}
+/**
+ * @struct stats_t
+ * @brief Statistiques globales du serveur
+ */
+typedef struct {
+    int total_games;                     // Nombre total de parties
+    int total_attempts;                  // Nombre total de tentatives
+    int best_attempts;                   // Meilleur nombre de tentatives
+    float avg_attempts;                  // Moyenne de tentatives
+    time_t server_start_time;            // Timestamp de démarrage
+} stats_t;
 
 /**
- * @brief Calcule le score d'un joueur
- * @param attempts Nombre de tentatives
- * @param duration Durée en secondes
- * @return Score calculé (peut être négatif si trop de tentatives)
- *
- * Formule: Score = 10000 - (tentatives × 100) - temps
+ * @struct spectator_t
+ * @brief Curseur d'un spectateur dans le flux d'événements
  */
-int calculate_score(int attempts, int duration) {
-    int score = INITIAL_SCORE - (attempts * ATTEMPT_PENALTY) - duration;
-    return (score > 0) ? score : 0;
-}
+typedef struct {
+    int fd;                              // Socket du spectateur (non bloquant)
+    uint64_t next_seq;                   // Prochain événement à envoyer
+    payload_t *current;                  // Message en cours d'envoi
+    size_t offset;                       // Octets déjà envoyés de current
+} spectator_t;
 
 /**
- * @brief Ajoute un score au leaderboard avec insertion triée
- * @param name Nom du joueur
- * @param attempts Nombre de tentatives
- * @param duration Durée en secondes
- * @param score Score calculé
+ * @struct spectator_hub_t
+ * @brief Flux d'événements en lecture seule partagé par tous les spectateurs
  *
- * Le leaderboard est trié par score décroissant
+ * Les événements sont sérialisés une fois et conservés dans un anneau; un
+ * seul thread sert tous les spectateurs. Un spectateur trop lent saute
+ * directement au présent après avoir reçu le dernier leaderboard.
  */
-void add_to_leaderboard(const char *name, int attempts, int duration, int score) {
-    pthread_mutex_lock(&leaderboard.mutex);
+typedef struct {
+    payload_t *ring[SPECTATOR_RING];     // Derniers événements publiés
+    uint64_t head;                       // Numéro du prochain événement
+    payload_t *snapshot;                 // Derniers leaderboards (resynchronisation)
+    int pending[MAX_SPECTATORS];         // Sockets en attente de prise en charge
+    int pending_count;                   // Nombre de sockets en attente
+    int count;                           // Spectateurs connectés
+    unsigned long skipped;               // Événements sautés (spectateurs lents)
+    int wake_fd;                         // eventfd de réveil du thread
+    pthread_mutex_t mutex;               // Mutex pour accès concurrent
+} spectator_hub_t;
 
-    // Créer le nouveau score
-    score_t new_score;
-    strncpy(new_score.name, name, MAX_NAME_LENGTH - 1);
-    new_score.name[MAX_NAME_LENGTH - 1] = '\0';
-    new_score.attempts = attempts;
-    new_score.duration = duration;
-    new_score.score = score;
-    new_score.timestamp = time(NULL);
+/**
+ * @struct drain_state_t
+ * @brief Arrêt progressif demandé par SIGINT / SIGTERM
+ *
+ * Plus aucune connexion ni nouvelle partie; les parties en cours ont
+ * jusqu'à l'échéance pour se terminer, puis les journaux sont vidés.
+ */
+typedef struct {
+    int active;                          // Arrêt en cours (publié en release)
+    int64_t started_ms;                  // Début de l'arrêt (horloge monotone)
+    int64_t deadline_ms;                 // Échéance des parties en cours
+    unsigned long finished;              // Sessions terminées d'elles-mêmes pendant l'arrêt
+    unsigned long closed;                // Sessions fermées par l'arrêt
+} drain_state_t;
 
-    // Trouver la position d'insertion (tri par score décroissant)
-    int insert_pos = -1;
-    for (int i = 0; i < leaderboard.count && i < TOP_SCORES; i++) {
-        if (score > leaderboard.scores[i].score) {
-            insert_pos = i;
-            break;
-        }
-    }
+/**
+ * @struct handoff_hello_t
+ * @brief Premier message de la bascule (accompagné du socket d'écoute)
+ */
+typedef struct {
+    uint32_t magic;                      // HANDOFF_MAGIC
+    uint32_t version;                    // HANDOFF_VERSION
+    uint32_t session_size;               // sizeof(handoff_session_t)
+    uint32_t parked_size;                // sizeof(handoff_parked_t)
+    int32_t session_count;               // Sessions transmises (un socket chacune)
+    int32_t parked_count;                // Parties suspendues transmises
+    int32_t next_client_id;              // Dernier identifiant de session attribué
+    int32_t total_served;                // Clients servis depuis le démarrage initial
+    int32_t listener_count;              // Écoutes TCP (la première jointe à ce message)
+    int32_t local_listener;              // 1 = socket Unix de jeu transmis ensuite
+    int32_t websocket_listeners;         // Écoutes WebSocket (bit = index de l'écoute)
+} handoff_hello_t;
 
-    // Si pas dans le top mais il reste de la place
-    if (insert_pos == -1 && leaderboard.count < TOP_SCORES) {
-        insert_pos = leaderboard.count;
-    }
+/**
+ * @struct handoff_session_t
+ * @brief État sérialisé d'une session transmise (accompagné de son socket)
+ */
+typedef struct {
+    int32_t client_id;                   // Identifiant conservé
+    int32_t level;                       // Index dans difficulties
+    int32_t attempts;                    // Tentatives de la partie
+    int32_t playing;                     // 0 = saisie du nom en cours
+    int64_t target_number;               // Nombre à deviner
+    int64_t start_time;                  // Début de la partie (secondes Unix)
+    uint64_t resume_token;               // Jeton de reprise émis
+    uint8_t addr[16];                    // Adresse (IPv4 mappée en IPv6)
+    uint16_t port;                       // Port source (ordre réseau)
+    uint8_t websocket;                   // 1 = session WebSocket (trames)
+    char name[MAX_NAME_LENGTH];          // Nom du joueur (vide avant validation)
+} handoff_session_t;
 
-    // Insérer le score
-    if (insert_pos != -1) {
+/**
+ * @struct handoff_parked_t
+ * @brief Partie suspendue transmise (reprise possible dans le nouveau processus)
+ */
+typedef struct {
+    uint64_t token;                      // Jeton de reprise
+    int64_t start_time;                  // Début de la partie
+    int64_t target_number;               // Nombre à deviner
+    int32_t level;                       // Index dans difficulties
+    int32_t attempts;                    // Tentatives déjà effectuées
+    char name[MAX_NAME_LENGTH];          // Nom du joueur
+} handoff_parked_t;
+
+/**
+ * @struct handoff_entry_t
+ * @brief Session mise en attente par son thread, avec son socket
+ */
+typedef struct {
+    handoff_session_t state;             // État sérialisé
+    int socket;                          // Socket du client (fermé après envoi)
+} handoff_entry_t;
+
+/**
+ * @struct handoff_t
+ * @brief Bascule à chaud vers un nouveau binaire (socket Unix, SCM_RIGHTS)
+ *
+ * L'ancien processus écoute sur handoff_socket; le nouveau (option -u) s'y
+ * connecte et reçoit le socket d'écoute, les sessions solo et les parties
+ * suspendues. Les joueurs ne voient ni coupure ni refus de connexion: le
+ * socket d'écoute n'est jamais fermé.
+ */
+typedef struct {
+    int listener;                        // Socket Unix d'écoute (-1 = désactivé)
+    int requested;                       // Sessions priées de se mettre en attente
+    handoff_entry_t *entries;            // Sessions en attente (ou reçues)
+    int count;                           // Nombre d'entrées
+    int capacity;                        // Capacité de entries
+    unsigned long sent;                  // Sessions transmises au successeur
+    unsigned long adopted;               // Sessions reçues au démarrage
+    pthread_mutex_t mutex;               // Protège entries et count
+} handoff_t;
+
+/**
+ * @struct shared_board_t
+ * @brief Leaderboards et statistiques de parties communs à tous les workers
+ */
+typedef struct {
+    leaderboard_t boards[GAME_MODES][DIFFICULTY_LEVELS]; // Classements par mode et difficulté
+    stats_t stats;                       // Parties, tentatives, démarrage du superviseur
+} shared_board_t;
+
+/**
+ * @struct worker_slot_t
+ * @brief État d'un worker publié pour les autres (écrit par le worker seul)
+ */
+typedef struct {
+    pid_t pid;                           // 0 = arrêté
+    int active;                          // Sessions ouvertes
+    int served;                          // Clients servis depuis son démarrage
+    int64_t started_ms;                  // Démarrage (horloge monotone, superviseur)
+} worker_slot_t;
+
+/**
+ * @struct workers_shared_t
+ * @brief Segment anonyme partagé entre superviseur et workers (créé avant fork)
+ *
+ * Le leaderboard est en double tampon: l'écrivain recopie la copie valide,
+ * y applique son lot puis bascule current. Un worker qui meurt en cours
+ * d'écriture (mutex robuste rendu EOWNERDEAD) laisse donc la copie valide
+ * intacte; seule la table de reprise peut garder un emplacement incomplet.
+ */
+typedef struct {
+    pthread_mutex_t board_mutex;         // Robuste, partagé entre processus
+    uint64_t generation;                 // Incrémenté à chaque mise à jour publiée
+    int current;                         // Copie valide (0 ou 1)
+    shared_board_t copies[2];            // Double tampon du leaderboard
+    resume_table_t resume;               // Parties suspendues, reprises par tout worker
+    worker_slot_t slots[WORKERS_MAX];    // Un emplacement par worker
+    unsigned long respawns;              // Workers relancés après une mort
+} workers_shared_t;
+
+/**
+ * @struct workers_t
+ * @brief Mode multi-processus (clé "workers"): un écouteur SO_REUSEPORT par worker
+ */
+typedef struct {
+    int count;                           // Nombre de workers (1 = processus unique)
+    int index;                           // Index du worker courant
+    workers_shared_t *shared;            // NULL en processus unique
+    uint64_t seen;                       // Génération appliquée (scoreboard_thread)
+} workers_t;
+
+/**
+ * @struct cluster_peer_t
+ * @brief Pair sortant: connexion et deltas en attente d'envoi
+ */
+typedef struct {
+    char host[CONFIG_VALUE_MAX];         // Nom ou adresse
+    char port[8];                        // Port de réplication du pair
+    int socket;                          // -1 = déconnecté
+    int64_t retry_ms;                    // Prochaine tentative de connexion
+    cluster_record_t queue[CLUSTER_QUEUE]; // Deltas en attente
+    unsigned int head;                   // Prochain emplacement libre
+    unsigned int tail;                   // Prochain delta à envoyer
+    int resync;                          // Envoi complet dû (connexion, file débordée)
+    struct sockaddr_in6 addrs[CLUSTER_PEER_ADDRS]; // Dernières adresses résolues
+    int addr_count;                      // Nombre d'adresses (0 = non résolu)
+} cluster_peer_t;
+
+/**
+ * @struct cluster_inbound_t
+ * @brief Connexion entrante d'un pair (enregistrement partiel en cours)
+ */
+typedef struct {
+    int socket;                          // -1 = libre
+    cluster_record_t pending;            // Enregistrement en cours de réception
+    size_t filled;                       // Octets déjà reçus de pending
+    int authenticated;                   // Présentation valide reçue
+    int64_t deadline_ms;                 // Fermeture sans présentation valide
+    uint8_t nonce[CLUSTER_NONCE];        // Défi envoyé à l'acceptation
+} cluster_inbound_t;
+
+/**
+ * @struct cluster_node_t
+ * @brief Derniers compteurs connus d'un autre nœud
+ */
+typedef struct {
+    uint32_t node;                       // Identifiant du nœud
+    int64_t version_us;                  // Version (date de l'envoi à l'origine)
+    int64_t games;                       // Parties terminées
+    int64_t attempts;                    // Tentatives
+    int best;                            // Meilleur nombre de tentatives (0 = aucun)
+} cluster_node_t;
+
+/**
+ * @struct cluster_t
+ * @brief Réplication du leaderboard entre nœuds (bavardage par deltas sur TCP)
+ *
+ * Chaque entrée d'un top-K porte un identifiant unique; un nœud n'envoie
+ * que les entrées qui viennent d'entrer dans son top-K (les siennes ou
+ * celles reçues), et les relaie au plus CLUSTER_MAX_HOPS fois. L'ordre
+ * total (score, date, identifiant) et l'élimination des doublons font
+ * converger tous les nœuds vers le même top-K: top-K(A ∪ B) ne dépend que
+ * de top-K(A) et top-K(B). Un envoi complet (au plus K entrées par
+ * leaderboard) remplace les deltas à la connexion ou si la file déborde.
+ * Un pair entrant doit venir d'une adresse de cluster_peers et répondre
+ * au défi avec le secret partagé avant tout enregistrement.
+ */
+typedef struct {
+    int enabled;                         // Clé cluster_port non nulle
+    uint32_t node;                       // Identifiant de ce nœud (clé cluster_node)
+    uint64_t next_origin;                // Prochain identifiant: nœud (16 bits), worker (6), ms
+    int listener;                        // Écoute des pairs
+    int wake_fd;                         // eventfd: deltas à envoyer
+    cluster_peer_t peers[CLUSTER_PEERS_MAX]; // Pairs sortants
+    int peer_count;                      // Nombre de pairs
+    cluster_inbound_t inbound[CLUSTER_INBOUND_MAX]; // Pairs entrants
+    cluster_node_t nodes[CLUSTER_NODES_MAX]; // Compteurs des autres nœuds
+    int node_count;                      // Nombre de nœuds connus
+    int peers_up;                        // Pairs sortants connectés
+    int64_t stats_sent_games;            // Parties locales au dernier envoi des compteurs
+    pthread_mutex_t mutex;               // Files des pairs et table des nœuds
+    unsigned long records_sent;          // Enregistrements envoyés
+    unsigned long bytes_sent;            // Octets envoyés
+    unsigned long bytes_received;        // Octets reçus
+    unsigned long full_syncs;            // Envois complets
+    unsigned long remote_applied;        // Entrées distantes entrées dans un top-K
+    int64_t convergence_total_us;        // Somme des délais victoire → top-K local
+    int64_t convergence_max_us;          // Pire délai
+} cluster_t;
+
+/**
+ * @enum standby_type_t
+ * @brief Nature d'un enregistrement du journal envoyé à la réplique
+ */
+typedef enum {
+    STANDBY_GAME = 1,                    // Entrée appliquée par le propriétaire
+    STANDBY_PARK = 2,                    // Partie suspendue
+    STANDBY_CLAIM = 3,                   // Partie suspendue reprise (parked.token)
+    STANDBY_HEARTBEAT = 4                // Aucun changement (mesure du retard)
+} standby_type_t;
+
+/**
+ * @struct standby_record_t
+ * @brief Enregistrement du journal de réplication, dans l'ordre d'application
+ */
+typedef struct {
+    uint32_t type;                       // standby_type_t
+    int32_t mode;                        // Partie: mode de jeu
+    int32_t level;                       // Partie: difficulté
+    int32_t counted;                     // Partie: 1 = compte dans les statistiques
+    uint64_t seq;                        // Numéro dans le journal du primaire
+    int64_t time_us;                     // Date d'ajout chez le primaire (horloge murale)
+    score_t entry;                       // Partie: entrée (avec son identifiant)
+    handoff_parked_t parked;             // Partie suspendue
+} standby_record_t;
+
+/**
+ * @struct standby_state_t
+ * @brief État complet capturé par le propriétaire (envoyé à la connexion)
+ */
+typedef struct {
+    leaderboard_t boards[GAME_MODES][DIFFICULTY_LEVELS]; // Leaderboards (identifiants compris)
+    stats_t stats;                       // Statistiques de parties
+} standby_state_t;
+
+/**
+ * @struct standby_hello_t
+ * @brief Premier message du primaire, suivi de l'état et des parties suspendues
+ */
+typedef struct {
+    uint32_t magic;                      // STANDBY_MAGIC
+    uint32_t version;                    // STANDBY_VERSION
+    uint32_t record_size;                // sizeof(standby_record_t)
+    uint32_t state_size;                 // sizeof(standby_state_t)
+    int32_t parked_count;                // Parties suspendues transmises
+    int32_t reserved;                    // Zéro
+} standby_hello_t;
+
+/**
+ * @struct standby_ack_t
+ * @brief Accusé de la réplique après chaque message appliqué
+ */
+typedef struct {
+    uint64_t seq;                        // Dernier enregistrement appliqué
+    int64_t lag_us;                      // Ajout chez le primaire → application
+} standby_ack_t;
+
+/**
+ * @struct standby_t
+ * @brief Réplique de secours alimentée par le journal des changements
+ *
+ * Le primaire écoute sur standby_socket; la réplique (option -r) reçoit
+ * un état complet capturé par le propriétaire du leaderboard, puis chaque
+ * changement appliqué depuis: parties (dans l'ordre du propriétaire),
+ * parties suspendues et reprises. Quand le primaire disparaît, la réplique
+ * a déjà tout en mémoire: elle n'a qu'à ouvrir le port.
+ */
+typedef struct {
+    int listener;                        // Primaire: écoute de la réplique
+    int active;                          // Primaire: une réplique suit le journal
+    int resync;                          // Primaire: état complet à renvoyer (échange admin)
+    standby_record_t ring[STANDBY_RING]; // Primaire: journal en attente d'envoi
+    uint64_t head;                       // Primaire: prochain numéro d'enregistrement
+    standby_state_t *capture;            // Primaire: état à remplir à la barrière
+    uint64_t capture_seq;                // Primaire: journal inclus dans l'état capturé
+    pthread_mutex_t mutex;               // Primaire: journal et capture
+    pthread_cond_t cond;                 // Primaire: nouvel enregistrement
+    unsigned long shipped;               // Primaire: enregistrements envoyés
+    unsigned long resyncs;               // Primaire: états complets envoyés
+    uint64_t acked;                      // Primaire: dernier numéro accusé
+    int64_t lag_us;                      // Primaire: dernier retard accusé
+    int64_t lag_max_us;                  // Primaire: pire retard accusé
+    unsigned long replayed;              // Réplique: enregistrements appliqués
+    int64_t lost_ms;                     // Réplique: fin du flux (horloge monotone)
+    int64_t recovery_ms;                 // Réplique promue: fin du flux → service
+} standby_t;
+
+/**
+ * @struct listener_t
+ * @brief Adresse d'écoute TCP (clé "bind"), acceptée par la boucle principale
+ */
+typedef struct {
+    int fd;                              // Socket d'écoute non bloquant (-1 = fermé)
+    struct sockaddr_storage addr;        // Adresse liée
+    int dual_stack;                      // 1 = IPv6 et IPv4 (mappée) sur le même socket
+    int websocket;                       // 1 = écoute WebSocket (clé "ws_port")
+} listener_t;
+
+/**
+ * @enum websocket_state_t
+ * @brief État WebSocket d'un socket client
+ */
+typedef enum {
+    WEBSOCKET_NONE = 0,                  // TCP ou Unix: lignes brutes
+    WEBSOCKET_HANDSHAKE = 1,             // Accepté, poignée de main HTTP à faire
+    WEBSOCKET_OPEN = 2,                  // Trames dans les deux sens
+    WEBSOCKET_CLOSED = 3                 // Trame de fermeture échangée
+} websocket_state_t;
+
+/**
+ * @enum websocket_opcode_t
+ * @brief Types de trame (RFC 6455)
+ */
+typedef enum {
+    WEBSOCKET_CONTINUATION = 0x0,
+    WEBSOCKET_TEXT = 0x1,
+    WEBSOCKET_BINARY = 0x2,
+    WEBSOCKET_CLOSE = 0x8,
+    WEBSOCKET_PING = 0x9,
+    WEBSOCKET_PONG = 0xA
+} websocket_opcode_t;
+
+/**
+ * @struct websocket_table_t
+ * @brief État WebSocket de chaque socket client, indexé par descripteur
+ *
+ * Les fonctions d'envoi ne reçoivent qu'un socket: la table leur dit s'il
+ * faut encadrer le message, sans toucher à leurs appelants.
+ */
+typedef struct {
+    uint8_t *state;                      // websocket_state_t par descripteur
+    int size;                            // Descripteurs couverts
+    unsigned long sessions;              // Poignées de main réussies
+    unsigned long rejected;              // Poignées de main refusées
+} websocket_table_t;
+
+/* ============================================================================
+ * VARIABLES GLOBALES
+ * ============================================================================ */
+static listener_t listeners[LISTENERS_MAX];                 // Écoutes TCP (clé "bind")
+static int listener_count = 0;                              // Écoutes ouvertes
+static int local_socket = -1;                               // Socket Unix de jeu (clé unix_socket)
+static int admin_listener = -1;                             // Socket d'administration (clé admin_socket)
+static websocket_table_t websockets;                        // État WebSocket des sockets clients
+static int active_clients = 0;                              // Clients connectés
+static int total_clients_served = 0;                        // Total clients
+static client_data_t *sessions = NULL;                      // Sessions ouvertes (clients_mutex)
+static drain_state_t drain;                                 // Arrêt progressif
+static handoff_t handoff = {.listener = -1, .mutex = PTHREAD_MUTEX_INITIALIZER};
+static workers_t workers = {.count = 1};                    // Mode multi-processus
+static cluster_t cluster = {.listener = -1, .wake_fd = -1, .mutex = PTHREAD_MUTEX_INITIALIZER};
+static standby_t standby = {.listener = -1, .mutex = PTHREAD_MUTEX_INITIALIZER,
+                            .cond = PTHREAD_COND_INITIALIZER};
+static pthread_mutex_t clients_mutex = PTHREAD_MUTEX_INITIALIZER;
+static stats_t global_stats = {0, 0, 999999, 0.0, 0};     // Propriété de scoreboard_thread
+static leaderboard_t leaderboards[GAME_MODES][DIFFICULTY_LEVELS]; // Propriété de scoreboard_thread
+#define DIFFICULTY_ENTRY(id, min, max) \
+    {#id, min, max, PRAD_RANGE_BITS(min, max), (min) < INT32_MIN || (max) > INT32_MAX},
+static const difficulty_t difficulties[DIFFICULTY_LEVELS] = {
+    PRAD_DIFFICULTIES(DIFFICULTY_ENTRY)
+};                                                          // Niveaux (prad_scoring.h)
+#undef DIFFICULTY_ENTRY
+static const scoring_policy_t *scoring_by_mode[GAME_MODES]; // Résolue au démarrage
+static scoreboard_actor_t scoreboard = {
+    .wake_fd = -1, .reclaim_mutex = PTHREAD_MUTEX_INITIALIZER,
+    .ticket_mutex = PTHREAD_MUTEX_INITIALIZER, .ticket_cond = PTHREAD_COND_INITIALIZER
+};
+static __thread int hazard_hint = -1;                       // Dernier emplacement du thread
+static prad_shm_board_t *shm_board = NULL;                  // Segment exporté (NULL = désactivé)
+static event_log_t event_log = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER
+};
+static export_queue_t export_queue = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER, .cond = PTHREAD_COND_INITIALIZER
+};
+static resume_table_t local_resume_table = {.mutex = PTHREAD_MUTEX_INITIALIZER};
+static resume_table_t *resume_table = &local_resume_table;  // Partagée entre workers
+static uint64_t random_state = 0;                           // État du générateur
+static room_t rooms[MAX_ROOMS];                             // Salons multi-joueurs
+static pthread_mutex_t rooms_mutex = PTHREAD_MUTEX_INITIALIZER;
+static spectator_hub_t spectator_hub = {.wake_fd = -1, .mutex = PTHREAD_MUTEX_INITIALIZER};
+static ip_shard_t ip_table[IP_SHARDS];                      // Table des adresses sources
+static int ip_shard_slots = IP_PROBE_SLOTS;                 // Emplacements par fragment
+static unsigned long ip_rejected = 0;                       // Connexions refusées par IP
+static unsigned long ip_untracked = 0;                      // Connexions admises sans suivi
+static unsigned long rate_limited = 0;                      // Requêtes refusées (débit)
+static int moves_in_flight = 0;                             // Coups de jeu en traitement
+static read_snapshot_t read_snapshot = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER, .build_mutex = PTHREAD_MUTEX_INITIALIZER
+};
+static load_monitor_t load_monitor;
+static const server_config_t config_defaults = {
+    .port = PORT, .max_clients = MAX_CLIENTS, .max_per_ip = MAX_CONNECTIONS_PER_IP,
+    .guess_rate = GUESS_RATE, .guess_burst = GUESS_BURST,
+    .stats_rate = STATS_RATE, .stats_burst = STATS_BURST,
+    .resume_ttl = RESUME_TTL, .round_window_ms = ROUND_WINDOW_MS,
+    .shed_ms = {20, 50, 150}, .log_level = LOG_INFO, .drain_timeout = DRAIN_TIMEOUT,
+    .workers = 1, .tcp_nodelay = 1, .cluster_bind = "127.0.0.1"
+};                                                          // Valeurs sans configuration
+static server_config_t config;                              // En vigueur (voir CONFIG_GET)
+#define CONFIG_GET(field) __atomic_load_n(&config.field, __ATOMIC_RELAXED)
+static const char *config_path = NULL;                      // Fichier (-c), NULL = aucun
+static const char *config_overrides[CONFIG_OVERRIDES][2];   // {clé, valeur} des options -p / -o
+static int config_override_count = 0;
+static unsigned long config_reloads = 0;                    // Rechargements appliqués
+
+/* ============================================================================
+ * PROTOTYPES DES FONCTIONS
+ * ============================================================================ */
+void server_exit(int status);
+void log_message(const char *level, const char *message);
+int send_message(int socket, const char *message);
+int send_buffer(int socket, const char *data, size_t len);
+int receive_message(int socket, char *buffer, int size);
+int validate_name(const char *name);
+int parse_resume_command(const char *buffer, uint64_t *token);
+void stats_account(int attempts);
+#define SCORING_PROTOTYPE(id, initial, per_attempt, per_second, scaled) \
+    int score_##id(int attempts, int duration, int bits);
+PRAD_SCORING_POLICIES(SCORING_PROTOTYPE)
+#undef SCORING_PROTOTYPE
+int parse_scoring(const char *spec, int policies[GAME_MODES]);
+int configure_scoring(const char *spec);
+game_mode_t client_game_mode(const client_data_t *client);
+const scoring_policy_t *client_scoring(const client_data_t *client);
+const difficulty_t *client_difficulty(const client_data_t *client);
+const difficulty_t *find_difficulty(const char *name);
+int parse_guess(const char *text, const difficulty_t *level, int64_t *guess);
+int64_t random_target(const difficulty_t *level);
+int score_ranks_before(const score_t *a, const score_t *b);
+int leaderboard_insert(leaderboard_t *board, const score_t *entry);
+int64_t monotonic_us(void);
+int64_t realtime_us(void);
+void scoreboard_push(score_event_t *first, score_event_t *last);
+void scoreboard_wait(score_ticket_t *ticket);
+void post_game_records(const game_record_t *records, int count, score_ticket_t *ticket);
+int record_game(const char *name, game_mode_t mode, int level, int attempts, int duration,
+                int score, int wait);
+int board_validate(const prad_board_file_t *board, char *error, size_t size);
+int board_load_file(const char *path, prad_board_file_t *board, char *error, size_t size);
+int board_swap(const char *path, char *error, size_t size);
+void board_replace(const prad_board_file_t *board);
+void board_dump(prad_board_file_t *board);
+void scoreboard_barrier(prad_board_file_t *dump);
+int is_loopback(const struct sockaddr_in6 *addr);
+board_snapshot_t *board_acquire(int *slot);
+void board_release(int slot, board_snapshot_t *board);
+void board_reclaim(void);
+void board_publish(void);
+void *scoreboard_thread(void *arg);
+int shm_export_init(void);
+void shm_export_board(const board_snapshot_t *board);
+prad_events_segment_t *event_segment_map(const char *dir, uint64_t base_seq);
+int event_log_open(const char *dir);
+void event_log_append(prad_event_type_t type, const client_data_t *client, int64_t value,
+                      int attempts, int duration, int score);
+void *event_log_thread(void *arg);
+int event_log_close(void);
+void export_enqueue_batch(const score_event_t *batch);
+int export_close(void);
+#ifdef PRAD_WITH_SQLITE
+sqlite3 *export_open(const char *path);
+void *export_thread(void *arg);
+#endif
+void seed_random(void);
+uint64_t next_random(void);
+uint64_t issue_resume_token(void);
+void park_session(const client_data_t *client);
+int claim_parked_session(uint64_t token, client_data_t *client);
+payload_t *payload_printf(const char *format, ...);
+payload_t *payload_create(const char *data, size_t len);
+payload_t *payload_ref(payload_t *payload);
+void payload_release(payload_t *payload);
+int outbox_init(outbox_t *outbox);
+void outbox_destroy(outbox_t *outbox);
+void outbox_push(client_data_t *client, payload_t *payload);
+int outbox_flush(client_data_t *client);
+int wait_message(client_data_t *client, char *buffer, int size);
+int validate_room_name(const char *name);
+room_t *room_join(client_data_t *client, const char *name, room_mode_t mode);
+void room_move_submission(room_t *room, int from, int to);
+void room_leave(client_data_t *client);
+void room_broadcast(room_t *room, payload_t *payload, const client_data_t *except);
+int room_guess(client_data_t *client, int64_t guess, int *duration, int *score);
+int64_t monotonic_ms(void);
+int64_t room_submit(client_data_t *client, int64_t guess, unsigned int *turn);
+int resolve_turn_locked(room_t *room, game_record_t *winners);
+void *tournament_thread(void *arg);
+void spectator_publish(payload_t *payload);
+void spectator_publish_leaderboard(unsigned int boards);
+void announce_victory(const char *room, const char *player, int64_t number, int attempts,
+                      int duration, int score);
+int spectator_attach(int socket);
+void *spectator_thread(void *arg);
+uint64_t ip_key(const struct sockaddr_in6 *addr);
+int ip_table_init(int max_clients);
+int ip_acquire(const struct sockaddr_in6 *addr, ip_entry_t **entry);
+void ip_release(ip_entry_t *entry);
+int ip_consume(ip_entry_t *entry, bucket_kind_t kind);
+int proxy_header_apply(client_data_t *client, const char *line);
+int proxy_header_peek(client_data_t *client);
+payload_t *acquire_read_snapshot(game_mode_t mode, int level);
+void invalidate_read_snapshot(void);
+void send_read_snapshot(int socket, game_mode_t mode, int level);
+int parse_shed_thresholds(const char *spec, int *thresholds);
+int current_shed_level(void);
+void *lag_monitor_thread(void *arg);
+void send_json_overloaded(int socket, int retry_after);
+int log_enabled(const char *level);
+const config_key_t *config_find(const char *name);
+int config_set(server_config_t *target, const char *name, const char *value,
+               char *error, size_t size);
+void config_format(const server_config_t *source, const config_key_t *key, char *out,
+                   size_t size);
+char *trim_spaces(char *text);
+int config_load_file(const char *path, server_config_t *target, char *error, size_t size);
+int config_build(server_config_t *target, char *error, size_t size);
+int config_apply(const server_config_t *next, int startup);
+void config_reload(void);
+void usage(const char *program);
+int drain_active(void);
+void drain_start(const char *reason);
+void drain_wait(void);
+void *signal_thread(void *arg);
+int local_listen(const char *path, int type, mode_t mode, int backlog);
+int handoff_listen(const char *path);
+int handoff_send(int channel, const void *data, size_t len, int fd);
+int handoff_recv(int channel, void *data, size_t len, int *fd);
+int handoff_collect(client_data_t *client);
+void parked_serialize(const parked_session_t *slot, handoff_parked_t *entry);
+int parked_collect(handoff_parked_t *parked);
+int session_adopt(const handoff_session_t *state, int socket);
+int handoff_serve(int next_client_id);
+int handoff_receive(const char *path, int *next_client_id);
+int shared_lock(pthread_mutex_t *mutex);
+int workers_init(int count);
+void board_share_pull(void);
+void board_share_push(void);
+int board_share_refresh(void);
+void worker_account(void);
+int workers_start(void);
+int cluster_parse_peers(const char *spec);
+struct addrinfo *cluster_resolve(cluster_peer_t *peer);
+int cluster_peer_allowed(const struct sockaddr_in6 *addr);
+int cluster_init(void);
+void cluster_enqueue(const cluster_record_t *record);
+void cluster_share(const score_t *entry, game_mode_t mode, int level, int64_t origin_us,
+                   int hops);
+int cluster_apply(const cluster_record_t *record);
+void cluster_stats_record(cluster_record_t *record);
+int cluster_full_sync(cluster_peer_t *peer);
+int cluster_send(cluster_peer_t *peer, const cluster_record_t *records, int count);
+int cluster_handshake(int fd);
+void cluster_connect(cluster_peer_t *peer);
+void cluster_accept(void);
+int cluster_hello_valid(const cluster_inbound_t *inbound, const cluster_record_t *record);
+void cluster_receive(cluster_inbound_t *inbound);
+void cluster_handle(const cluster_record_t *record);
+void *cluster_thread(void *arg);
+void standby_append(standby_record_t *record);
+void standby_ship_game(const score_t *entry, game_mode_t mode, int level, int counted);
+void standby_ship_parked(standby_type_t type, const handoff_parked_t *parked);
+void standby_capture(void);
+int standby_serve(int channel);
+void *standby_thread(void *arg);
+void standby_apply(const standby_record_t *record);
+int standby_stopping(void);
+int standby_follow(const char *path);
+int bind_parse(const char *spec, int port, listener_t *out, int max);
+int server_listen(void);
+void listeners_close(void);
+int local_game_listen(void);
+int admin_listen(void);
+void admin_command(int channel, char *line);
+void admin_serve(int channel);
+void *admin_thread(void *arg);
+void address_normalize(const struct sockaddr *addr, struct sockaddr_in6 *out);
+char *format_address(const struct sockaddr *addr, char *out, size_t size);
+void accept_client(int listener, int websocket, int *client_counter);
+void socket_option(int fd, int level, int option, int value, const char *key);
+void listener_tune(int fd);
+void connection_tune(int fd);
+int websocket_init(void);
+int websocket_state(int socket);
+void websocket_set(int socket, int state);
+void sha1_digest(const uint8_t *data, size_t len, uint8_t digest[20]);
+void hmac_sha1(const char *key, const uint8_t *data, size_t len, uint8_t mac[20]);
+size_t base64_encode(const uint8_t *data, size_t len, char *out);
+int http_header(const char *request, const char *name, char *value, size_t size);
+int websocket_refuse(int socket, const char *status, const char *headers);
+int websocket_handshake(int socket);
+void websocket_unmask(uint8_t *data, size_t len, const uint8_t mask[4]);
+int websocket_frame(int socket, int opcode, const void *data, size_t len);
+int websocket_send(int socket, const char *data, size_t len);
+void websocket_close(int socket, int code);
+int websocket_read(int socket, struct iovec *iov, int count, int64_t deadline);
+int websocket_receive(int socket, char *buffer, int size);
+void display_server_stats(int socket);
+void display_leaderboard(int socket, game_mode_t mode, int level);
+size_t format_json_stats(char *json, size_t size);
+size_t format_json_metrics(char *json, size_t size);
+void send_json_stats(int socket);
+size_t format_json_leaderboard(char *json, size_t size, game_mode_t mode, int level);
+void send_json_leaderboard(int socket, game_mode_t mode, int level);
+void send_json_prompt(int socket, const char *message);
+void send_json_name_accepted(int socket, const char *name);
+void send_json_game_start(int socket, const char *player, const difficulty_t *level,
+                          uint64_t token);
+void send_json_resumed(int socket, const client_data_t *client);
+void send_json_room_joined(int socket, room_t *room);
+void send_json_hint(int socket, const char *direction, int attempts);
+void send_json_victory(int socket, const char *player, int64_t number, int attempts, int duration, int score);
+void send_json_error(int socket, const char *message);
+void send_json_bye(int socket, const char *message);
+void start_solo_game(client_data_t *client);
+void *handle_client(void *arg);
+
+/* ============================================================================
+ * IMPLÉMENTATION DES FONCTIONS
+ * ============================================================================ */
+
+/**
+ * @brief Termine le processus une fois l'arrêt effectué (voir drain_wait)
+ * @param status EXIT_SUCCESS après un arrêt complet, EXIT_FAILURE si écourté
+ *
+ * Appelée hors de tout gestionnaire de signal: les signaux d'arrêt sont
+ * reçus par signal_thread.
+ */
+void server_exit(int status) {
+    listeners_close();
+    if (local_socket >= 0) {
+        close(local_socket);
+    }
+    if (shm_board) {
+        shm_unlink(PRAD_SHM_NAME);
+    }
+
+    if (status == EXIT_SUCCESS) {
+        printf("\n✅ Serveur arrêté proprement\n\n");
+    } else {
+        printf("\n⚠️  Serveur arrêté sans attendre les parties en cours\n\n");
+    }
+    fflush(stdout);
+    exit(status);
+}
+
+/**
+ * @brief Affiche un message de log avec timestamp et niveau
+ * @param level Niveau du log (INFO, SUCCESS, WARNING, ERROR)
+ * @param message Message à afficher
+ */
+void log_message(const char *level, const char *message) {
+    if (!log_enabled(level)) {
+        return;
+    }
+
+    time_t now = time(NULL);
+    char timestamp[20];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+
+    // Couleurs ANSI selon le niveau
+    const char *color = "\033[0m";
+    if (strcmp(level, "SUCCESS") == 0) color = "\033[32m";      // Vert
+    else if (strcmp(level, "ERROR") == 0) color = "\033[31m";   // Rouge
+    else if (strcmp(level, "WARNING") == 0) color = "\033[33m"; // Jaune
+    else if (strcmp(level, "INFO") == 0) color = "\033[36m";    // Cyan
+
+    printf("%s[%s] [%-8s]\033[0m %s\n", color, timestamp, level, message);
+}
+
+/**
+ * @brief Envoie un message au client via socket
+ * @param socket Socket du client
+ * @param message Message à envoyer
+ * @return 0 si succès, -1 si erreur
+ */
+int send_message(int socket, const char *message) {
+    return send_buffer(socket, message, strlen(message));
+}
+
+/**
+ * @brief Envoie des données au client, en trame si c'est un client WebSocket
+ * @param socket Socket du client
+ * @param data Une ou plusieurs lignes JSON
+ * @param len Longueur
+ * @return 0 si succès, -1 si erreur
+ */
+int send_buffer(int socket, const char *data, size_t len) {
+    if (websocket_state(socket) != WEBSOCKET_NONE) {
+        return websocket_send(socket, data, len);
+    }
+    ssize_t sent = send(socket, data, len, MSG_NOSIGNAL);
+    return (sent == (ssize_t)len) ? 0 : -1;
+}
+
+/**
+ * @brief Reçoit un message du client avec nettoyage des retours à la ligne
+ * @param socket Socket du client
+ * @param buffer Buffer de réception
+ * @param size Taille du buffer
+ * @return Nombre d'octets reçus, -1 si erreur (0: trame de contrôle WebSocket seule)
+ */
+int receive_message(int socket, char *buffer, int size) {
+    if (websocket_state(socket) == WEBSOCKET_OPEN) {
+        return websocket_receive(socket, buffer, size);
+    }
+
+    memset(buffer, 0, size);
+    ssize_t bytes_received = recv(socket, buffer, size - 1, 0);
+
+    if (bytes_received <= 0) {
+        return -1;
+    }
+
+    // Nettoyer les retours à la ligne
+    buffer[strcspn(buffer, "\r\n")] = '\0';
+
+    return bytes_received;
+}
+
+/**
+ * @brief Valide le nom du joueur selon les règles strictes
+ * @param name Nom à valider
+ * @return 1 si valide, 0 sinon
+ *
+ * Règles de validation:
+ * - Longueur: 3 à 10 caractères
+ * - Uniquement des lettres (a-z, A-Z)
+ * - Pas de chiffres, espaces ou caractères spéciaux
+ */
+int validate_name(const char *name) {
+    if (!name || name[0] == '\0') {
+        return 0;
+    }
+
+    size_t len = strlen(name);
+
+    // Vérifier la longueur
+    if (len < MIN_NAME_LENGTH || len >= MAX_NAME_LENGTH) {
+        return 0;
+    }
+
+    // Vérifier que ce sont uniquement des lettres
+    for (size_t i = 0; i < len; i++) {
+        if (!isalpha((unsigned char)name[i])) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Reconnaît la commande de reprise "resume <jeton>"
+ * @param buffer Ligne reçue du client
+ * @param token Jeton extrait (hexadécimal sur 64 bits)
+ * @return 1 si la ligne est une commande de reprise, 0 sinon
+ */
+int parse_resume_command(const char *buffer, uint64_t *token) {
+    if (strncasecmp(buffer, "resume ", 7) != 0) {
+        return 0;
+    }
+
+    char *endptr;
+    errno = 0;
+    unsigned long long value = strtoull(buffer + 7, &endptr, 16);
+    *token = (errno == 0 && endptr != buffer + 7) ? (uint64_t)value : 0;
+    return 1;
+}
+
+/**
+ * @brief Comptabilise une partie terminée (thread propriétaire uniquement)
+ * @param attempts Nombre de tentatives de la partie terminée
+ */
+void stats_account(int attempts) {
+    global_stats.total_games++;
+    global_stats.total_attempts += attempts;
+    global_stats.avg_attempts = (float)global_stats.total_attempts / global_stats.total_games;
+
+    if (attempts < global_stats.best_attempts) {
+        global_stats.best_attempts = attempts;
+    }
+}
+
+/**
+ * @brief Ordre total des entrées d'un leaderboard
+ * @param a Entrée
+ * @param b Entrée
+ * @return 1 si a se classe avant b (score décroissant, puis plus ancienne,
+ *         puis plus petit identifiant): identique sur tous les nœuds
+ */
+int score_ranks_before(const score_t *a, const score_t *b) {
+    if (a->score != b->score) {
+        return a->score > b->score;
+    }
+    if (a->timestamp != b->timestamp) {
+        return a->timestamp < b->timestamp;
+    }
+    return a->origin < b->origin;
+}
+
+/**
+ * @brief Insère un score dans un leaderboard (thread propriétaire uniquement)
+ * @param board Leaderboard du mode de la partie
+ * @param entry Score (nom, tentatives, durée, score, date, identifiant)
+ * @return 1 si le score entre dans le leaderboard, 0 sinon (ou déjà présent)
+ *
+ * Le leaderboard est trié par score_ranks_before. Une entrée de même
+ * identifiant n'est écartée que si c'est la même partie: un identifiant
+ * réutilisé par une autre partie est signalé, et la partie gardée.
+ */
+int leaderboard_insert(leaderboard_t *board, const score_t *entry) {
+    // Entrée déjà reçue (relais d'un autre nœud, leaderboard d'un autre worker)
+    for (int i = 0; i < board->count && entry->origin; i++) {
+        const score_t *known = &board->scores[i];
+        if (known->origin != entry->origin) {
+            continue;
+        }
+        if (known->score == entry->score && known->attempts == entry->attempts &&
+            known->timestamp == entry->timestamp &&
+            strncmp(known->name, entry->name, MAX_NAME_LENGTH) == 0) {
+            return 0;
+        }
+        char log[96];
+        snprintf(log, sizeof(log), "Leaderboard: identifiant %llu porté par deux parties",
+                 (unsigned long long)entry->origin);
+        log_message("WARNING", log);
+        break;
+    }
+
+    // Trouver la position d'insertion
+    int insert_pos = -1;
+    for (int i = 0; i < board->count && i < TOP_SCORES; i++) {
+        if (score_ranks_before(entry, &board->scores[i])) {
+            insert_pos = i;
+            break;
+        }
+    }
+
+    // Si pas dans le top mais il reste de la place
+    if (insert_pos == -1 && board->count < TOP_SCORES) {
+        insert_pos = board->count;
+    }
+
+    // Insérer le score
+    if (insert_pos != -1) {
         // Décaler les scores inférieurs
-        int end_pos = (leaderboard.count < TOP_SCORES) ? leaderboard.count : TOP_SCORES - 1;
+        int end_pos = (board->count < TOP_SCORES) ? board->count : TOP_SCORES - 1;
         for (int i = end_pos; i > insert_pos; i--) {
-            leaderboard.scores[i] = leaderboard.scores[i - 1];
+            board->scores[i] = board->scores[i - 1];
+        }
+
+        board->scores[insert_pos] = *entry;
+
+        if (board->count < TOP_SCORES) {
+            board->count++;
+        }
+    }
+
+    return insert_pos != -1;
+}
+
+/* ============================================================================
+ * POLITIQUES DE SCORE (VOIR prad_scoring.h)
+ * ============================================================================ */
+
+/**
+ * Une fonction score_<politique>(tentatives, durée, plage) par ligne de
+ * PRAD_SCORING_POLICIES: les paramètres sont des constantes, la formule
+ * commune est repliée par le compilateur pour chaque politique.
+ */
+#define SCORING_FUNCTION(id, initial, per_attempt, per_second, scaled)      \
+    int score_##id(int attempts, int duration, int span) {                  \
+        return prad_score_formula(attempts, duration, span, initial,        \
+                                  per_attempt, per_second, scaled);         \
+    }
+PRAD_SCORING_POLICIES(SCORING_FUNCTION)
+#undef SCORING_FUNCTION
+
+#define SCORING_ENTRY(id, initial, per_attempt, per_second, scaled) \
+    {#id, score_##id, {initial, per_attempt, per_second, scaled}},
+static const scoring_policy_t scoring_policies[] = {
+    PRAD_SCORING_POLICIES(SCORING_ENTRY)
+};
+#undef SCORING_ENTRY
+
+#define SCORING_POLICY_COUNT (int)(sizeof(scoring_policies) / sizeof(scoring_policies[0]))
+
+/**
+ * @brief Lit une affectation "mode=politique,..." à partir des défauts
+ * @param spec Affectation (NULL ou vide = défauts)
+ * @param policies Index de politique par mode (sortie)
+ * @return 0 si valide, -1 sinon (policies = défauts)
+ */
+int parse_scoring(const char *spec, int policies[GAME_MODES]) {
+    const char *names[SCORING_POLICY_COUNT];
+
+    for (int i = 0; i < SCORING_POLICY_COUNT; i++) {
+        names[i] = scoring_policies[i].name;
+    }
+
+    memset(policies, 0, GAME_MODES * sizeof(int));
+    prad_scoring_parse(PRAD_SCORING_DEFAULT, names, SCORING_POLICY_COUNT, policies);
+    if (spec && prad_scoring_parse(spec, names, SCORING_POLICY_COUNT, policies) < 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Résout la politique de chaque mode (au démarrage)
+ * @param spec Affectation "mode=politique,..." (NULL = défauts)
+ * @return 0 si valide, -1 sinon (défauts appliqués)
+ */
+int configure_scoring(const char *spec) {
+    int policies[GAME_MODES];
+    int status = parse_scoring(spec, policies);
+
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        scoring_by_mode[mode] = &scoring_policies[policies[mode]];
+    }
+    return status;
+}
+
+/**
+ * @brief Mode de jeu courant d'une session
+ * @param client Session
+ * @return Mode (solo hors salon)
+ */
+game_mode_t client_game_mode(const client_data_t *client) {
+    if (!client->room) {
+        return GAME_SOLO;
+    }
+    return (client->room->mode == ROOM_TOURNAMENT) ? GAME_TOURNAMENT : GAME_RACE;
+}
+
+/**
+ * @brief Politique de score de la partie en cours d'une session
+ * @param client Session
+ * @return Politique du salon, sinon celle du mode solo
+ */
+const scoring_policy_t *client_scoring(const client_data_t *client) {
+    return client->room ? client->room->scoring : scoring_by_mode[GAME_SOLO];
+}
+
+/**
+ * @brief Difficulté de la partie en cours d'une session
+ * @param client Session
+ * @return Difficulté du salon, sinon celle choisie pour le solo
+ */
+const difficulty_t *client_difficulty(const client_data_t *client) {
+    return client->room ? client->room->level : client->level;
+}
+
+/**
+ * @brief Recherche un niveau de difficulté par son nom
+ * @param name Nom ("easy", "medium", ...), sans distinction de casse
+ * @return Niveau, NULL si inconnu
+ */
+const difficulty_t *find_difficulty(const char *name) {
+    for (int level = 0; level < DIFFICULTY_LEVELS; level++) {
+        if (strcasecmp(name, difficulties[level].name) == 0) {
+            return &difficulties[level];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Lit une proposition et la compare aux bornes de la difficulté
+ * @param text Ligne reçue
+ * @param level Difficulté de la partie
+ * @param guess Nombre lu
+ * @return 0 si valide, -1 si ce n'est pas un entier, 1 si hors plage
+ *
+ * strtoll signale par ERANGE les valeurs au-delà de 64 bits: elles sont
+ * hors plage pour tous les niveaux, jamais tronquées.
+ */
+int parse_guess(const char *text, const difficulty_t *level, int64_t *guess) {
+    char *end;
+    errno = 0;
+    long long value = strtoll(text, &end, 10);
+
+    if (end == text || *end != '\0' || (errno != 0 && errno != ERANGE)) {
+        return -1;
+    }
+    if (errno == ERANGE || value < level->min || value > level->max) {
+        return 1;
+    }
+    *guess = (int64_t)value;
+    return 0;
+}
+
+/**
+ * @brief Tire le nombre à deviner d'une partie
+ * @param level Difficulté de la partie
+ * @return Nombre dans [min, max]
+ *
+ * Les plages de 32 bits gardent le tirage historique; les plages larges
+ * tirent 64 bits, l'écart max - min étant calculé en non signé.
+ */
+int64_t random_target(const difficulty_t *level) {
+    if (!level->wide) {
+        return level->min + rand() % (int)(level->max - level->min + 1);
+    }
+    uint64_t span = (uint64_t)level->max - (uint64_t)level->min + 1; // 0 = 2^64
+    uint64_t draw = next_random();
+    return (int64_t)((uint64_t)level->min + (span ? draw % span : draw));
+}
+
+/* ============================================================================
+ * PROPRIÉTAIRE UNIQUE DU LEADERBOARD ET DES STATISTIQUES
+ * ============================================================================ */
+
+/**
+ * @brief Horloge monotone en microsecondes
+ * @return Microsecondes depuis une origine arbitraire
+ */
+int64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Horloge murale en microsecondes (comparable entre nœuds synchronisés)
+ * @return Microsecondes depuis l'époque Unix
+ */
+int64_t realtime_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+/**
+ * @brief Publie une chaîne d'événements dans la pile du propriétaire
+ * @param first Premier maillon (le plus récent)
+ * @param last Dernier maillon
+ *
+ * Un seul CAS pour toute la chaîne; seul le dépôt sur une pile vide
+ * réveille le propriétaire.
+ */
+void scoreboard_push(score_event_t *first, score_event_t *last) {
+    score_event_t *head = __atomic_load_n(&scoreboard.inbox, __ATOMIC_RELAXED);
+    do {
+        last->next = head;
+    } while (!__atomic_compare_exchange_n(&scoreboard.inbox, &head, first, 1,
+                                          __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+
+    if (!head) {
+        uint64_t one = 1;
+        ssize_t ignored = write(scoreboard.wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+/**
+ * @brief Attend que le propriétaire ait appliqué le lot d'un ticket
+ * @param ticket Ticket déposé avec les événements
+ */
+void scoreboard_wait(score_ticket_t *ticket) {
+    pthread_mutex_lock(&scoreboard.ticket_mutex);
+    while (!ticket->done) {
+        pthread_cond_wait(&scoreboard.ticket_cond, &scoreboard.ticket_mutex);
+    }
+    pthread_mutex_unlock(&scoreboard.ticket_mutex);
+}
+
+/**
+ * @brief Dépose des parties terminées pour le thread propriétaire
+ * @param records Parties terminées
+ * @param count Nombre de parties
+ * @param ticket Attente optionnelle (NULL = dépôt sans attente)
+ *
+ * Les parties sont chaînées localement puis publiées d'un seul CAS: elles
+ * arrivent donc dans le même lot.
+ */
+void post_game_records(const game_record_t *records, int count, score_ticket_t *ticket) {
+    score_event_t *first = NULL, *last = NULL;
+    int64_t now = monotonic_us();
+
+    for (int i = 0; i < count; i++) {
+        score_event_t *event = malloc(sizeof(score_event_t));
+        if (!event) {
+            __atomic_add_fetch(&scoreboard.dropped, 1, __ATOMIC_RELAXED);
+            continue;
+        }
+        event->record = records[i];
+        event->posted_us = now;
+        event->ticket = ticket;
+        event->swap = NULL;
+        event->barrier = 0;
+        event->dump = NULL;
+        event->remote = NULL;
+
+        // Pile LIFO: le propriétaire inverse l'ordre en la vidant
+        if (!last) {
+            last = event;
+        }
+        event->next = first;
+        first = event;
+    }
+
+    if (!first) {
+        if (ticket) {
+            ticket->done = 1;
+        }
+        return;
+    }
+
+    scoreboard_push(first, last);
+}
+
+/**
+ * @brief Enregistre une partie gagnée (statistiques et leaderboard)
+ * @param name Nom du joueur
+ * @param mode Mode de jeu (leaderboard concerné)
+ * @param level Difficulté de la partie (index dans difficulties)
+ * @param attempts Nombre de tentatives
+ * @param duration Durée en secondes
+ * @param score Score calculé
+ * @param wait Attendre l'application (pour afficher le nouveau leaderboard)
+ * @return 1 si le score est entré dans le leaderboard (wait uniquement), 0 sinon
+ */
+int record_game(const char *name, game_mode_t mode, int level, int attempts, int duration,
+                int score, int wait) {
+    game_record_t record;
+    score_ticket_t ticket = {0, 0};
+
+    strncpy(record.name, name, MAX_NAME_LENGTH - 1);
+    record.name[MAX_NAME_LENGTH - 1] = '\0';
+    record.mode = mode;
+    record.level = level;
+    record.attempts = attempts;
+    record.duration = duration;
+    record.score = score;
+
+    post_game_records(&record, 1, wait ? &ticket : NULL);
+    if (!wait) {
+        return 0;
+    }
+
+    scoreboard_wait(&ticket);
+    return ticket.inserted;
+}
+
+/**
+ * @brief Lit et valide un instantané produit par prad_rebuild
+ * @param path Chemin du fichier
+ * @param board Contenu lu
+ * @param error Raison du refus
+ * @param size Taille du buffer d'erreur
+ * @return 0 si valide, -1 sinon
+ */
+int board_load_file(const char *path, prad_board_file_t *board, char *error, size_t size) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        snprintf(error, size, "Fichier illisible: %s", strerror(errno));
+        return -1;
+    }
+    size_t read = fread(board, sizeof(*board), 1, file);
+    fclose(file);
+
+    if (read != 1) {
+        snprintf(error, size, "Format d'instantane inconnu");
+        return -1;
+    }
+    return board_validate(board, error, size);
+}
+
+/**
+ * @brief Vérifie un instantané (format, politiques du serveur, cohérence)
+ * @param board Instantané lu (fichier ou bascule)
+ * @param error Raison du refus
+ * @param size Taille du buffer d'erreur
+ * @return 0 si valide, -1 sinon
+ */
+int board_validate(const prad_board_file_t *board, char *error, size_t size) {
+    if (board->magic != PRAD_BOARD_FILE_MAGIC || board->version != PRAD_BOARD_FILE_VERSION) {
+        snprintf(error, size, "Format d'instantane inconnu");
+        return -1;
+    }
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        if (memcmp(&board->formulas[mode], &scoring_by_mode[mode]->formula,
+                   sizeof(prad_scoring_formula_t)) != 0) {
+            snprintf(error, size, "Politique differente pour le mode %s (serveur: %s)",
+                     prad_mode_name(mode), scoring_by_mode[mode]->name);
+            return -1;
+        }
+    }
+    if (board->mode_count != GAME_MODES || board->level_count != DIFFICULTY_LEVELS ||
+        board->games > INT32_MAX) {
+        snprintf(error, size, "Instantane incoherent");
+        return -1;
+    }
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        for (int level = 0; level < DIFFICULTY_LEVELS; level++) {
+            int count = board->boards[mode][level].count;
+            if (count < 0 || count > TOP_SCORES) {
+                snprintf(error, size, "Instantane incoherent");
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Remplace à chaud leaderboard et statistiques par un instantané
+ * @param path Fichier produit par prad_rebuild
+ * @param error Raison du refus
+ * @param size Taille du buffer d'erreur
+ * @return 0 si appliqué, -1 sinon
+ *
+ * Le remplacement passe par la file du propriétaire: il s'intercale entre
+ * deux lots, et les parties déposées ensuite s'appliquent par-dessus.
+ */
+int board_swap(const char *path, char *error, size_t size) {
+    score_event_t *event = malloc(sizeof(score_event_t));
+    prad_board_file_t *board = malloc(sizeof(prad_board_file_t));
+    score_ticket_t ticket = {0, 0};
+
+    if (!event || !board) {
+        free(event);
+        free(board);
+        snprintf(error, size, "Memoire insuffisante");
+        return -1;
+    }
+    if (board_load_file(path, board, error, size) < 0) {
+        free(event);
+        free(board);
+        return -1;
+    }
+
+    memset(event, 0, sizeof(*event));
+    event->posted_us = monotonic_us();
+    event->ticket = &ticket;
+    event->swap = board;
+    scoreboard_push(event, event);
+    scoreboard_wait(&ticket);
+    return 0;
+}
+
+/**
+ * @brief Attend que toutes les parties déposées avant l'appel soient appliquées
+ * @param dump Copie de l'état à remplir par le propriétaire (NULL = aucune)
+ *
+ * Utilisé à l'arrêt et à la bascule: une fois revenue, les parties sont
+ * dans le leaderboard publié, dans la file d'export et dans dump.
+ */
+void scoreboard_barrier(prad_board_file_t *dump) {
+    score_event_t *event = malloc(sizeof(score_event_t));
+    score_ticket_t ticket = {0, 0};
+
+    if (!event) {
+        return;
+    }
+    memset(event, 0, sizeof(*event));
+    event->posted_us = monotonic_us();
+    event->ticket = &ticket;
+    event->barrier = 1;
+    event->dump = dump;
+    scoreboard_push(event, event);
+    scoreboard_wait(&ticket);
+}
+
+/**
+ * @brief Applique un instantané recalculé (thread propriétaire uniquement)
+ * @param board Instantané validé
+ */
+void board_replace(const prad_board_file_t *board) {
+    memset(leaderboards, 0, sizeof(leaderboards));
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        for (int level = 0; level < DIFFICULTY_LEVELS; level++) {
+            const prad_shm_ranking_t *ranking = &board->boards[mode][level];
+            leaderboard_t *target = &leaderboards[mode][level];
+            for (int i = 0; i < ranking->count; i++) {
+                score_t *entry = &target->scores[i];
+                strncpy(entry->name, ranking->scores[i].name, MAX_NAME_LENGTH - 1);
+                entry->score = ranking->scores[i].score;
+                entry->attempts = ranking->scores[i].attempts;
+                entry->duration = ranking->scores[i].duration;
+                entry->timestamp = (time_t)ranking->scores[i].timestamp;
+            }
+            target->count = ranking->count;
+        }
+    }
+
+    global_stats.total_games = (int)board->games;
+    global_stats.total_attempts = (int)(board->total_attempts > INT32_MAX ? INT32_MAX
+                                                                          : board->total_attempts);
+    global_stats.best_attempts = (board->games > 0) ? board->best_attempts : 999999;
+    global_stats.avg_attempts = (board->games > 0)
+        ? (float)((double)board->total_attempts / (double)board->games) : 0.0f;
+}
+
+/**
+ * @brief Copie leaderboards et statistiques au format instantané (propriétaire)
+ * @param board Instantané à remplir (même format que prad_rebuild)
+ */
+void board_dump(prad_board_file_t *board) {
+    memset(board, 0, sizeof(*board));
+    board->magic = PRAD_BOARD_FILE_MAGIC;
+    board->version = PRAD_BOARD_FILE_VERSION;
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        board->formulas[mode] = scoring_by_mode[mode]->formula;
+    }
+    board->games = (uint64_t)global_stats.total_games;
+    board->total_attempts = (uint64_t)global_stats.total_attempts;
+    board->best_attempts = (global_stats.total_games > 0) ? global_stats.best_attempts : 0;
+    board->mode_count = GAME_MODES;
+    board->level_count = DIFFICULTY_LEVELS;
+
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        for (int level = 0; level < DIFFICULTY_LEVELS; level++) {
+            const leaderboard_t *source = &leaderboards[mode][level];
+            prad_shm_ranking_t *ranking = &board->boards[mode][level];
+            ranking->count = source->count;
+            for (int i = 0; i < source->count; i++) {
+                strncpy(ranking->scores[i].name, source->scores[i].name, PRAD_SHM_NAME_LENGTH);
+                ranking->scores[i].score = source->scores[i].score;
+                ranking->scores[i].attempts = source->scores[i].attempts;
+                ranking->scores[i].duration = source->scores[i].duration;
+                ranking->scores[i].timestamp = (int64_t)source->scores[i].timestamp;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Indique si une adresse est celle de la machine locale
+ * @param addr Adresse normalisée (address_normalize)
+ * @return 1 si adresse de bouclage (127.0.0.0/8, ::1, socket Unix de jeu)
+ */
+int is_loopback(const struct sockaddr_in6 *addr) {
+    const struct in6_addr *ip = &addr->sin6_addr;
+    return IN6_IS_ADDR_LOOPBACK(ip) || (IN6_IS_ADDR_V4MAPPED(ip) && ip->s6_addr[12] == 127);
+}
+
+/**
+ * @brief Protège le dernier instantané publié par un pointeur de danger
+ * @param slot Emplacement utilisé (à rendre avec board_release)
+ * @return Instantané lisible jusqu'à board_release
+ *
+ * Coût typique: une lecture, un CAS, une relecture. L'emplacement du
+ * dernier appel du thread est essayé en premier. Si les HAZARD_SLOTS
+ * emplacements sont tous pris (max_clients plus grand), le lecteur repart
+ * avec une copie privée faite sous reclaim_mutex au lieu d'attendre.
+ */
+board_snapshot_t *board_acquire(int *slot) {
+    int index = (hazard_hint >= 0) ? hazard_hint : (int)(next_random() % HAZARD_SLOTS);
+
+    // Réservation d'un emplacement libre (NULL → instantané courant)
+    board_snapshot_t *board = __atomic_load_n(&scoreboard.published, __ATOMIC_ACQUIRE);
+    for (int tried = 1; ; tried++) {
+        board_snapshot_t *expected = NULL;
+        if (__atomic_compare_exchange_n(&scoreboard.hazards[index], &expected, board, 0,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+            break;
+        }
+        index = (index + 1) % HAZARD_SLOTS;
+
+        if (tried % HAZARD_SLOTS == 0) {
+            // Copie de repli: board_reclaim ne libère rien pendant la copie
+            board_snapshot_t *copy = malloc(sizeof(board_snapshot_t));
+            if (copy) {
+                pthread_mutex_lock(&scoreboard.reclaim_mutex);
+                memcpy(copy, __atomic_load_n(&scoreboard.published, __ATOMIC_ACQUIRE),
+                       sizeof(board_snapshot_t));
+                pthread_mutex_unlock(&scoreboard.reclaim_mutex);
+                *slot = HAZARD_FALLBACK;
+                return copy;
+            }
+        }
+    }
+
+    // Revalidation: l'instantané a pu être remplacé avant d'être protégé
+    for (;;) {
+        board_snapshot_t *current = __atomic_load_n(&scoreboard.published, __ATOMIC_SEQ_CST);
+        if (current == board) {
+            break;
+        }
+        board = current;
+        __atomic_store_n(&scoreboard.hazards[index], board, __ATOMIC_SEQ_CST);
+    }
+
+    hazard_hint = index;
+    *slot = index;
+    return board;
+}
+
+/**
+ * @brief Rend l'emplacement de danger (l'instantané peut être libéré)
+ * @param slot Emplacement retourné par board_acquire
+ * @param board Instantané retourné par board_acquire (libéré si copie de repli)
+ */
+void board_release(int slot, board_snapshot_t *board) {
+    if (slot == HAZARD_FALLBACK) {
+        free(board);
+        return;
+    }
+    __atomic_store_n(&scoreboard.hazards[slot], NULL, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Libère les instantanés retirés qu'aucun lecteur ne protège plus
+ *
+ * Thread propriétaire uniquement (seul écrivain de published et retired).
+ * reclaim_mutex tenu: aucune copie de repli n'est en cours.
+ */
+void board_reclaim(void) {
+    board_snapshot_t *protected[HAZARD_SLOTS];
+    int kept = 0;
+
+    pthread_mutex_lock(&scoreboard.reclaim_mutex);
+    for (int i = 0; i < HAZARD_SLOTS; i++) {
+        protected[i] = __atomic_load_n(&scoreboard.hazards[i], __ATOMIC_SEQ_CST);
+    }
+
+    for (int r = 0; r < scoreboard.retired_count; r++) {
+        board_snapshot_t *board = scoreboard.retired[r];
+        int in_use = 0;
+
+        for (int i = 0; i < HAZARD_SLOTS && !in_use; i++) {
+            in_use = (protected[i] == board);
+        }
+
+        if (in_use) {
+            scoreboard.retired[kept++] = board;
+        } else {
+            free(board);
+        }
+    }
+
+    scoreboard.retired_count = kept;
+    pthread_mutex_unlock(&scoreboard.reclaim_mutex);
+}
+
+/**
+ * @brief Publie un instantané de l'état courant (thread propriétaire, ou main avant démarrage)
+ */
+void board_publish(void) {
+    board_snapshot_t *board = malloc(sizeof(board_snapshot_t));
+    if (!board) {
+        return; // L'ancien instantané reste servi
+    }
+
+    memcpy(board->boards, leaderboards, sizeof(board->boards));
+    board->total_games = global_stats.total_games;
+    board->best_attempts = global_stats.best_attempts;
+    board->avg_attempts = global_stats.avg_attempts;
+
+    board_snapshot_t *previous = __atomic_exchange_n(&scoreboard.published, board,
+                                                     __ATOMIC_SEQ_CST);
+    shm_export_board(board);
+    if (!previous) {
+        return;
+    }
+
+    // Chaque emplacement protège au plus un instantané: RETIRED_MAX suffit
+    scoreboard.retired[scoreboard.retired_count++] = previous;
+    board_reclaim();
+}
+
+/**
+ * @brief Thread propriétaire: applique les parties déposées par lots
+ * @param arg Non utilisé
+ * @return NULL
+ */
+void *scoreboard_thread(void *arg) {
+    (void)arg;
+    uint64_t wakeups;
+    struct pollfd pfd = {.fd = scoreboard.wake_fd, .events = POLLIN};
+
+    while (1) {
+        // Sans partie à appliquer: parties des autres workers, sinon compteurs exportés
+        if (poll(&pfd, 1, SHM_REFRESH_MS) == 0) {
+            if (board_share_refresh()) {
+                board_publish();
+                invalidate_read_snapshot();
+            } else {
+                shm_export_board(scoreboard.published);
+            }
+            continue;
+        }
+        if (read(scoreboard.wake_fd, &wakeups, sizeof(wakeups)) < 0 && errno != EINTR) {
+            continue;
+        }
+
+        score_event_t *stack = __atomic_exchange_n(&scoreboard.inbox, NULL, __ATOMIC_ACQUIRE);
+        if (!stack) {
+            continue;
+        }
+
+        // Remise dans l'ordre de dépôt
+        score_event_t *batch = NULL;
+        while (stack) {
+            score_event_t *next = stack->next;
+            stack->next = batch;
+            batch = stack;
+            stack = next;
+        }
+
+        int64_t now = monotonic_us();
+        unsigned long size = 0;
+        unsigned int changed = 0; // Leaderboards modifiés (BOARD_BIT)
+        int waiters = 0;
+
+        // Workers: le lot s'applique à la dernière copie partagée
+        if (workers.shared) {
+            shared_lock(&workers.shared->board_mutex);
+            board_share_pull();
+        }
+
+        for (score_event_t *event = batch; event; event = event->next) {
+            if (event->barrier) {
+                if (event->dump) {
+                    board_dump(event->dump);
+                }
+                standby_capture();
+                waiters |= (event->ticket != NULL);
+                continue;
+            }
+            if (event->swap) {
+                board_replace(event->swap);
+                changed = (1u << (GAME_MODES * DIFFICULTY_LEVELS)) - 1;
+                __atomic_store_n(&standby.resync, 1, __ATOMIC_RELEASE);
+                waiters |= (event->ticket != NULL);
+                continue;
+            }
+
+            if (event->remote) {
+                if (cluster_apply(event->remote)) {
+                    changed |= BOARD_BIT(event->remote->mode, event->remote->level);
+                }
+                continue;
+            }
+
+            stats_account(event->record.attempts);
+            game_mode_t mode = event->record.mode;
+            int level = event->record.level;
+            score_t entry;
+            memset(&entry, 0, sizeof(entry));
+            memcpy(entry.name, event->record.name, MAX_NAME_LENGTH);
+            entry.attempts = event->record.attempts;
+            entry.duration = event->record.duration;
+            entry.score = event->record.score;
+            entry.timestamp = time(NULL);
+            entry.origin = ++cluster.next_origin;
+            int entered = leaderboard_insert(&leaderboards[mode][level], &entry);
+            if (entered) {
+                changed |= BOARD_BIT(mode, level);
+                cluster_share(&entry, mode, level, realtime_us(), 0);
+            }
+            standby_ship_game(&entry, mode, level, 1);
+            if (event->ticket) {
+                event->ticket->inserted += entered;
+                waiters = 1;
+            }
+
+            int64_t latency = now - event->posted_us;
+            scoreboard.latency_total_us += latency;
+            if (latency > scoreboard.latency_max_us) {
+                scoreboard.latency_max_us = latency;
+            }
+            size++;
+        }
+
+        if (workers.shared) {
+            if (size > 0 || changed) {
+                board_share_push();
+            }
+            pthread_mutex_unlock(&workers.shared->board_mutex);
+        }
+
+        board_publish();
+        export_enqueue_batch(batch);
+
+        __atomic_add_fetch(&scoreboard.batches, 1, __ATOMIC_RELAXED);
+        __atomic_add_fetch(&scoreboard.applied, size, __ATOMIC_RELAXED);
+        if (size > scoreboard.max_batch) {
+            __atomic_store_n(&scoreboard.max_batch, size, __ATOMIC_RELAXED);
+        }
+
+        // Réveil des déposants en attente, puis libération du lot
+        if (waiters) {
+            pthread_mutex_lock(&scoreboard.ticket_mutex);
+        }
+        while (batch) {
+            score_event_t *next = batch->next;
+            if (batch->ticket) {
+                batch->ticket->done = 1;
+            }
+            free(batch->swap);
+            free(batch->remote);
+            free(batch);
+            batch = next;
+        }
+        if (waiters) {
+            pthread_cond_broadcast(&scoreboard.ticket_cond);
+            pthread_mutex_unlock(&scoreboard.ticket_mutex);
+        }
+
+        if (changed) {
+            invalidate_read_snapshot();
+            spectator_publish_leaderboard(changed);
+        }
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * EXPORT EN MÉMOIRE PARTAGÉE (SEQLOCK, VOIR prad_shm.h)
+ * ============================================================================ */
+
+/**
+ * @brief Crée et projette le segment partagé du leaderboard
+ * @return 0 si succès, -1 sinon (export désactivé)
+ *
+ * Le segment est toujours recréé (O_EXCL): un objet laissé par un autre
+ * utilisateur, que shm_unlink ne peut pas supprimer, fait échouer l'export
+ * au lieu d'être réutilisé.
+ */
+int shm_export_init(void) {
+    struct stat info;
+
+    shm_unlink(PRAD_SHM_NAME); // Reste d'une exécution précédente
+    int fd = shm_open(PRAD_SHM_NAME, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        if (errno == EEXIST) {
+            log_message("WARNING", "Segment " PRAD_SHM_NAME " existant et non supprimable");
+        }
+        return -1;
+    }
+
+    if (fstat(fd, &info) < 0 || info.st_uid != geteuid()) {
+        close(fd);
+        return -1;
+    }
+
+    if (ftruncate(fd, sizeof(prad_shm_board_t)) < 0) {
+        close(fd);
+        shm_unlink(PRAD_SHM_NAME);
+        return -1;
+    }
+
+    void *map = mmap(NULL, sizeof(prad_shm_board_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        shm_unlink(PRAD_SHM_NAME);
+        return -1;
+    }
+
+    prad_shm_board_t *segment = map;
+    memset(segment, 0, sizeof(*segment));
+    segment->version = PRAD_SHM_VERSION;
+    segment->mode_count = PRAD_SHM_MODES;
+    segment->level_count = PRAD_SHM_LEVELS;
+    segment->server_pid = (uint32_t)getpid();
+    segment->server_start = (int64_t)global_stats.server_start_time;
+    __atomic_store_n(&segment->magic, PRAD_SHM_MAGIC, __ATOMIC_RELEASE);
+
+    shm_board = segment;
+    return 0;
+}
+
+/**
+ * @brief Publie un instantané dans le segment partagé
+ * @param board Instantané à exporter
+ *
+ * Écrivain unique (thread propriétaire du leaderboard, ou main avant son
+ * démarrage): le compteur passe à impair, le contenu est écrit, puis le
+ * compteur repasse à pair.
+ */
+void shm_export_board(const board_snapshot_t *board) {
+    prad_shm_board_t *segment = shm_board;
+
+    if (!segment || !board) {
+        return;
+    }
+
+    uint32_t sequence = segment->sequence;
+    __atomic_store_n(&segment->sequence, sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    segment->updated = (int64_t)time(NULL);
+    segment->active_clients = active_clients;
+    segment->total_served = total_clients_served;
+    segment->total_games = board->total_games;
+    segment->best_attempts = (board->best_attempts == 999999) ? 0 : board->best_attempts;
+    segment->avg_attempts = board->avg_attempts;
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        for (int level = 0; level < DIFFICULTY_LEVELS; level++) {
+            const leaderboard_t *source = &board->boards[mode][level];
+            prad_shm_ranking_t *ranking = &segment->boards[mode][level];
+
+            ranking->count = source->count;
+            for (int i = 0; i < source->count; i++) {
+                prad_shm_score_t *entry = &ranking->scores[i];
+                memset(entry->name, 0, sizeof(entry->name));
+                strncpy(entry->name, source->scores[i].name, PRAD_SHM_NAME_LENGTH);
+                entry->score = source->scores[i].score;
+                entry->attempts = source->scores[i].attempts;
+                entry->duration = source->scores[i].duration;
+                entry->timestamp = (int64_t)source->scores[i].timestamp;
+            }
+        }
+    }
+
+    __atomic_store_n(&segment->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+/* ============================================================================
+ * JOURNAL D'ÉVÉNEMENTS DE JEU (SEGMENTS PROJETABLES, VOIR prad_events.h)
+ * ============================================================================ */
+
+/**
+ * @brief Ouvre (ou crée) et projette un segment du journal
+ * @param dir Répertoire des segments
+ * @param base_seq Numéro du premier enregistrement du segment
+ * @return Segment projeté en écriture, NULL si erreur
+ */
+prad_events_segment_t *event_segment_map(const char *dir, uint64_t base_seq) {
+    char path[512];
+    char file[64];
+
+    snprintf(file, sizeof(file), PRAD_EVENTS_FILE_FORMAT, (unsigned long long)base_seq);
+    snprintf(path, sizeof(path), "%s/%s", dir, file);
+
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    if (ftruncate(fd, sizeof(prad_events_segment_t)) < 0) {
+        close(fd);
+        return NULL;
+    }
+
+    void *map = mmap(NULL, sizeof(prad_events_segment_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+
+    prad_events_segment_t *segment = map;
+    prad_events_header_t *header = &segment->header;
+
+    // Nouveau segment (fichier vide): en-tête écrit, magic publié en dernier
+    if (header->magic != PRAD_EVENTS_MAGIC) {
+        header->version = PRAD_EVENTS_VERSION;
+        header->record_size = sizeof(prad_event_t);
+        header->capacity = PRAD_EVENTS_SEGMENT_RECORDS;
+        header->base_seq = base_seq;
+        header->committed = 0;
+        header->sealed = 0;
+        header->index_stride = PRAD_EVENTS_INDEX_STRIDE;
+        __atomic_store_n(&header->magic, PRAD_EVENTS_MAGIC, __ATOMIC_RELEASE);
+    } else if (header->version != PRAD_EVENTS_VERSION || header->base_seq != base_seq) {
+        munmap(map, sizeof(prad_events_segment_t));
+        return NULL;
+    }
+
+    return segment;
+}
+
+/**
+ * @brief Ouvre le journal: reprend après le dernier segment existant
+ * @param dir Répertoire des segments (créé si absent)
+ * @return 0 si succès, -1 sinon (journal désactivé)
+ */
+int event_log_open(const char *dir) {
+    unsigned long long last_base = 0;
+    int found = 0;
+
+    if (mkdir(dir, 0755) < 0 && errno != EEXIST) {
+        return -1;
+    }
+
+    DIR *listing = opendir(dir);
+    if (!listing) {
+        return -1;
+    }
+
+    struct dirent *entry;
+    while ((entry = readdir(listing)) != NULL) {
+        unsigned long long base;
+        char tail;
+        if (sscanf(entry->d_name, "events-%20llu.lo%c", &base, &tail) == 2 && tail == 'g' &&
+            (!found || base > last_base)) {
+            last_base = base;
+            found = 1;
+        }
+    }
+    closedir(listing);
+
+    prad_events_segment_t *segment = event_segment_map(dir, last_base);
+    if (!segment) {
+        return -1;
+    }
+
+    event_log.segment = segment;
+    event_log.next_seq = segment->header.base_seq + segment->header.committed;
+    strncpy(event_log.dir, dir, sizeof(event_log.dir) - 1);
+    event_log.enabled = 1;
+    return 0;
+}
+
+/**
+ * @brief Dépose un événement de jeu dans la file du journal
+ * @param type Nature de l'événement
+ * @param client Session concernée
+ * @param value Valeur selon le type (cible, tentative, nombre trouvé)
+ * @param attempts Tentatives de la partie
+ * @param duration Durée en secondes (victoire)
+ * @param score Score (victoire)
+ *
+ * Coût: une copie de 64 octets sous mutex; le coût du dépôt des victoires
+ * est mesuré et publié dans les statistiques (eventlog_victory_ns).
+ */
+void event_log_append(prad_event_type_t type, const client_data_t *client, int64_t value,
+                      int attempts, int duration, int score) {
+    if (!event_log.enabled) {
+        return;
+    }
+
+    struct timespec started, now;
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    clock_gettime(CLOCK_REALTIME, &now);
+
+    prad_event_t event;
+    memset(&event, 0, sizeof(event));
+    event.time_us = (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+    event.client_id = (uint32_t)client->client_id;
+    event.type = (uint16_t)type;
+    event.mode = (uint8_t)client_game_mode(client);
+    event.difficulty = (uint8_t)(client_difficulty(client) - difficulties);
+    event.value = (value > INT32_MAX) ? INT32_MAX : (value < INT32_MIN) ? INT32_MIN : (int32_t)value;
+    event.value64 = value;
+    event.attempts = attempts;
+    event.duration = duration;
+    event.score = score;
+    if (IN6_IS_ADDR_V4MAPPED(&client->address.sin6_addr)) {
+        memcpy(&event.addr, &client->address.sin6_addr.s6_addr[12], sizeof(event.addr));
+    }
+    memcpy(event.name, client->name, MAX_NAME_LENGTH);
+
+    int wake = 0;
+    pthread_mutex_lock(&event_log.mutex);
+    if (event_log.head - event_log.tail < EVENTLOG_RING) {
+        event_log.ring[event_log.head % EVENTLOG_RING] = event;
+        event_log.head++;
+        wake = (event_log.head - event_log.tail == EVENTLOG_BATCH);
+    } else {
+        __atomic_add_fetch(&event_log.dropped, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&event_log.mutex);
+
+    if (wake) {
+        pthread_cond_signal(&event_log.cond);
+    }
+
+    if (type == PRAD_EVENT_VICTORY) {
+        struct timespec done;
+        clock_gettime(CLOCK_MONOTONIC, &done);
+        __atomic_add_fetch(&event_log.victory_ns,
+                           (int64_t)(done.tv_sec - started.tv_sec) * 1000000000 +
+                           (done.tv_nsec - started.tv_nsec), __ATOMIC_RELAXED);
+        __atomic_add_fetch(&event_log.victories, 1, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Thread écrivain du journal: recopie la file par lots
+ * @param arg Non utilisé
+ * @return NULL
+ *
+ * Un lot part dès EVENTLOG_BATCH événements en attente, ou au plus tard
+ * après EVENTLOG_FLUSH_MS. Le compteur `committed` du segment n'est publié
+ * qu'une fois le lot entièrement écrit.
+ */
+void *event_log_thread(void *arg) {
+    (void)arg;
+    static prad_event_t batch[EVENTLOG_RING];
+    char log[256];
+
+    while (1) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_nsec += EVENTLOG_FLUSH_MS * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_mutex_lock(&event_log.mutex);
+        while (event_log.head - event_log.tail < EVENTLOG_BATCH && !event_log.closing &&
+               pthread_cond_timedwait(&event_log.cond, &event_log.mutex, &deadline) == 0) {
+        }
+        unsigned int count = event_log.head - event_log.tail;
+        int closing = event_log.closing;
+        for (unsigned int i = 0; i < count; i++) {
+            batch[i] = event_log.ring[(event_log.tail + i) % EVENTLOG_RING];
+        }
+        event_log.tail += count;
+        pthread_mutex_unlock(&event_log.mutex);
+
+        for (unsigned int i = 0; i < count; i++) {
+            prad_events_segment_t *segment = event_log.segment;
+            uint64_t offset = event_log.next_seq - segment->header.base_seq;
+
+            // Segment plein: scellé, puis ouverture du suivant
+            if (offset == PRAD_EVENTS_SEGMENT_RECORDS) {
+                prad_events_segment_t *next = event_segment_map(event_log.dir, event_log.next_seq);
+                if (!next) {
+                    __atomic_add_fetch(&event_log.dropped, count - i, __ATOMIC_RELAXED);
+                    snprintf(log, sizeof(log), "Journal: segment %llu impossible à créer",
+                             (unsigned long long)event_log.next_seq);
+                    log_message("ERROR", log);
+                    break;
+                }
+                __atomic_store_n(&segment->header.sealed, 1, __ATOMIC_RELEASE);
+                munmap(segment, sizeof(prad_events_segment_t));
+                event_log.segment = segment = next;
+                offset = 0;
+            }
+
+            batch[i].seq = event_log.next_seq++;
+            segment->records[offset] = batch[i];
+            if (offset % PRAD_EVENTS_INDEX_STRIDE == 0) {
+                prad_event_index_t *point = &segment->index[offset / PRAD_EVENTS_INDEX_STRIDE];
+                point->seq = batch[i].seq;
+                point->time_us = batch[i].time_us;
+            }
+
+            // Publication à chaque fin de lot et avant chaque changement de segment
+            if (i == count - 1 || offset == PRAD_EVENTS_SEGMENT_RECORDS - 1) {
+                __atomic_store_n(&segment->header.committed, offset + 1, __ATOMIC_RELEASE);
+            }
+            __atomic_add_fetch(&event_log.written, 1, __ATOMIC_RELAXED);
+        }
+
+        if (count > 0) {
+            __atomic_add_fetch(&event_log.batches, 1, __ATOMIC_RELAXED);
+        }
+
+        // Arrêt: dernier lot écrit, segment synchronisé sur disque
+        if (closing && count == 0) {
+            msync(event_log.segment, sizeof(prad_events_segment_t), MS_SYNC);
+            pthread_mutex_lock(&event_log.mutex);
+            event_log.closed = 1;
+            pthread_cond_broadcast(&event_log.cond);
+            pthread_mutex_unlock(&event_log.mutex);
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Vide le journal et synchronise le segment courant (arrêt)
+ * @return 0 si tout est écrit, -1 si l'écrivain n'a pas fini dans DRAIN_FLUSH_MS
+ *
+ * Les événements déposés après l'appel sont perdus.
+ */
+int event_log_close(void) {
+    struct timespec deadline;
+    int status = 0;
+
+    if (!event_log.enabled) {
+        return 0;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += DRAIN_FLUSH_MS / 1000;
+
+    pthread_mutex_lock(&event_log.mutex);
+    event_log.closing = 1;
+    pthread_cond_broadcast(&event_log.cond);
+    while (!event_log.closed && status == 0) {
+        status = pthread_cond_timedwait(&event_log.cond, &event_log.mutex, &deadline);
+    }
+    int closed = event_log.closed;
+    pthread_mutex_unlock(&event_log.mutex);
+
+    return closed ? 0 : -1;
+}
+
+/* ============================================================================
+ * EXPORT SQLITE DES PARTIES TERMINÉES (TRANSACTIONS PAR LOTS)
+ * ============================================================================ */
+
+/**
+ * @brief Recopie un lot appliqué dans la file d'export (thread propriétaire)
+ * @param batch Lot de parties, dans l'ordre d'application
+ */
+void export_enqueue_batch(const score_event_t *batch) {
+    if (!__atomic_load_n(&export_queue.enabled, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    int64_t now = (int64_t)time(NULL);
+    int wake = 0;
+
+    pthread_mutex_lock(&export_queue.mutex);
+    for (const score_event_t *event = batch; event; event = event->next) {
+        if (event->swap || event->barrier || event->remote) {
+            continue;
+        }
+        if (export_queue.head - export_queue.tail >= EXPORT_QUEUE) {
+            export_queue.dropped++;
+            continue;
+        }
+        export_row_t *row = &export_queue.rows[export_queue.head % EXPORT_QUEUE];
+        row->record = event->record;
+        row->finished_at = now;
+        export_queue.head++;
+    }
+    wake = (export_queue.head - export_queue.tail >= EXPORT_BATCH);
+    pthread_mutex_unlock(&export_queue.mutex);
+
+    if (wake) {
+        pthread_cond_signal(&export_queue.cond);
+    }
+}
+
+#ifdef PRAD_WITH_SQLITE
+/**
+ * @brief Ouvre la base d'export en mode WAL et crée le schéma
+ * @param path Chemin de la base
+ * @return Connexion ouverte, NULL si erreur
+ */
+sqlite3 *export_open(const char *path) {
+    sqlite3 *db = NULL;
+
+    if (sqlite3_open(path, &db) != SQLITE_OK ||
+        sqlite3_busy_timeout(db, EXPORT_BUSY_MS) != SQLITE_OK ||
+        sqlite3_exec(db,
+            "PRAGMA journal_mode=WAL;"
+            "PRAGMA synchronous=NORMAL;"
+            "CREATE TABLE IF NOT EXISTS games ("
+            "  id INTEGER PRIMARY KEY,"
+            "  finished_at INTEGER NOT NULL,"
+            "  name TEXT NOT NULL,"
+            "  attempts INTEGER NOT NULL,"
+            "  duration INTEGER NOT NULL,"
+            "  score INTEGER NOT NULL,"
+            "  mode TEXT NOT NULL DEFAULT 'solo',"
+            "  difficulty TEXT NOT NULL DEFAULT 'easy');"
+            "CREATE INDEX IF NOT EXISTS games_finished_at ON games(finished_at);",
+            NULL, NULL, NULL) != SQLITE_OK) {
+        fprintf(stderr, "❌ SQLite: %s\n", db ? sqlite3_errmsg(db) : "allocation");
+        sqlite3_close(db);
+        return NULL;
+    }
+
+    // Base créée avant les leaderboards par mode ou par difficulté (échoue si
+    // la colonne existe)
+    sqlite3_exec(db, "ALTER TABLE games ADD COLUMN mode TEXT NOT NULL DEFAULT 'solo'",
+                 NULL, NULL, NULL);
+    sqlite3_exec(db, "ALTER TABLE games ADD COLUMN difficulty TEXT NOT NULL DEFAULT 'easy'",
+                 NULL, NULL, NULL);
+
+    return db;
+}
+
+/**
+ * @brief Thread exportateur: une transaction par lot de parties
+ * @param arg Connexion SQLite (ouverte par export_open)
+ * @return NULL
+ *
+ * Un lot part dès EXPORT_BATCH parties en attente, ou au plus tard après
+ * EXPORT_FLUSH_MS. La file est vidée sous mutex; les écritures SQLite se
+ * font sans verrou partagé.
+ */
+void *export_thread(void *arg) {
+    sqlite3 *db = arg;
+    sqlite3_stmt *insert = NULL;
+    static export_row_t batch[EXPORT_QUEUE];
+    unsigned long window_rows = 0;
+    int64_t window_start = monotonic_ms();
+    char log[256];
+
+    if (sqlite3_prepare_v2(db,
+            "INSERT INTO games (finished_at, name, attempts, duration, score, mode, difficulty) "
+            "VALUES (?, ?, ?, ?, ?, ?, ?)", -1, &insert, NULL) != SQLITE_OK) {
+        snprintf(log, sizeof(log), "Export SQLite arrêté: %s", sqlite3_errmsg(db));
+        log_message("ERROR", log);
+        __atomic_store_n(&export_queue.enabled, 0, __ATOMIC_RELAXED);
+        sqlite3_close(db);
+        return NULL;
+    }
+
+    while (1) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += EXPORT_FLUSH_MS / 1000;
+        deadline.tv_nsec += (EXPORT_FLUSH_MS % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+
+        pthread_mutex_lock(&export_queue.mutex);
+        while (export_queue.head - export_queue.tail < EXPORT_BATCH && !export_queue.closing &&
+               pthread_cond_timedwait(&export_queue.cond, &export_queue.mutex, &deadline) == 0) {
+        }
+        unsigned int count = export_queue.head - export_queue.tail;
+        int closing = export_queue.closing;
+        for (unsigned int i = 0; i < count; i++) {
+            batch[i] = export_queue.rows[(export_queue.tail + i) % EXPORT_QUEUE];
+        }
+        export_queue.tail += count;
+        pthread_mutex_unlock(&export_queue.mutex);
+
+        if (count > 0) {
+            int ok = sqlite3_exec(db, "BEGIN", NULL, NULL, NULL) == SQLITE_OK;
+
+            for (unsigned int i = 0; ok && i < count; i++) {
+                sqlite3_bind_int64(insert, 1, batch[i].finished_at);
+                sqlite3_bind_text(insert, 2, batch[i].record.name, -1, SQLITE_STATIC);
+                sqlite3_bind_int(insert, 3, batch[i].record.attempts);
+                sqlite3_bind_int(insert, 4, batch[i].record.duration);
+                sqlite3_bind_int(insert, 5, batch[i].record.score);
+                sqlite3_bind_text(insert, 6, prad_mode_name(batch[i].record.mode), -1,
+                                  SQLITE_STATIC);
+                sqlite3_bind_text(insert, 7, difficulties[batch[i].record.level].name, -1,
+                                  SQLITE_STATIC);
+                ok = sqlite3_step(insert) == SQLITE_DONE;
+                sqlite3_reset(insert);
+            }
+
+            if (ok && sqlite3_exec(db, "COMMIT", NULL, NULL, NULL) == SQLITE_OK) {
+                __atomic_add_fetch(&export_queue.exported, count, __ATOMIC_RELAXED);
+                __atomic_add_fetch(&export_queue.transactions, 1, __ATOMIC_RELAXED);
+                window_rows += count;
+            } else {
+                snprintf(log, sizeof(log), "Export SQLite: lot de %u parties perdu (%s)",
+                         count, sqlite3_errmsg(db));
+                log_message("ERROR", log);
+                sqlite3_exec(db, "ROLLBACK", NULL, NULL, NULL);
+                __atomic_add_fetch(&export_queue.dropped, count, __ATOMIC_RELAXED);
+            }
+        }
+
+        // Débit sur une fenêtre glissante d'au moins une seconde
+        int64_t now = monotonic_ms();
+        if (now - window_start >= 1000) {
+            __atomic_store_n(&export_queue.rows_per_sec,
+                             (int)(window_rows * 1000 / (unsigned long)(now - window_start)),
+                             __ATOMIC_RELAXED);
+            window_rows = 0;
+            window_start = now;
+        }
+
+        // Arrêt: dernier lot validé, base fermée (reporte le WAL)
+        if (closing && count == 0) {
+            sqlite3_finalize(insert);
+            sqlite3_close(db);
+            pthread_mutex_lock(&export_queue.mutex);
+            export_queue.closed = 1;
+            pthread_cond_broadcast(&export_queue.cond);
+            pthread_mutex_unlock(&export_queue.mutex);
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+#endif
+
+/**
+ * @brief Exporte les parties en attente puis ferme la base (arrêt)
+ * @return 0 si tout est exporté, -1 si l'exportateur n'a pas fini dans DRAIN_FLUSH_MS
+ */
+int export_close(void) {
+    struct timespec deadline;
+    int status = 0;
+
+    if (!__atomic_load_n(&export_queue.enabled, __ATOMIC_RELAXED)) {
+        return 0;
+    }
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += DRAIN_FLUSH_MS / 1000;
+
+    pthread_mutex_lock(&export_queue.mutex);
+    export_queue.closing = 1;
+    pthread_cond_broadcast(&export_queue.cond);
+    while (!export_queue.closed && status == 0) {
+        status = pthread_cond_timedwait(&export_queue.cond, &export_queue.mutex, &deadline);
+    }
+    int closed = export_queue.closed;
+    pthread_mutex_unlock(&export_queue.mutex);
+
+    return closed ? 0 : -1;
+}
+
+/* ============================================================================
+ * REPRISE DE SESSION (JETONS DE RECONNEXION)
+ * ============================================================================ */
+
+/**
+ * @brief Initialise le générateur pseudo-aléatoire (cibles, emplacements)
+ *
+ * Utilise /dev/urandom si disponible, sinon l'heure et le PID.
+ */
+void seed_random(void) {
+    uint64_t seed = 0;
+    int fd = open("/dev/urandom", O_RDONLY);
+
+    if (fd >= 0) {
+        if (read(fd, &seed, sizeof(seed)) != (ssize_t)sizeof(seed)) {
+            seed = 0;
+        }
+        close(fd);
+    }
+
+    seed ^= ((uint64_t)time(NULL) << 32) ^ (uint64_t)getpid();
+    __atomic_store_n(&random_state, seed, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Tire un entier 64 bits pseudo-aléatoire (splitmix64, sans verrou)
+ * @return Valeur pseudo-aléatoire
+ */
+uint64_t next_random(void) {
+    uint64_t z = __atomic_add_fetch(&random_state, 0x9E3779B97F4A7C15ULL, __ATOMIC_RELAXED);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Émet un nouveau jeton de reprise
+ * @return Jeton de reprise, 0 si le noyau n'a pas fourni d'aléa
+ *
+ * Le jeton suffit à reprendre la partie: tiré de getrandom() (aléa du
+ * noyau), jamais de next_random() dont un tirage révèle les suivants.
+ * Sans aléa, la partie n'est pas suspendue à la déconnexion.
+ */
+uint64_t issue_resume_token(void) {
+    uint64_t token = 0;
+
+    while (token == 0) {
+        ssize_t got = getrandom(&token, sizeof(token), 0);
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got != (ssize_t)sizeof(token)) {
+            log_message("ERROR", "getrandom: jeton de reprise non émis");
+            return 0;
+        }
+    }
+    return token;
+}
+
+/**
+ * @brief Suspend la partie d'un client déconnecté en attendant sa reprise
+ * @param client Données du client (partie en cours)
+ *
+ * Un emplacement libre ou expiré est choisi dans la fenêtre de sondage du
+ * jeton; si la fenêtre est pleine, l'entrée la plus proche d'expirer est
+ * remplacée.
+ */
+void park_session(const client_data_t *client) {
+    time_t now = time(NULL);
+    unsigned int base = (unsigned int)(client->resume_token & (RESUME_SLOTS - 1));
+    parked_session_t *victim = NULL;
+
+    shared_lock(&resume_table->mutex);
+
+    for (int i = 0; i < RESUME_PROBES; i++) {
+        parked_session_t *slot = &resume_table->slots[(base + i) & (RESUME_SLOTS - 1)];
+
+        if (slot->token == 0 || slot->expires <= now || slot->token == client->resume_token) {
+            victim = slot;
+            break;
+        }
+        if (!victim || slot->expires < victim->expires) {
+            victim = slot;
+        }
+    }
+
+    victim->token = client->resume_token;
+    victim->expires = now + CONFIG_GET(resume_ttl);
+    victim->start_time = client->start_time;
+    victim->target_number = client->target_number;
+    victim->level = client->level;
+    victim->attempts = client->attempts;
+    memcpy(victim->name, client->name, MAX_NAME_LENGTH);
+
+    // Réplique: dans l'ordre de la table (verrou tenu)
+    if (__atomic_load_n(&standby.active, __ATOMIC_ACQUIRE)) {
+        handoff_parked_t entry;
+        parked_serialize(victim, &entry);
+        standby_ship_parked(STANDBY_PARK, &entry);
+    }
+
+    pthread_mutex_unlock(&resume_table->mutex);
+}
+
+/**
+ * @brief Reprend une partie suspendue et libère son emplacement
+ * @param token Jeton présenté par le client
+ * @param client Données du client à restaurer
+ * @return 1 si la partie a été reprise, 0 si le jeton est inconnu ou expiré
+ */
+int claim_parked_session(uint64_t token, client_data_t *client) {
+    time_t now = time(NULL);
+    unsigned int base = (unsigned int)(token & (RESUME_SLOTS - 1));
+    int found = 0;
+
+    if (token == 0) {
+        return 0;
+    }
+
+    shared_lock(&resume_table->mutex);
+
+    for (int i = 0; i < RESUME_PROBES; i++) {
+        parked_session_t *slot = &resume_table->slots[(base + i) & (RESUME_SLOTS - 1)];
+
+        if (slot->token == token) {
+            if (slot->expires > now) {
+                client->resume_token = token;
+                client->start_time = slot->start_time;
+                client->target_number = slot->target_number;
+                client->level = slot->level;
+                client->attempts = slot->attempts;
+                memcpy(client->name, slot->name, MAX_NAME_LENGTH);
+                found = 1;
+            }
+            slot->token = 0;
+            if (__atomic_load_n(&standby.active, __ATOMIC_ACQUIRE)) {
+                handoff_parked_t entry = {.token = token};
+                standby_ship_parked(STANDBY_CLAIM, &entry);
+            }
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&resume_table->mutex);
+    return found;
+}
+
+/* ============================================================================
+ * MESSAGES PARTAGÉS ET BOÎTES D'ENVOI
+ * ============================================================================ */
+
+/**
+ * @brief Sérialise un message une seule fois pour tous ses destinataires
+ * @param format Format printf du message (terminé par \n)
+ * @return Message avec une référence, NULL si erreur d'allocation ou si le
+ *         message dépasse BUFFER_SIZE (jamais de ligne tronquée)
+ */
+payload_t *payload_printf(const char *format, ...) {
+    char json[BUFFER_SIZE];
+    va_list args;
+
+    va_start(args, format);
+    int len = vsnprintf(json, sizeof(json), format, args);
+    va_end(args);
+
+    if (len < 0) {
+        return NULL;
+    }
+    if (len >= (int)sizeof(json)) {
+        log_message("ERROR", "Message partagé trop long: non envoyé");
+        return NULL;
+    }
+
+    return payload_create(json, (size_t)len);
+}
+
+/**
+ * @brief Crée un message partagé à partir d'un texte déjà sérialisé
+ * @param data Message JSON
+ * @param len Longueur du message
+ * @return Message avec une référence, NULL si erreur d'allocation
+ */
+payload_t *payload_create(const char *data, size_t len) {
+    payload_t *payload = malloc(sizeof(payload_t) + len + 1);
+    if (!payload) {
+        return NULL;
+    }
+
+    payload->refs = 1;
+    payload->len = len;
+    memcpy(payload->data, data, len);
+    payload->data[len] = '\0';
+    return payload;
+}
+
+/**
+ * @brief Ajoute une référence à un message partagé
+ * @param payload Message partagé
+ * @return Le même message
+ */
+payload_t *payload_ref(payload_t *payload) {
+    __atomic_add_fetch(&payload->refs, 1, __ATOMIC_RELAXED);
+    return payload;
+}
+
+/**
+ * @brief Libère une référence; le message est détruit avec la dernière
+ * @param payload Message partagé (NULL accepté)
+ */
+void payload_release(payload_t *payload) {
+    if (payload && __atomic_sub_fetch(&payload->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(payload);
+    }
+}
+
+/**
+ * @brief Initialise la boîte d'envoi d'une session
+ * @param outbox Boîte d'envoi
+ * @return 0 si succès, -1 si erreur
+ */
+int outbox_init(outbox_t *outbox) {
+    outbox->head = outbox->tail = outbox->dropped = 0;
+    outbox->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (outbox->wake_fd < 0) {
+        return -1;
+    }
+    pthread_mutex_init(&outbox->mutex, NULL);
+    return 0;
+}
+
+/**
+ * @brief Libère les messages restants et la boîte d'envoi
+ * @param outbox Boîte d'envoi
+ */
+void outbox_destroy(outbox_t *outbox) {
+    if (outbox->wake_fd < 0) {
+        return;
+    }
+    while (outbox->head != outbox->tail) {
+        payload_release(outbox->items[outbox->head++ % OUTBOX_CAPACITY]);
+    }
+    close(outbox->wake_fd);
+    outbox->wake_fd = -1;
+    pthread_mutex_destroy(&outbox->mutex);
+}
+
+/**
+ * @brief Dépose une référence de message dans la boîte d'une session
+ * @param client Session destinataire
+ * @param payload Message partagé (une référence est prise si déposé)
+ *
+ * Non bloquant: si la session ne suit pas, le message est perdu pour elle.
+ */
+void outbox_push(client_data_t *client, payload_t *payload) {
+    outbox_t *outbox = &client->outbox;
+    int queued = 0;
+
+    pthread_mutex_lock(&outbox->mutex);
+    if (outbox->tail - outbox->head < OUTBOX_CAPACITY) {
+        outbox->items[outbox->tail++ % OUTBOX_CAPACITY] = payload_ref(payload);
+        queued = 1;
+    } else {
+        outbox->dropped++;
+    }
+    pthread_mutex_unlock(&outbox->mutex);
+
+    if (queued) {
+        uint64_t one = 1;
+        ssize_t ignored = write(outbox->wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+/**
+ * @brief Envoie sur le socket tous les messages en attente de la session
+ * @param client Session (appelé par son propre thread uniquement)
+ * @return 0 si succès, -1 si le socket est fermé
+ */
+int outbox_flush(client_data_t *client) {
+    outbox_t *outbox = &client->outbox;
+    payload_t *pending[OUTBOX_CAPACITY];
+    unsigned int count = 0;
+    uint64_t counter;
+    int result = 0;
+
+    ssize_t ignored = read(outbox->wake_fd, &counter, sizeof(counter));
+    (void)ignored;
+
+    pthread_mutex_lock(&outbox->mutex);
+    while (outbox->head != outbox->tail) {
+        pending[count++] = outbox->items[outbox->head++ % OUTBOX_CAPACITY];
+    }
+    pthread_mutex_unlock(&outbox->mutex);
+
+    for (unsigned int i = 0; i < count; i++) {
+        if (result == 0 && send_buffer(client->socket, pending[i]->data, pending[i]->len) < 0) {
+            result = -1;
+        }
+        payload_release(pending[i]);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Attend un message du client en relayant les diffusions reçues
+ * @param client Session
+ * @param buffer Buffer de réception
+ * @param size Taille du buffer
+ * @return Nombre d'octets reçus, -1 si erreur, déconnexion, arrêt ou bascule
+ *
+ * Pendant l'arrêt, une session sans partie en cours, ou dont l'échéance
+ * est passée, est fermée (client->drained) après envoi des diffusions.
+ * Pendant une bascule, une session hors salon est mise en attente de
+ * transmission (client->handed_over) sans que son socket soit fermé.
+ */
+int wait_message(client_data_t *client, char *buffer, int size) {
+    struct pollfd fds[2] = {
+        { .fd = client->socket, .events = POLLIN },
+        { .fd = client->outbox.wake_fd, .events = POLLIN },
+    };
+
+    while (1) {
+        // Bascule: les sessions hors salon sont confiées au nouveau processus
+        if (__atomic_load_n(&handoff.requested, __ATOMIC_ACQUIRE) && !client->room &&
+            !drain_active()) {
+            if (outbox_flush(client) < 0) {
+                return -1;
+            }
+            if (handoff_collect(client) == 0) {
+                return -1;
+            }
+        }
+
+        int timeout = -1;
+        if (drain_active()) {
+            int64_t left = drain.deadline_ms - monotonic_ms();
+            if (!client->playing || left <= 0) {
+                outbox_flush(client);
+                client->drained = 1;
+                return -1;
+            }
+            timeout = (int)left;
+        }
+
+        int ready = poll(fds, 2, timeout);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return -1;
+        }
+        if (ready == 0) {
+            continue;
+        }
+
+        if ((fds[1].revents & POLLIN) && outbox_flush(client) < 0) {
+            return -1;
+        }
+
+        if (fds[0].revents & (POLLIN | POLLHUP | POLLERR)) {
+            int received = receive_message(client->socket, buffer, size);
+            if (received == 0) {
+                continue; // Ping ou pong WebSocket: rien à traiter
+            }
+            // TCP_QUICKACK n'est pas permanent: le noyau le retire de lui-même
+            if (received > 0 && client->quickack) {
+                socket_option(client->socket, IPPROTO_TCP, TCP_QUICKACK, 1, "tcp_quickack");
+            }
+            return received;
+        }
+    }
+}
+
+/* ============================================================================
+ * SALONS MULTI-JOUEURS (CIBLE PARTAGÉE ET DIFFUSION)
+ * ============================================================================ */
+
+/**
+ * @brief Valide un nom de salon (1-15 caractères alphanumériques)
+ * @param name Nom à valider
+ * @return 1 si valide, 0 sinon
+ */
+int validate_room_name(const char *name) {
+    size_t len = strlen(name);
+
+    if (len == 0 || len >= MAX_ROOM_NAME) {
+        return 0;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!isalnum((unsigned char)name[i])) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Diffuse un message à tous les joueurs d'un salon
+ * @param room Salon (mutex du salon déjà verrouillé)
+ * @param payload Message sérialisé une seule fois
+ * @param except Joueur exclu de la diffusion (NULL = aucun)
+ */
+void room_broadcast(room_t *room, payload_t *payload, const client_data_t *except) {
+    if (!payload) {
+        return;
+    }
+    for (int i = 0; i < room->member_count; i++) {
+        if (room->members[i] != except) {
+            outbox_push(room->members[i], payload);
+        }
+    }
+}
+
+/**
+ * @brief Fait entrer un client dans un salon (créé s'il n'existe pas)
+ * @param client Session
+ * @param name Nom du salon
+ * @param mode Déroulement attendu (doit correspondre à un salon existant)
+ * @return Salon rejoint, NULL si aucun salon libre, salon plein ou autre mode
+ */
+room_t *room_join(client_data_t *client, const char *name, room_mode_t mode) {
+    room_t *room = NULL;
+    room_t *free_slot = NULL;
+
+    pthread_mutex_lock(&rooms_mutex);
+
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        if (rooms[i].in_use && strcmp(rooms[i].name, name) == 0) {
+            room = &rooms[i];
+            break;
+        }
+        if (!rooms[i].in_use && !free_slot) {
+            free_slot = &rooms[i];
+        }
+    }
+
+    if (!room && free_slot) {
+        room = free_slot;
+        pthread_mutex_lock(&room->mutex);
+        strncpy(room->name, name, MAX_ROOM_NAME - 1);
+        room->name[MAX_ROOM_NAME - 1] = '\0';
+        room->in_use = 1;
+        room->level = client->level;
+        room->target_number = random_target(room->level);
+        room->round = 1;
+        room->round_start = time(NULL);
+        room->member_count = 0;
+        room->mode = mode;
+        room->scoring = scoring_by_mode[(mode == ROOM_TOURNAMENT) ? GAME_TOURNAMENT : GAME_RACE];
+        room->turn = 1;
+        room->turn_deadline_ms = monotonic_ms() + CONFIG_GET(round_window_ms);
+        room->sub_count = 0;
+        pthread_mutex_unlock(&room->mutex);
+    }
+
+    if (room && room->mode != mode) {
+        room = NULL;
+    }
+
+    if (room) {
+        int joined = 0;
+
+        pthread_mutex_lock(&room->mutex);
+        if (room->member_count < MAX_ROOM_MEMBERS) {
+            room->members[room->member_count++] = client;
+            client->room = room;
+            client->room_round = room->round;
+            client->attempts = 0;
+            client->start_time = time(NULL);
+
+            payload_t *event = payload_printf(
+                "{\"type\":\"room_player\",\"room\":\"%s\",\"event\":\"join\","
+                "\"player\":\"%s\",\"players\":%d}\n",
+                room->name, client->name, room->member_count);
+            room_broadcast(room, event, client);
+            payload_release(event);
+            joined = 1;
+        }
+        pthread_mutex_unlock(&room->mutex);
+
+        if (!joined) {
+            room = NULL;
+        }
+    }
+
+    pthread_mutex_unlock(&rooms_mutex);
+    return room;
+}
+
+/**
+ * @brief Déplace une soumission du tour vers un autre emplacement (mutex tenu)
+ * @param room Salon
+ * @param from Emplacement d'origine
+ * @param to Emplacement de destination
+ *
+ * Seul endroit qui recopie les champs sub_*: tout champ ajouté par
+ * emplacement se déplace ici.
+ */
+void room_move_submission(room_t *room, int from, int to) {
+    room->sub_client[to] = room->sub_client[from];
+    room->sub_guess[to] = room->sub_guess[from];
+    room->sub_guess_wide[to] = room->sub_guess_wide[from];
+    room->sub_attempts[to] = room->sub_attempts[from];
+    room->sub_client[to]->sub_slot = to;
+}
+
+/**
+ * @brief Fait sortir un client de son salon (libéré s'il devient vide)
+ * @param client Session
+ */
+void room_leave(client_data_t *client) {
+    room_t *room = client->room;
+
+    if (!room) {
+        return;
+    }
+
+    pthread_mutex_lock(&rooms_mutex);
+    pthread_mutex_lock(&room->mutex);
+
+    for (int i = 0; i < room->member_count; i++) {
+        if (room->members[i] == client) {
+            room->members[i] = room->members[--room->member_count];
+            break;
+        }
+    }
+
+    // Retirer la soumission du tour en cours (tournoi)
+    if (client->submitted_turn == room->turn && room->sub_count > 0) {
+        room_move_submission(room, --room->sub_count, client->sub_slot);
+        client->submitted_turn = 0;
+    }
+
+    if (room->member_count == 0) {
+        room->in_use = 0;
+    } else {
+        payload_t *event = payload_printf(
+            "{\"type\":\"room_player\",\"room\":\"%s\",\"event\":\"leave\","
+            "\"player\":\"%s\",\"players\":%d}\n",
+            room->name, client->name, room->member_count);
+        room_broadcast(room, event, NULL);
+        payload_release(event);
+    }
+
+    pthread_mutex_unlock(&room->mutex);
+    pthread_mutex_unlock(&rooms_mutex);
+
+    client->room = NULL;
+}
+
+/**
+ * @brief Joue une tentative contre la cible partagée du salon
+ * @param client Session (membre d'un salon)
+ * @param guess Nombre proposé
+ * @param duration Durée de la manche pour le joueur (en cas de victoire)
+ * @param score Score selon la politique du salon (en cas de victoire)
+ * @return 1 si trop grand, -1 si trop petit, 0 si le joueur gagne la manche
+ *
+ * La tentative est diffusée aux autres joueurs. Le premier à trouver gagne
+ * la manche: la victoire et la nouvelle manche sont diffusées à tous.
+ */
+int room_guess(client_data_t *client, int64_t guess, int *duration, int *score) {
+    room_t *room = client->room;
+    int result;
+
+    pthread_mutex_lock(&room->mutex);
+
+    // Une nouvelle manche a commencé depuis la dernière tentative
+    if (client->room_round != room->round) {
+        client->room_round = room->round;
+        client->attempts = 1;
+        client->start_time = room->round_start;
+    }
+
+    result = (guess > room->target_number) - (guess < room->target_number);
+
+    if (result != 0) {
+        payload_t *event = payload_printf(
+            "{\"type\":\"room_hint\",\"room\":\"%s\",\"player\":\"%s\",\"guess\":%lld,"
+            "\"direction\":\"%s\",\"attempts\":%d}\n",
+            room->name, client->name, (long long)guess, (result > 0) ? "grand" : "petit",
+            client->attempts);
+        room_broadcast(room, event, client);
+        payload_release(event);
+    } else {
+        time_t now = time(NULL);
+        *duration = (int)difftime(now, client->start_time);
+        *score = room->scoring->score(client->attempts, *duration, room->level->bits);
+
+        payload_t *event = payload_printf(
+            "{\"type\":\"room_victory\",\"room\":\"%s\",\"round\":%u,\"player\":\"%s\","
+            "\"number\":%lld,\"attempts\":%d,\"duration\":%d,\"score\":%d}\n",
+            room->name, room->round, client->name, (long long)room->target_number,
+            client->attempts, *duration, *score);
+        room_broadcast(room, event, client);
+        payload_release(event);
+
+        // Nouvelle manche pour tout le salon
+        room->round++;
+        room->round_start = now;
+        room->target_number = random_target(room->level);
+
+        event = payload_printf(
+            "{\"type\":\"room_round\",\"room\":\"%s\",\"round\":%u,\"min\":%lld,\"max\":%lld}\n",
+            room->name, room->round, (long long)room->level->min, (long long)room->level->max);
+        room_broadcast(room, event, NULL);
+        payload_release(event);
+    }
+
+    pthread_mutex_unlock(&room->mutex);
+    return result;
+}
+
+/* ============================================================================
+ * TOURNOIS PAR TOURS (RÉSOLUTION PAR LOT)
+ * ============================================================================ */
+
+/**
+ * @brief Horloge monotone en millisecondes
+ * @return Millisecondes écoulées depuis un instant arbitraire
+ */
+int64_t monotonic_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+ * @brief Enregistre la tentative d'un joueur pour le tour en cours
+ * @param client Session (membre d'un salon en mode tournoi)
+ * @param guess Nombre proposé
+ * @param turn Tour auquel la tentative est rattachée
+ * @return Millisecondes restantes avant la résolution du tour
+ *
+ * Une seule tentative compte par tour: une nouvelle proposition remplace
+ * la précédente sans coûter de tentative supplémentaire.
+ */
+int64_t room_submit(client_data_t *client, int64_t guess, unsigned int *turn) {
+    room_t *room = client->room;
+    int64_t remaining;
+
+    pthread_mutex_lock(&room->mutex);
+
+    // Une nouvelle manche a commencé depuis la dernière soumission
+    if (client->room_round != room->round) {
+        client->room_round = room->round;
+        client->attempts = 0;
+        client->start_time = room->round_start;
+    }
+
+    if (client->submitted_turn != room->turn) {
+        int slot = room->sub_count++;
+
+        client->attempts++;
+        client->submitted_turn = room->turn;
+        client->sub_slot = slot;
+        room->sub_client[slot] = client;
+        room->sub_attempts[slot] = client->attempts;
+    }
+    if (room->level->wide) {
+        room->sub_guess_wide[client->sub_slot] = guess;
+    } else {
+        room->sub_guess[client->sub_slot] = (int32_t)guess; // Déjà borné par parse_guess
+    }
+
+    *turn = room->turn;
+    remaining = room->turn_deadline_ms - monotonic_ms();
+
+    pthread_mutex_unlock(&room->mutex);
+    return (remaining > 0) ? remaining : 0;
+}
+
+/**
+ * @brief Résout toutes les soumissions d'un tour en une passe
+ * @param room Salon en mode tournoi (mutex du salon verrouillé)
+ * @param winners Parties gagnées à comptabiliser (MAX_ROOM_MEMBERS entrées)
+ * @return Nombre de gagnants du tour
+ *
+ * La comparaison à la cible est une boucle sans branchement sur des
+ * tableaux contigus (vectorisée par le compilateur), sur 32 bits sauf pour
+ * les difficultés larges. Trois messages d'indice sont sérialisés une fois
+ * et partagés par tous les joueurs.
+ */
+_Static_assert(MAX_ROOM_MEMBERS % 16 == 0, "MAX_ROOM_MEMBERS doit être un multiple de 16");
+
+int resolve_turn_locked(room_t *room, game_record_t *winners) {
+    int8_t directions[MAX_ROOM_MEMBERS];
+    const int64_t target = room->target_number;
+    const int count = room->sub_count;
+    int (*const score)(int, int, int) = room->scoring->score;
+    const int bits = room->level->bits;
+    int winner_count = 0;
+
+    // Passe de comparaison par lot, par blocs de 16 (MAX_ROOM_MEMBERS en est
+    // un multiple): le nombre d'itérations fixe permet la vectorisation en -O2
+    if (!room->level->wide) {
+        const int32_t narrow = (int32_t)target;
+        for (int block = 0; block < count; block += 16) {
+            for (int j = 0; j < 16; j++) {
+                int32_t guess = room->sub_guess[block + j];
+                directions[block + j] = (int8_t)((guess > narrow) - (guess < narrow));
+            }
+        }
+    } else {
+        for (int block = 0; block < count; block += 16) {
+            for (int j = 0; j < 16; j++) {
+                int64_t guess = room->sub_guess_wide[block + j];
+                directions[block + j] = (int8_t)((guess > target) - (guess < target));
+            }
+        }
+    }
+
+    // Indices partagés: trop petit, trouvé, trop grand
+    payload_t *hints[3];
+    const char *labels[3] = {"petit", "exact", "grand"};
+    for (int d = 0; d < 3; d++) {
+        hints[d] = payload_printf(
+            "{\"type\":\"turn_hint\",\"room\":\"%s\",\"turn\":%u,\"direction\":\"%s\"}\n",
+            room->name, room->turn, labels[d]);
+    }
+
+    time_t now = time(NULL);
+    char listed[BUFFER_SIZE / 2];
+    size_t listed_len = 0;
+    int listed_count = 0;
+    int listing = 1;
+    listed[0] = '\0';
+
+    for (int i = 0; i < count; i++) {
+        client_data_t *player = room->sub_client[i];
+
+        if (hints[directions[i] + 1]) {
+            outbox_push(player, hints[directions[i] + 1]);
+        }
+
+        if (directions[i] == 0) {
+            game_record_t *record = &winners[winner_count];
+            memcpy(record->name, player->name, MAX_NAME_LENGTH);
+            record->mode = GAME_TOURNAMENT;
+            record->level = (int)(room->level - difficulties);
+            record->attempts = room->sub_attempts[i];
+            record->duration = (int)difftime(now, player->start_time);
+            record->score = score(record->attempts, record->duration, bits);
+            event_log_append(PRAD_EVENT_VICTORY, player, target, record->attempts,
+                             record->duration, record->score);
+
+            // Liste bornée: arrêtée au premier gagnant qui ne tient pas entier
+            // (winner_count reste exact), le JSON reste toujours complet
+            if (listing && listed_count < MAX_LISTED_WINNERS) {
+                char entry[128];
+                int entry_len = snprintf(entry, sizeof(entry),
+                    "%s{\"player\":\"%s\",\"attempts\":%d,\"duration\":%d,\"score\":%d}",
+                    (listed_count > 0) ? "," : "", record->name, record->attempts,
+                    record->duration, record->score);
+                if (entry_len > 0 && (size_t)entry_len < sizeof(entry) &&
+                    listed_len + (size_t)entry_len < sizeof(listed)) {
+                    memcpy(listed + listed_len, entry, (size_t)entry_len + 1);
+                    listed_len += (size_t)entry_len;
+                    listed_count++;
+                } else {
+                    listing = 0;
+                }
+            }
+            winner_count++;
+        }
+    }
+
+    for (int d = 0; d < 3; d++) {
+        payload_release(hints[d]);
+    }
+
+    // Annonce du tour à tout le salon, puis nouvelle manche si la cible est trouvée
+    payload_t *event = payload_printf(
+        "{\"type\":\"turn_result\",\"room\":\"%s\",\"turn\":%u,\"round\":%u,"
+        "\"submissions\":%d,\"winner_count\":%d,\"number\":%lld,\"winners\":[%s]}\n",
+        room->name, room->turn, room->round, count, winner_count,
+        (long long)((winner_count > 0) ? target : -1), listed);
+    room_broadcast(room, event, NULL);
+    if (winner_count > 0) {
+        spectator_publish(event);
+    }
+    payload_release(event);
+
+    if (winner_count > 0) {
+        room->round++;
+        room->round_start = now;
+        room->target_number = random_target(room->level);
+
+        event = payload_printf(
+            "{\"type\":\"room_round\",\"room\":\"%s\",\"round\":%u,\"min\":%lld,\"max\":%lld}\n",
+            room->name, room->round, (long long)room->level->min, (long long)room->level->max);
+        room_broadcast(room, event, NULL);
+        payload_release(event);
+    }
+
+    room->sub_count = 0;
+    room->turn++;
+    return winner_count;
+}
+
+/**
+ * @brief Thread de résolution des tours de tournoi
+ * @param arg Inutilisé
+ * @return NULL
+ *
+ * Les tours échus sont résolus par lot; les gagnants sont déposés d'un
+ * seul bloc dans la file du propriétaire du leaderboard.
+ */
+void *tournament_thread(void *arg) {
+    (void)arg;
+    static game_record_t winners[MAX_ROOM_MEMBERS];
+    const struct timespec tick = { 0, ROUND_TICK_MS * 1000000L };
+    char log[256];
+
+    while (1) {
+        nanosleep(&tick, NULL);
+
+        for (int i = 0; i < MAX_ROOMS; i++) {
+            room_t *room = &rooms[i];
+            int winner_count = 0;
+            int submissions = 0;
+            unsigned int turn = 0;
+            char name[MAX_ROOM_NAME];
+
+            pthread_mutex_lock(&room->mutex);
+            if (room->in_use && room->mode == ROOM_TOURNAMENT &&
+                monotonic_ms() >= room->turn_deadline_ms) {
+                turn = room->turn;
+                submissions = room->sub_count;
+                memcpy(name, room->name, sizeof(name));
+                if (submissions > 0) {
+                    winner_count = resolve_turn_locked(room, winners);
+                }
+                room->turn_deadline_ms = monotonic_ms() + CONFIG_GET(round_window_ms);
+            }
+            pthread_mutex_unlock(&room->mutex);
+
+            if (submissions > 0) {
+                post_game_records(winners, winner_count, NULL);
+
+                snprintf(log, sizeof(log),
+                    "Salon '%s': tour %u résolu (%d soumissions, %d gagnants)",
+                    name, turn, submissions, winner_count);
+                log_message("INFO", log);
+            }
+        }
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * MODE SPECTATEUR (FLUX D'ÉVÉNEMENTS EN LECTURE SEULE)
+ * ============================================================================ */
+
+/**
+ * @brief Publie un événement à destination de tous les spectateurs
+ * @param payload Message partagé (une référence est prise)
+ */
+void spectator_publish(payload_t *payload) {
+    if (!payload) {
+        return;
+    }
+
+    pthread_mutex_lock(&spectator_hub.mutex);
+    payload_t **slot = &spectator_hub.ring[spectator_hub.head % SPECTATOR_RING];
+    payload_release(*slot);
+    *slot = payload_ref(payload);
+    spectator_hub.head++;
+    int listening = spectator_hub.count + spectator_hub.pending_count;
+    pthread_mutex_unlock(&spectator_hub.mutex);
+
+    if (listening > 0) {
+        uint64_t one = 1;
+        ssize_t ignored = write(spectator_hub.wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+}
+
+/**
+ * @brief Publie les leaderboards modifiés et les garde pour resynchronisation
+ * @param boards Leaderboards modifiés (BOARD_BIT(mode, difficulté))
+ *
+ * Le message diffusé ne contient que les leaderboards modifiés;
+ * l'instantané de resynchronisation les contient tous.
+ */
+void spectator_publish_leaderboard(unsigned int boards) {
+    enum { BOARDS = GAME_MODES * DIFFICULTY_LEVELS };
+    char json[BOARDS * 8192];
+    size_t len = 0, changed_len = 0;
+    size_t offsets[BOARDS + 1];
+
+    if (current_shed_level() >= SHED_NO_PUSH) {
+        return;
+    }
+    for (int board = 0; board < BOARDS; board++) {
+        offsets[board] = len;
+        len += format_json_leaderboard(json + len, sizeof(json) - len,
+                                       board / DIFFICULTY_LEVELS, board % DIFFICULTY_LEVELS);
+    }
+    offsets[BOARDS] = len;
+
+    payload_t *snapshot = payload_create(json, len);
+    if (!snapshot) {
+        return;
+    }
+
+    // Lignes des leaderboards modifiés, regroupées en tête du buffer
+    for (int board = 0; board < BOARDS; board++) {
+        if (boards & (1u << board)) {
+            size_t line = offsets[board + 1] - offsets[board];
+            memmove(json + changed_len, json + offsets[board], line);
+            changed_len += line;
+        }
+    }
+    payload_t *payload = (changed_len == len) ? payload_ref(snapshot)
+                                              : payload_create(json, changed_len);
+
+    pthread_mutex_lock(&spectator_hub.mutex);
+    payload_release(spectator_hub.snapshot);
+    spectator_hub.snapshot = snapshot;
+    pthread_mutex_unlock(&spectator_hub.mutex);
+
+    spectator_publish(payload);
+    payload_release(payload);
+}
+
+/**
+ * @brief Annonce une victoire aux spectateurs
+ * @param room Salon de la partie (NULL = partie solo)
+ * @param player Nom du gagnant
+ * @param number Nombre trouvé
+ * @param attempts Nombre de tentatives
+ * @param duration Durée en secondes
+ * @param score Score final
+ *
+ * Le leaderboard éventuellement modifié est diffusé par le thread
+ * propriétaire une fois la partie appliquée.
+ */
+void announce_victory(const char *room, const char *player, int64_t number, int attempts,
+                      int duration, int score) {
+    payload_t *event = payload_printf(
+        "{\"type\":\"live_victory\",\"room\":\"%s\",\"player\":\"%s\",\"number\":%lld,"
+        "\"attempts\":%d,\"duration\":%d,\"score\":%d}\n",
+        room ? room : "", player, (long long)number, attempts, duration, score);
+    spectator_publish(event);
+    payload_release(event);
+}
+
+/**
+ * @brief Confie le socket d'un spectateur au thread du flux d'événements
+ * @param socket Socket du spectateur
+ * @return 0 si pris en charge, -1 si trop de spectateurs
+ */
+int spectator_attach(int socket) {
+    int accepted = 0;
+
+    pthread_mutex_lock(&spectator_hub.mutex);
+    if (spectator_hub.count + spectator_hub.pending_count < MAX_SPECTATORS) {
+        spectator_hub.pending[spectator_hub.pending_count++] = socket;
+        accepted = 1;
+    }
+    pthread_mutex_unlock(&spectator_hub.mutex);
+
+    if (!accepted) {
+        return -1;
+    }
+
+    uint64_t one = 1;
+    ssize_t ignored = write(spectator_hub.wake_fd, &one, sizeof(one));
+    (void)ignored;
+    return 0;
+}
+
+/**
+ * @brief Envoie à un spectateur tout ce qu'il peut recevoir sans bloquer
+ * @param spectator Spectateur
+ * @return 0 si le spectateur reste connecté, -1 s'il faut le retirer
+ */
+static int spectator_pump(spectator_t *spectator) {
+    while (1) {
+        if (!spectator->current) {
+            pthread_mutex_lock(&spectator_hub.mutex);
+            uint64_t head = spectator_hub.head;
+            if (head - spectator->next_seq > SPECTATOR_RING) {
+                // Rattrapage avec perte: dernier leaderboard puis présent
+                spectator_hub.skipped += head - spectator->next_seq;
+                spectator->next_seq = head;
+                if (spectator_hub.snapshot) {
+                    spectator->current = payload_ref(spectator_hub.snapshot);
+                }
+            } else if (spectator->next_seq < head) {
+                spectator->current = payload_ref(
+                    spectator_hub.ring[spectator->next_seq % SPECTATOR_RING]);
+                spectator->next_seq++;
+            }
+            pthread_mutex_unlock(&spectator_hub.mutex);
+
+            if (!spectator->current) {
+                return 0;
+            }
+            spectator->offset = 0;
+        }
+
+        ssize_t sent = send(spectator->fd, spectator->current->data + spectator->offset,
+                            spectator->current->len - spectator->offset,
+                            MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (sent < 0) {
+            return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+        }
+
+        spectator->offset += (size_t)sent;
+        if (spectator->offset < spectator->current->len) {
+            return 0;
+        }
+        payload_release(spectator->current);
+        spectator->current = NULL;
+    }
+}
+
+/**
+ * @brief Thread unique servant tous les spectateurs (pas de thread par connexion)
+ * @param arg Inutilisé
+ * @return NULL
+ */
+void *spectator_thread(void *arg) {
+    (void)arg;
+    static spectator_t spectators[MAX_SPECTATORS];
+    static struct pollfd fds[MAX_SPECTATORS + 1];
+    int count = 0;
+    char discard[256];
+
+    while (1) {
+        fds[0].fd = spectator_hub.wake_fd;
+        fds[0].events = POLLIN;
+
+        pthread_mutex_lock(&spectator_hub.mutex);
+        uint64_t head = spectator_hub.head;
+        pthread_mutex_unlock(&spectator_hub.mutex);
+
+        for (int i = 0; i < count; i++) {
+            fds[i + 1].fd = spectators[i].fd;
+            fds[i + 1].events = POLLIN;
+            if (spectators[i].current || spectators[i].next_seq < head) {
+                fds[i + 1].events |= POLLOUT;
+            }
+        }
+
+        if (poll(fds, count + 1, -1) < 0) {
+            continue;
+        }
+
+        // Nouveaux spectateurs: ils partent du présent
+        int polled = count;
+        if (fds[0].revents & POLLIN) {
+            uint64_t counter;
+            ssize_t ignored = read(spectator_hub.wake_fd, &counter, sizeof(counter));
+            (void)ignored;
+
+            pthread_mutex_lock(&spectator_hub.mutex);
+            for (int i = 0; i < spectator_hub.pending_count; i++) {
+                int fd = spectator_hub.pending[i];
+                fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+                spectators[count++] = (spectator_t){ .fd = fd, .next_seq = spectator_hub.head };
+            }
+            spectator_hub.pending_count = 0;
+            pthread_mutex_unlock(&spectator_hub.mutex);
+        }
+
+        for (int i = 0; i < count; i++) {
+            int gone = 0;
+
+            // Les spectateurs n'envoient rien: toute lecture sert à détecter la fermeture
+            if (i < polled && (fds[i + 1].revents & (POLLIN | POLLHUP | POLLERR))) {
+                ssize_t n = recv(spectators[i].fd, discard, sizeof(discard), MSG_DONTWAIT);
+                gone = (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK));
+            }
+
+            if (gone || spectator_pump(&spectators[i]) < 0) {
+                close(spectators[i].fd);
+                payload_release(spectators[i].current);
+                spectators[i].fd = -1;
+            }
+        }
+
+        // Compaction des spectateurs restants
+        int kept = 0;
+        for (int i = 0; i < count; i++) {
+            if (spectators[i].fd >= 0) {
+                spectators[kept++] = spectators[i];
+            }
+        }
+        count = kept;
+
+        pthread_mutex_lock(&spectator_hub.mutex);
+        spectator_hub.count = count;
+        pthread_mutex_unlock(&spectator_hub.mutex);
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * LIMITES PAR ADRESSE IP (CONNEXIONS ET SEAUX À JETONS)
+ * ============================================================================ */
+
+/**
+ * @brief Clé de suivi d'une adresse source
+ * @param addr Adresse normalisée (address_normalize)
+ * @return Adresse IPv4 (::ffff:a.b.c.d) ou préfixe /64 IPv6, jamais 0
+ *
+ * Un préfixe /64 est attribué à un seul abonné: les limites par adresse
+ * ne se contournent pas en changeant d'adresse IPv6 dans ce préfixe.
+ */
+uint64_t ip_key(const struct sockaddr_in6 *addr) {
+    const uint8_t *bytes = addr->sin6_addr.s6_addr;
+    uint64_t high = 0, low = 0;
+
+    for (int i = 0; i < 8; i++) {
+        high = (high << 8) | bytes[i];
+        low = (low << 8) | bytes[8 + i];
+    }
+    // IPv4 mappée et ::1: 64 premiers bits nuls, l'adresse est dans les suivants
+    uint64_t key = high ? high : low;
+    return key ? key : 1;
+}
+
+/**
+ * @brief Alloue la table des adresses, dimensionnée d'après max_clients
+ * @param max_clients Clients simultanés au démarrage
+ * @return 0 en cas de succès, -1 si l'allocation échoue
+ *
+ * Deux emplacements par client admis, répartis entre les fragments: une
+ * table pleine de connexions ouvertes reste l'exception. La taille n'est
+ * pas revue au rechargement de max_clients.
+ */
+int ip_table_init(int max_clients) {
+    int slots = (int)(((int64_t)max_clients * 2 + IP_SHARDS - 1) / IP_SHARDS);
+
+    ip_shard_slots = (slots > IP_PROBE_SLOTS) ? slots : IP_PROBE_SLOTS;
+    for (int i = 0; i < IP_SHARDS; i++) {
+        pthread_mutex_init(&ip_table[i].mutex, NULL);
+        ip_table[i].slots = calloc((size_t)ip_shard_slots, sizeof(ip_entry_t));
+        if (!ip_table[i].slots) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Réserve une connexion pour une adresse source
+ * @param addr Adresse normalisée (IPv4 mappée en IPv6)
+ * @param entry Entrée de l'adresse, NULL si la connexion est admise sans suivi
+ * @return 0 si la connexion est admise, -1 si la limite par adresse est atteinte
+ *
+ * Appelé avant toute allocation de session: un refus ne coûte qu'un
+ * sondage de IP_PROBE_SLOTS emplacements. Une adresse inconnue prend un
+ * emplacement libre, sinon celui de l'adresse sans connexion vue le moins
+ * récemment. Si toutes les adresses sondées ont des connexions ouvertes,
+ * la table est pleine: la connexion passe sans suivi plutôt que d'être
+ * refusée comme un abus.
+ */
+int ip_acquire(const struct sockaddr_in6 *addr, ip_entry_t **entry) {
+    uint64_t key = ip_key(addr);
+    uint64_t hash = key * 0x9E3779B97F4A7C15ull;
+    unsigned int shard_index = (unsigned int)(hash >> 48) % IP_SHARDS;
+    unsigned int first = (unsigned int)(hash >> 16) % (unsigned int)ip_shard_slots;
+    ip_shard_t *shard = &ip_table[shard_index];
+    int64_t now = monotonic_ms();
+    ip_entry_t *found = NULL;
+    ip_entry_t *victim = NULL;
+    int refused = 0;
+
+    pthread_mutex_lock(&shard->mutex);
+
+    for (int i = 0; i < IP_PROBE_SLOTS; i++) {
+        ip_entry_t *slot = &shard->slots[(first + i) % (unsigned int)ip_shard_slots];
+
+        if (slot->key == key) {
+            found = slot;
+            break;
+        }
+        if (slot->key == 0) {
+            // Emplacement jamais utilisé: l'adresse n'est pas plus loin
+            victim = slot;
+            break;
+        }
+        if (slot->connections == 0 &&
+            (!victim || slot->last_seen_ms < victim->last_seen_ms)) {
+            victim = slot;
+        }
+    }
+
+    if (!found && victim) {
+        found = victim;
+        found->key = key;
+        found->shard = (uint8_t)shard_index;
+        found->connections = 0;
+        found->buckets[BUCKET_GUESS] = (token_bucket_t){ (int64_t)CONFIG_GET(guess_burst) * 1000, now };
+        found->buckets[BUCKET_STATS] = (token_bucket_t){ (int64_t)CONFIG_GET(stats_burst) * 1000, now };
+    }
+
+    if (found && found->connections >= CONFIG_GET(max_per_ip)) {
+        found = NULL;
+        refused = 1;
+    }
+    if (found) {
+        found->connections++;
+        found->last_seen_ms = now;
+    }
+
+    pthread_mutex_unlock(&shard->mutex);
+
+    if (refused) {
+        __atomic_add_fetch(&ip_rejected, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+    if (!found) {
+        __atomic_add_fetch(&ip_untracked, 1, __ATOMIC_RELAXED);
+    }
+    *entry = found;
+    return 0;
+}
+
+/**
+ * @brief Libère la connexion réservée par ip_acquire
+ * @param entry Entrée de l'adresse (NULL accepté)
+ */
+void ip_release(ip_entry_t *entry) {
+    if (!entry) {
+        return;
+    }
+
+    ip_shard_t *shard = &ip_table[entry->shard];
+    pthread_mutex_lock(&shard->mutex);
+    entry->connections--;
+    entry->last_seen_ms = monotonic_ms();
+    pthread_mutex_unlock(&shard->mutex);
+}
+
+/**
+ * @brief Consomme un jeton du seau de l'adresse pour une requête
+ * @param entry Entrée de l'adresse
+ * @param kind Catégorie de la requête
+ * @return 1 si la requête est autorisée, 0 si le débit est dépassé
+ */
+int ip_consume(ip_entry_t *entry, bucket_kind_t kind) {
+    // Lus à chaque requête: un rechargement s'applique aux seaux existants
+    const int64_t rates[2] = { CONFIG_GET(guess_rate), CONFIG_GET(stats_rate) };
+    const int64_t bursts[2] = {
+        (int64_t)CONFIG_GET(guess_burst) * 1000, (int64_t)CONFIG_GET(stats_burst) * 1000
+    };
+    int allowed;
+
+    if (!entry) {
+        return 1;
+    }
+
+    ip_shard_t *shard = &ip_table[entry->shard];
+    token_bucket_t *bucket = &entry->buckets[kind];
+    int64_t now = monotonic_ms();
+
+    pthread_mutex_lock(&shard->mutex);
+
+    // Remplissage proportionnel au temps écoulé (rate jetons/s = rate millièmes/ms)
+    bucket->tokens += (now - bucket->last_ms) * rates[kind];
+    if (bucket->tokens > bursts[kind]) {
+        bucket->tokens = bursts[kind];
+    }
+    bucket->last_ms = now;
+
+    allowed = (bucket->tokens >= 1000);
+    if (allowed) {
+        bucket->tokens -= 1000;
+    }
+    entry->last_seen_ms = now;
+
+    pthread_mutex_unlock(&shard->mutex);
+
+    if (!allowed) {
+        __atomic_add_fetch(&rate_limited, 1, __ATOMIC_RELAXED);
+    }
+    return allowed;
+}
+
+/**
+ * @brief Applique l'en-tête PROXY (version 1) envoyé par un proxy local
+ * @param client Session d'un pair local (is_loopback)
+ * @param line Ligne "PROXY TCP4|TCP6 source destination port_source port_destination"
+ * @return 1 si l'adresse du client a été remplacée, 0 si la ligne est ignorée
+ *         (UNKNOWN ou invalide), -1 si la limite de l'adresse est atteinte
+ *
+ * Tous les joueurs du proxy arrivent de 127.0.0.1: les limites de
+ * connexions et les seaux à jetons suivent ensuite l'adresse transmise.
+ */
+int proxy_header_apply(client_data_t *client, const char *line) {
+    char family[8], source[INET6_ADDRSTRLEN], destination[INET6_ADDRSTRLEN];
+    unsigned int source_port, destination_port;
+    struct sockaddr_storage raw;
+    struct sockaddr_in6 forwarded;
+    char address[ADDRESS_TEXT_MAX];
+    char log[256];
+
+    if (sscanf(line, "PROXY %7s %45s %45s %u %u", family, source, destination,
+               &source_port, &destination_port) != 5 || source_port > 65535) {
+        return 0;
+    }
+
+    memset(&raw, 0, sizeof(raw));
+    if (strcmp(family, "TCP4") == 0) {
+        struct sockaddr_in *v4 = (struct sockaddr_in *)&raw;
+        v4->sin_family = AF_INET;
+        v4->sin_port = htons((uint16_t)source_port);
+        if (inet_pton(AF_INET, source, &v4->sin_addr) != 1) {
+            return 0;
+        }
+    } else if (strcmp(family, "TCP6") == 0) {
+        struct sockaddr_in6 *v6 = (struct sockaddr_in6 *)&raw;
+        v6->sin6_family = AF_INET6;
+        v6->sin6_port = htons((uint16_t)source_port);
+        if (inet_pton(AF_INET6, source, &v6->sin6_addr) != 1) {
+            return 0;
+        }
+    } else {
+        return 0;
+    }
+    address_normalize((struct sockaddr *)&raw, &forwarded);
+
+    // Le vrai client local (navigateur sur la même machine) reste sans suivi
+    ip_entry_t *ip = NULL;
+    if (!is_loopback(&forwarded) && ip_acquire(&forwarded, &ip) < 0) {
+        return -1;
+    }
+    ip_release(client->ip);
+    client->ip = ip;
+    client->address = forwarded;
+
+    snprintf(log, sizeof(log), "Client #%d: adresse transmise par le proxy %s",
+        client->client_id,
+        format_address((const struct sockaddr *)&forwarded, address, sizeof(address)));
+    log_message("INFO", log);
+    return 1;
+}
+
+/**
+ * @brief Consomme l'en-tête PROXY s'il est déjà arrivé à la connexion
+ * @param client Session d'un pair local (is_loopback)
+ * @return 0 si aucun en-tête ou en-tête appliqué, -1 si la limite est atteinte
+ *
+ * Seule la ligne de l'en-tête est lue (MSG_PEEK puis recv de sa longueur):
+ * ce qui la suit reste dans le socket. Arrivé plus tard, l'en-tête est
+ * traité comme première ligne de la saisie du nom.
+ */
+int proxy_header_peek(client_data_t *client) {
+    char line[PROXY_HEADER_MAX + 1];
+    ssize_t peeked = recv(client->socket, line, PROXY_HEADER_MAX, MSG_PEEK | MSG_DONTWAIT);
+
+    if (peeked < 6 || strncmp(line, "PROXY ", 6) != 0) {
+        return 0;
+    }
+    char *end = memchr(line, '\n', (size_t)peeked);
+    if (!end) {
+        return 0;
+    }
+    size_t len = (size_t)(end - line) + 1;
+    if (recv(client->socket, line, len, 0) != (ssize_t)len) {
+        return 0;
+    }
+    line[len - 1] = '\0';
+    return (proxy_header_apply(client, line) < 0) ? -1 : 0;
+}
+
+/* ============================================================================
+ * PRIORITÉ DES COUPS DE JEU SUR LES LECTURES (INSTANTANÉS PARTAGÉS)
+ * ============================================================================ */
+
+/**
+ * @brief Obtient l'instantané stats + leaderboard à servir
+ * @param mode Mode de jeu du leaderboard joint aux statistiques
+ * @param level Difficulté du leaderboard
+ * @return Message partagé avec une référence (NULL si erreur d'allocation)
+ *
+ * Un instantané de moins de STATS_TICK_MS est toujours réutilisé. Si des
+ * coups sont en cours, l'âge toléré monte à STATS_MAX_STALE_MS pour ne pas
+ * prendre les mutex du jeu. Un seul lecteur reconstruit; les autres
+ * repartent avec l'instantané existant.
+ */
+payload_t *acquire_read_snapshot(game_mode_t mode, int level) {
+    int64_t now = monotonic_ms();
+    int busy = __atomic_load_n(&moves_in_flight, __ATOMIC_RELAXED) > 0 ||
+               current_shed_level() >= SHED_CACHED_STATS;
+    int64_t max_age = busy ? STATS_MAX_STALE_MS : STATS_TICK_MS;
+    payload_t *payload = NULL;
+    int fresh;
+
+    pthread_mutex_lock(&read_snapshot.mutex);
+    if (read_snapshot.payload[mode][level]) {
+        payload = payload_ref(read_snapshot.payload[mode][level]);
+    }
+    fresh = payload && read_snapshot.built_ms[mode][level] &&
+            now - read_snapshot.built_ms[mode][level] < max_age;
+    pthread_mutex_unlock(&read_snapshot.mutex);
+
+    // Reconstruction: sans attente si un instantané existe déjà
+    if (!fresh && (payload ? pthread_mutex_trylock(&read_snapshot.build_mutex) == 0
+                           : pthread_mutex_lock(&read_snapshot.build_mutex) == 0)) {
+        char json[8192 + 512];
+        size_t len = format_json_stats(json, 512);
+        len += format_json_leaderboard(json + len, sizeof(json) - len, mode, level);
+        payload_t *rebuilt = payload_create(json, len);
+
+        if (rebuilt) {
+            pthread_mutex_lock(&read_snapshot.mutex);
+            payload_release(read_snapshot.payload[mode][level]);
+            read_snapshot.payload[mode][level] = payload_ref(rebuilt);
+            read_snapshot.built_ms[mode][level] = monotonic_ms();
+            pthread_mutex_unlock(&read_snapshot.mutex);
+
+            __atomic_add_fetch(&read_snapshot.built, 1, __ATOMIC_RELAXED);
+            payload_release(payload);
+            payload = rebuilt;
+        }
+        pthread_mutex_unlock(&read_snapshot.build_mutex);
+    }
+
+    return payload;
+}
+
+/**
+ * @brief Marque l'instantané comme périmé (après une victoire)
+ */
+void invalidate_read_snapshot(void) {
+    pthread_mutex_lock(&read_snapshot.mutex);
+    memset(read_snapshot.built_ms, 0, sizeof(read_snapshot.built_ms));
+    pthread_mutex_unlock(&read_snapshot.mutex);
+}
+
+/**
+ * @brief Envoie stats + leaderboard depuis l'instantané partagé
+ * @param socket Socket du client
+ * @param mode Mode de jeu du leaderboard
+ * @param level Difficulté du leaderboard
+ */
+void send_read_snapshot(int socket, game_mode_t mode, int level) {
+    payload_t *payload = acquire_read_snapshot(mode, level);
+
+    if (payload) {
+        send_buffer(socket, payload->data, payload->len);
+        __atomic_add_fetch(&read_snapshot.served, 1, __ATOMIC_RELAXED);
+        payload_release(payload);
+    }
+}
+
+/* ============================================================================
+ * DÉLESTAGE PILOTÉ PAR LE RETARD D'ORDONNANCEMENT
+ * ============================================================================ */
+
+/**
+ * @brief Lit les seuils de délestage au format "a,b,c" (ms, croissants)
+ * @param spec Chaîne de configuration
+ * @param thresholds Seuils lus (SHED_LEVELS valeurs)
+ * @return 0 si valide, -1 sinon (seuils inchangés)
+ */
+int parse_shed_thresholds(const char *spec, int *thresholds) {
+    int parsed[SHED_LEVELS];
+    const char *cursor = spec;
+
+    for (int i = 0; i < SHED_LEVELS; i++) {
+        char *end;
+        long value = strtol(cursor, &end, 10);
+
+        if (end == cursor || value <= 0 || value > 60000 ||
+            (i > 0 && value <= parsed[i - 1])) {
+            return -1;
+        }
+        parsed[i] = (int)value;
+
+        if (i < SHED_LEVELS - 1) {
+            if (*end != ',') {
+                return -1;
+            }
+            cursor = end + 1;
+        } else if (*end != '\0') {
+            return -1;
+        }
+    }
+
+    memcpy(thresholds, parsed, sizeof(parsed));
+    return 0;
+}
+
+/**
+ * @brief Palier de délestage courant
+ * @return Valeur de shed_level_t
+ */
+int current_shed_level(void) {
+    return __atomic_load_n(&load_monitor.level, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Sonde du retard d'ordonnancement
+ * @param arg Non utilisé
+ * @return NULL
+ *
+ * Le thread dort LAG_PROBE_MS et mesure son retard au réveil: c'est le
+ * délai que subit aussi un thread client entre « socket lisible » et
+ * « message traité » quand les CPU sont saturés. Le palier monte dès que
+ * le retard lissé franchit un seuil. Il ne redescend que d'un palier à la
+ * fois, après SHED_HOLD_MS passées sous 3/4 du seuil du palier courant:
+ * une sonde calme isolée ne lève pas tout le délestage d'un coup.
+ */
+void *lag_monitor_thread(void *arg) {
+    (void)arg;
+    struct timespec period = {0, LAG_PROBE_MS * 1000000L};
+    int lag_us = 0;
+    int64_t calm_since_ms = -1; // Début du retard sous le seuil bas (-1 = aucun)
+    char log[128];
+
+    while (1) {
+        struct timespec before, after;
+        clock_gettime(CLOCK_MONOTONIC, &before);
+        nanosleep(&period, NULL);
+        clock_gettime(CLOCK_MONOTONIC, &after);
+
+        int64_t elapsed_us = (int64_t)(after.tv_sec - before.tv_sec) * 1000000 +
+                             (after.tv_nsec - before.tv_nsec) / 1000;
+        int64_t sample = elapsed_us - LAG_PROBE_MS * 1000;
+        if (sample < 0) {
+            sample = 0;
+        }
+        lag_us = (int)((3 * (int64_t)lag_us + sample) / 4);
+        __atomic_store_n(&load_monitor.lag_us, lag_us, __ATOMIC_RELAXED);
+
+        int level = current_shed_level();
+        int target = level;
+        int reached = SHED_NONE;
+        for (int i = 0; i < SHED_LEVELS; i++) {
+            if (lag_us >= CONFIG_GET(shed_ms[i]) * 1000) {
+                reached = i + 1;
+            }
+        }
+
+        if (reached > level) {
+            target = reached;
+            calm_since_ms = -1;
+        } else if (level > SHED_NONE && lag_us < CONFIG_GET(shed_ms[level - 1]) * 750) {
+            // Descente d'un seul palier, après un calme soutenu; le palier
+            // suivant attend à nouveau SHED_HOLD_MS
+            int64_t now = monotonic_ms();
+            if (calm_since_ms < 0) {
+                calm_since_ms = now;
+            } else if (now - calm_since_ms >= SHED_HOLD_MS) {
+                target = level - 1;
+                calm_since_ms = now;
+            }
+        } else {
+            calm_since_ms = -1;
+        }
+
+        if (target != level) {
+            __atomic_store_n(&load_monitor.level, target, __ATOMIC_RELAXED);
+            snprintf(log, sizeof(log),
+                "Délestage: palier %d → %d (retard %.1f ms)",
+                level, target, lag_us / 1000.0);
+            log_message(target > level ? "WARNING" : "INFO", log);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Refuse une connexion pour surcharge avec un délai de réessai
+ * @param socket Socket du client
+ * @param retry_after Délai conseillé en secondes
+ */
+void send_json_overloaded(int socket, int retry_after) {
+    char json[256];
+    snprintf(json, sizeof(json),
+        "{\"type\":\"error\",\"message\":\"Serveur surcharge, reessayez plus tard\","
+        "\"retry_after\":%d}\n", retry_after);
+    send_message(socket, json);
+}
+
+/**
+ * @brief Affiche les statistiques du serveur au client
+ * @param socket Socket du client
+ */
+void display_server_stats(int socket) {
+    char msg[2048];
+    char buffer[256];
+    int slot;
+    board_snapshot_t *board = board_acquire(&slot);
+
+    time_t now = time(NULL);
+    int uptime = (int)difftime(now, global_stats.server_start_time);
+    int hours = uptime / 3600;
+    int minutes = (uptime % 3600) / 60;
+    int seconds = uptime % 60;
+
+    snprintf(msg, sizeof(msg),
+        "\n╔═══════════════════════════════════════════════════╗\n"
+        "║        📊 STATISTIQUES DU SERVEUR                 ║\n"
+        "╠═══════════════════════════════════════════════════╣\n");
+
+    snprintf(buffer, sizeof(buffer),
+        "║ ⏱️  Uptime             : %02dh %02dm %02ds              ║\n",
+        hours, minutes, seconds);
+    strcat(msg, buffer);
+
+    snprintf(buffer, sizeof(buffer),
+        "║ 👥 Clients actifs      : %-25d║\n", active_clients);
+    strcat(msg, buffer);
+
+    snprintf(buffer, sizeof(buffer),
+        "║ 📈 Total servis        : %-25d║\n", total_clients_served);
+    strcat(msg, buffer);
+
+    snprintf(buffer, sizeof(buffer),
+        "║ 🎮 Parties jouées      : %-25d║\n", board->total_games);
+    strcat(msg, buffer);
+
+    snprintf(buffer, sizeof(buffer),
+        "║ 🏆 Meilleur (tentatives): %-25d║\n",
+        (board->best_attempts == 999999) ? 0 : board->best_attempts);
+    strcat(msg, buffer);
+
+    snprintf(buffer, sizeof(buffer),
+        "║ 📊 Moyenne tentatives  : %-24.1f║\n", board->avg_attempts);
+    strcat(msg, buffer);
+
+    strcat(msg, "╚═══════════════════════════════════════════════════╝\n");
+
+    board_release(slot, board);
+
+    send_message(socket, msg);
+}
+
+/**
+ * @brief Affiche le leaderboard au client sous forme de tableau élégant
+ * @param socket Socket du client
+ * @param mode Mode de jeu du leaderboard
+ * @param level Difficulté du leaderboard
+ */
+void display_leaderboard(int socket, game_mode_t mode, int level) {
+    char msg[4096];
+    char buffer[256];
+    int slot;
+    board_snapshot_t *snapshot = board_acquire(&slot);
+    const leaderboard_t *board = &snapshot->boards[mode][level];
+
+    snprintf(msg, sizeof(msg),
+        "\n╔═══════════════════════════════════════════════════╗\n"
+        "║           🏆 TOP %d MEILLEURS SCORES 🏆            ║\n"
+        "╠═══════════════════════════════════════════════════╣\n"
+        "║  #  │ Joueur     │ Score  │ Essais │ Temps      ║\n"
+        "╠═════╪════════════╪════════╪════════╪════════════╣\n",
+        TOP_SCORES);
+
+    if (board->count == 0) {
+        strcat(msg,
+            "║              Aucun score enregistré               ║\n");
+    } else {
+        for (int i = 0; i < board->count; i++) {
+            const char *medal = "   ";
+            if (i == 0) medal = "🥇";
+            else if (i == 1) medal = "🥈";
+            else if (i == 2) medal = "🥉";
+
+            snprintf(buffer, sizeof(buffer),
+                "║ %s │ %-10s │ %6d │ %6d │ %7ds   ║\n",
+                medal,
+                board->scores[i].name,
+                board->scores[i].score,
+                board->scores[i].attempts,
+                board->scores[i].duration);
+            strcat(msg, buffer);
+        }
+    }
+
+    strcat(msg, "╚═══════════════════════════════════════════════════╝\n");
+
+    board_release(slot, snapshot);
+
+    send_message(socket, msg);
+}
+
+/* ============================================================================
+ * CONFIGURATION À L'EXÉCUTION (FICHIER, OPTIONS, RECHARGEMENT SUR SIGHUP)
+ * ============================================================================ */
+
+#define CONFIG_INT_KEY(key, field, lo, hi, reload) \
+    {key, CONFIG_INT, offsetof(server_config_t, field), lo, hi, reload, NULL}
+static const config_key_t config_keys[] = {
+    CONFIG_INT_KEY("port", port, 1, 65535, 0),
+    CONFIG_INT_KEY("max_clients", max_clients, 1, 1000000, 1),
+    CONFIG_INT_KEY("max_connections_per_ip", max_per_ip, 1, 1000000, 1),
+    CONFIG_INT_KEY("guess_rate", guess_rate, 1, 1000000, 1),
+    CONFIG_INT_KEY("guess_burst", guess_burst, 1, 1000000, 1),
+    CONFIG_INT_KEY("stats_rate", stats_rate, 1, 1000000, 1),
+    CONFIG_INT_KEY("stats_burst", stats_burst, 1, 1000000, 1),
+    CONFIG_INT_KEY("resume_ttl", resume_ttl, 1, 86400, 1),
+    CONFIG_INT_KEY("round_window_ms", round_window_ms, 100, 3600000, 1),
+    CONFIG_INT_KEY("drain_timeout", drain_timeout, 0, 3600, 1),
+    CONFIG_INT_KEY("workers", workers, 1, WORKERS_MAX, 0),
+    CONFIG_INT_KEY("cluster_port", cluster_port, 0, 65535, 0),
+    CONFIG_INT_KEY("cluster_node", cluster_node, 0, 65535, 0),
+    {"shed_ms", CONFIG_SHED, offsetof(server_config_t, shed_ms), 0, 0, 1, SHED_ENV},
+    {"log_level", CONFIG_LOG_LEVEL, offsetof(server_config_t, log_level), 0, 0, 1, NULL},
+    {"event_log", CONFIG_TEXT, offsetof(server_config_t, event_log), 0, 0, 0, EVENTLOG_ENV},
+    {"sqlite", CONFIG_TEXT, offsetof(server_config_t, sqlite), 0, 0, 0, EXPORT_ENV},
+    {"scoring", CONFIG_SCORING, offsetof(server_config_t, scoring), 0, 0, 0, SCORING_ENV},
+    {"handoff_socket", CONFIG_TEXT, offsetof(server_config_t, handoff_socket), 0, 0, 0, NULL},
+    {"standby_socket", CONFIG_TEXT, offsetof(server_config_t, standby_socket), 0, 0, 0, NULL},
+    {"unix_socket", CONFIG_TEXT, offsetof(server_config_t, unix_socket), 0, 0, 0, NULL},
+    {"admin_socket", CONFIG_TEXT, offsetof(server_config_t, admin_socket), 0, 0, 0, NULL},
+    {"bind", CONFIG_BIND, offsetof(server_config_t, bind_addresses), 0, 0, 0, NULL},
+    CONFIG_INT_KEY("ws_port", ws_port, 0, 65535, 0),
+    CONFIG_INT_KEY("tcp_nodelay", tcp_nodelay, 0, 1, 1),
+    CONFIG_INT_KEY("tcp_quickack", tcp_quickack, 0, 1, 1),
+    CONFIG_INT_KEY("tcp_keepalive", tcp_keepalive, 0, 86400, 1),
+    CONFIG_INT_KEY("busy_poll", busy_poll, 0, 1000000, 1),
+    CONFIG_INT_KEY("tcp_defer_accept", tcp_defer_accept, 0, 3600, 0),
+    CONFIG_INT_KEY("tcp_fastopen", tcp_fastopen, 0, 65535, 0),
+    CONFIG_INT_KEY("sndbuf", sndbuf, 0, 64 * 1024 * 1024, 0),
+    CONFIG_INT_KEY("rcvbuf", rcvbuf, 0, 64 * 1024 * 1024, 0),
+    {"cluster_peers", CONFIG_TEXT, offsetof(server_config_t, cluster_peers), 0, 0, 0, NULL},
+    {"cluster_bind", CONFIG_BIND, offsetof(server_config_t, cluster_bind), 0, 0, 0, NULL},
+    {"cluster_secret", CONFIG_SECRET, offsetof(server_config_t, cluster_secret), 0, 0, 0,
+     CLUSTER_SECRET_ENV},
+};
+#undef CONFIG_INT_KEY
+
+#define CONFIG_KEY_COUNT (int)(sizeof(config_keys) / sizeof(config_keys[0]))
+
+static const char *const log_level_names[] = {"info", "warning", "error"};
+
+/**
+ * @brief Indique si un message de ce niveau doit être affiché
+ * @param level Niveau du message ("INFO", "WARNING", ...)
+ * @return 1 si le niveau atteint le seuil de la clé "log_level"
+ */
+int log_enabled(const char *level) {
+    int severity = LOG_INFO;
+    if (strcmp(level, "WARNING") == 0) {
+        severity = LOG_WARNING;
+    } else if (strcmp(level, "ERROR") == 0 || strcmp(level, "SHUTDOWN") == 0) {
+        severity = LOG_ERROR;
+    }
+    return severity >= CONFIG_GET(log_level);
+}
+
+/**
+ * @brief Cherche une clé de configuration par son nom
+ * @param name Nom de la clé
+ * @return Description de la clé, NULL si inconnue
+ */
+const config_key_t *config_find(const char *name) {
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        if (strcmp(config_keys[i].name, name) == 0) {
+            return &config_keys[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Valide et affecte une valeur à une clé
+ * @param target Configuration à modifier
+ * @param name Nom de la clé
+ * @param value Valeur textuelle
+ * @param error Message d'erreur (sortie)
+ * @param size Taille du message d'erreur
+ * @return 0 si appliquée, -1 sinon (target inchangée)
+ */
+int config_set(server_config_t *target, const char *name, const char *value,
+               char *error, size_t size) {
+    const config_key_t *key = config_find(name);
+    if (!key) {
+        snprintf(error, size, "clé inconnue \"%s\"", name);
+        return -1;
+    }
+
+    char *field = (char *)target + key->offset;
+    switch (key->kind) {
+        case CONFIG_INT: {
+            char *end;
+            errno = 0;
+            long parsed = strtol(value, &end, 10);
+            if (end == value || *end != '\0' || errno != 0 ||
+                parsed < key->min || parsed > key->max) {
+                snprintf(error, size, "%s: entier entre %d et %d attendu (\"%s\")",
+                         name, key->min, key->max, value);
+                return -1;
+            }
+            *(int *)field = (int)parsed;
+            return 0;
+        }
+        case CONFIG_SHED:
+            if (parse_shed_thresholds(value, (int *)field) < 0) {
+                snprintf(error, size, "%s: trois seuils croissants \"a,b,c\" en ms attendus "
+                         "(\"%s\")", name, value);
+                return -1;
+            }
+            return 0;
+        case CONFIG_LOG_LEVEL:
+            for (int i = LOG_INFO; i <= LOG_ERROR; i++) {
+                if (strcmp(value, log_level_names[i]) == 0) {
+                    *(int *)field = i;
+                    return 0;
+                }
+            }
+            snprintf(error, size, "%s: info, warning ou error attendu (\"%s\")", name, value);
+            return -1;
+        case CONFIG_SCORING: {
+            int policies[GAME_MODES];
+            if (parse_scoring(value, policies) < 0) {
+                snprintf(error, size, "%s: \"mode=politique,...\" attendu (modes solo, race, "
+                         "tournament) (\"%s\")", name, value);
+                return -1;
+            }
+            break;
+        }
+        case CONFIG_BIND: {
+            listener_t parsed[BIND_MAX];
+            if (bind_parse(value, PORT, parsed, BIND_MAX) < 0) {
+                snprintf(error, size, "%s: \"adresse[:port],...\" attendu (IPv4, IPv6 entre "
+                         "crochets avec un port, * = toutes), %d au plus (\"%s\")",
+                         name, BIND_MAX, value);
+                return -1;
+            }
+            break;
+        }
+        case CONFIG_TEXT:
+        case CONFIG_SECRET:
+            break;
+    }
+
+    if (strlen(value) >= CONFIG_VALUE_MAX) {
+        snprintf(error, size, "%s: valeur trop longue (%d caractères max)",
+                 name, CONFIG_VALUE_MAX - 1);
+        return -1;
+    }
+    strcpy(field, value);
+    return 0;
+}
+
+/**
+ * @brief Met en forme la valeur d'une clé (journal des changements)
+ * @param source Configuration lue
+ * @param key Clé
+ * @param out Texte (sortie)
+ * @param size Taille de out
+ */
+void config_format(const server_config_t *source, const config_key_t *key, char *out,
+                   size_t size) {
+    const char *field = (const char *)source + key->offset;
+    const int *numbers = (const int *)field;
+
+    switch (key->kind) {
+        case CONFIG_INT:
+            snprintf(out, size, "%d", numbers[0]);
+            break;
+        case CONFIG_SHED:
+            snprintf(out, size, "%d,%d,%d", numbers[0], numbers[1], numbers[2]);
+            break;
+        case CONFIG_LOG_LEVEL:
+            snprintf(out, size, "%s", log_level_names[numbers[0]]);
+            break;
+        case CONFIG_TEXT:
+        case CONFIG_SCORING:
+        case CONFIG_BIND:
+            snprintf(out, size, "%s", field[0] ? field : "(vide)");
+            break;
+        case CONFIG_SECRET:
+            snprintf(out, size, "%s", field[0] ? "(défini)" : "(vide)");
+            break;
+    }
+}
+
+/**
+ * @brief Retire les espaces en début et fin de chaîne (sur place)
+ * @param text Chaîne à nettoyer
+ * @return Début de la chaîne nettoyée
+ */
+char *trim_spaces(char *text) {
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    size_t len = strlen(text);
+    while (len > 0 && isspace((unsigned char)text[len - 1])) {
+        text[--len] = '\0';
+    }
+    return text;
+}
+
+/**
+ * @brief Lit un fichier "clé = valeur" (lignes vides et # ignorées)
+ * @param path Chemin du fichier
+ * @param target Configuration à compléter
+ * @param error Message d'erreur "fichier:ligne: ..." (sortie)
+ * @param size Taille du message d'erreur
+ * @return 0 si tout le fichier est valide, -1 sinon
+ */
+int config_load_file(const char *path, server_config_t *target, char *error, size_t size) {
+    FILE *file = fopen(path, "r");
+    if (!file) {
+        snprintf(error, size, "%s: %s", path, strerror(errno));
+        return -1;
+    }
+
+    char line[BUFFER_SIZE];
+    char reason[BUFFER_SIZE];
+    int number = 0;
+    int status = 0;
+
+    while (status == 0 && fgets(line, sizeof(line), file)) {
+        number++;
+        char *text = trim_spaces(line);
+        if (*text == '\0' || *text == '#') {
+            continue;
+        }
+
+        char *equal = strchr(text, '=');
+        if (!equal) {
+            snprintf(error, size, "%s:%d: \"clé = valeur\" attendu", path, number);
+            status = -1;
+            break;
+        }
+        *equal = '\0';
+        if (config_set(target, trim_spaces(text), trim_spaces(equal + 1),
+                       reason, sizeof(reason)) < 0) {
+            snprintf(error, size, "%s:%d: %s", path, number, reason);
+            status = -1;
+        }
+    }
+
+    fclose(file);
+    return status;
+}
+
+/**
+ * @brief Construit la configuration: défauts, fichier, environnement, options
+ * @param target Configuration construite (sortie)
+ * @param error Message d'erreur (sortie)
+ * @param size Taille du message d'erreur
+ * @return 0 si valide, -1 sinon
+ *
+ * Une variable d'environnement invalide est signalée puis ignorée, comme
+ * avant l'introduction du fichier; un fichier ou une option invalide
+ * refuse toute la configuration.
+ */
+int config_build(server_config_t *target, char *error, size_t size) {
+    char reason[BUFFER_SIZE];
+    char log[BUFFER_SIZE + 64];
+
+    *target = config_defaults;
+    if (config_path && config_load_file(config_path, target, error, size) < 0) {
+        return -1;
+    }
+
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        const char *value = config_keys[i].env ? getenv(config_keys[i].env) : NULL;
+        if (value && config_set(target, config_keys[i].name, value,
+                                reason, sizeof(reason)) < 0) {
+            snprintf(log, sizeof(log), "%s ignoré: %s", config_keys[i].env, reason);
+            log_message("WARNING", log);
+        }
+    }
+
+    for (int i = 0; i < config_override_count; i++) {
+        if (config_set(target, config_overrides[i][0], config_overrides[i][1],
+                       reason, sizeof(reason)) < 0) {
+            snprintf(error, size, "option: %s", reason);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Met en vigueur une configuration
+ * @param next Configuration validée
+ * @param startup 1 au démarrage (tout est appliqué), 0 sur SIGHUP
+ * @return Nombre de clés modifiées
+ *
+ * Sur SIGHUP, seules les clés rechargeables sont publiées (écritures
+ * atomiques champ par champ, lues sans verrou par les sessions); les
+ * autres gardent leur valeur jusqu'au redémarrage.
+ */
+int config_apply(const server_config_t *next, int startup) {
+    char before[CONFIG_VALUE_MAX];
+    char after[CONFIG_VALUE_MAX];
+    char log[2 * CONFIG_VALUE_MAX + 96];
+    int changed = 0;
+
+    if (startup) {
+        config = *next;
+        return CONFIG_KEY_COUNT;
+    }
+
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        const config_key_t *key = &config_keys[i];
+        config_format(&config, key, before, sizeof(before));
+        config_format(next, key, after, sizeof(after));
+        if (strcmp(before, after) == 0) {
+            continue;
+        }
+
+        if (!key->reloadable) {
+            snprintf(log, sizeof(log), "Configuration: %s = %s ignoré jusqu'au redémarrage "
+                     "(en vigueur: %s)", key->name, after, before);
+            log_message("WARNING", log);
+            continue;
+        }
+
+        const int *source = (const int *)((const char *)next + key->offset);
+        int *field = (int *)((char *)&config + key->offset);
+        int count = (key->kind == CONFIG_SHED) ? SHED_LEVELS : 1;
+        for (int n = 0; n < count; n++) {
+            __atomic_store_n(&field[n], source[n], __ATOMIC_RELAXED);
+        }
+
+        changed++;
+        snprintf(log, sizeof(log), "Configuration: %s %s → %s", key->name, before, after);
+        log_message("INFO", log);
+    }
+    return changed;
+}
+
+/**
+ * @brief Relit la configuration (SIGHUP, depuis signal_thread)
+ *
+ * Une configuration invalide est refusée en bloc: rien n'est appliqué.
+ */
+void config_reload(void) {
+    server_config_t next;
+    char error[BUFFER_SIZE];
+    char log[BUFFER_SIZE + 64];
+
+    if (config_build(&next, error, sizeof(error)) < 0) {
+        snprintf(log, sizeof(log), "Rechargement refusé: %s (configuration inchangée)", error);
+        log_message("ERROR", log);
+        return;
+    }
+
+    int changed = config_apply(&next, 0);
+    __atomic_add_fetch(&config_reloads, 1, __ATOMIC_RELAXED);
+    snprintf(log, sizeof(log), "Configuration rechargée (%d changement(s))", changed);
+    log_message("SUCCESS", log);
+}
+
+/**
+ * @brief Affiche l'aide de la ligne de commande
+ * @param program Nom du programme (argv[0])
+ */
+void usage(const char *program) {
+    fprintf(stderr,
+        "Usage: %s [-c fichier.conf] [-p port] [-o clé=valeur]... [-u socket | -r socket]\n"
+        "  -c fichier     fichier \"clé = valeur\" (relu sur SIGHUP)\n"
+        "  -p port        port d'écoute (équivaut à -o port=N)\n"
+        "  -o clé=valeur  surcharge une clé (prioritaire sur le fichier)\n"
+        "  -u socket      bascule à chaud: reprend l'écoute et les sessions du\n"
+        "                 serveur lancé avec handoff_socket=socket\n"
+        "  -r socket      réplique de secours du serveur lancé avec\n"
+        "                 standby_socket=socket; prend son port s'il s'arrête\n"
+        "  -h             cette aide\n"
+        "Clés:", program);
+    for (int i = 0; i < CONFIG_KEY_COUNT; i++) {
+        fprintf(stderr, " %s%s", config_keys[i].name, config_keys[i].reloadable ? "" : "*");
+    }
+    fprintf(stderr, "\n(* = lue au démarrage uniquement)\n");
+}
+
+/* ============================================================================
+ * ARRÊT PROGRESSIF ET RÉCEPTION DES SIGNAUX
+ * ============================================================================ */
+
+/**
+ * @brief Indique si l'arrêt du serveur est en cours
+ * @return 1 après SIGINT / SIGTERM, 0 sinon
+ */
+int drain_active(void) {
+    return __atomic_load_n(&drain.active, __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief Lance l'arrêt progressif (signal_thread, ou main après une bascule)
+ * @param reason Cause journalisée ("Signal 15 reçu", ...)
+ *
+ * L'écoute est interrompue (accept échoue dans main), puis chaque session
+ * et chaque spectateur reçoit "server_shutdown" avec le délai restant.
+ * Les sessions sans partie en cours se ferment aussitôt (wait_message).
+ * Après une bascule, les écoutes transmises sont déjà fermées ici (aucune
+ * n'est interrompue).
+ */
+void drain_start(const char *reason) {
+    int timeout_ms = CONFIG_GET(drain_timeout) * 1000;
+    char log[160];
+
+    drain.started_ms = monotonic_ms();
+    drain.deadline_ms = drain.started_ms + timeout_ms;
+    __atomic_store_n(&drain.active, 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&clients_mutex);
+    int open = active_clients;
+    pthread_mutex_unlock(&clients_mutex);
+    snprintf(log, sizeof(log),
+        "%s: arrêt progressif (%d session(s), échéance %d s)",
+        reason, open, timeout_ms / 1000);
+    log_message("SHUTDOWN", log);
+
+    for (int i = 0; i < listener_count; i++) {
+        shutdown(listeners[i].fd, SHUT_RD);
+    }
+
+    payload_t *notice = payload_printf(
+        "{\"type\":\"server_shutdown\",\"message\":\"Arret du serveur: terminez votre partie\","
+        "\"deadline_ms\":%d}\n", timeout_ms);
+    if (!notice) {
+        return;
+    }
+    pthread_mutex_lock(&clients_mutex);
+    for (client_data_t *client = sessions; client; client = client->next_session) {
+        outbox_push(client, notice);
+    }
+    pthread_mutex_unlock(&clients_mutex);
+    spectator_publish(notice);
+    payload_release(notice);
+}
+
+/**
+ * @brief Attend la fin des sessions puis vide les journaux (thread principal)
+ *
+ * Les sessions se ferment d'elles-mêmes à l'échéance; au-delà de
+ * DRAIN_GRACE_MS, les retardataires sont abandonnés. Les parties déjà
+ * déposées sont ensuite appliquées, exportées et journalisées.
+ */
+void drain_wait(void) {
+    char log[160];
+    int64_t last_report = 0;
+
+    while (1) {
+        pthread_mutex_lock(&clients_mutex);
+        int open = active_clients;
+        pthread_mutex_unlock(&clients_mutex);
+
+        int64_t now = monotonic_ms();
+        if (open == 0 || now >= drain.deadline_ms + DRAIN_GRACE_MS) {
+            if (open > 0) {
+                snprintf(log, sizeof(log), "Arrêt: %d session(s) abandonnée(s)", open);
+                log_message("WARNING", log);
+            }
+            break;
+        }
+        if (now - last_report >= 1000) {
+            int64_t left = drain.deadline_ms - now;
+            snprintf(log, sizeof(log), "Arrêt: %d session(s) en cours, %lld s restantes",
+                     open, (long long)(left > 0 ? (left + 999) / 1000 : 0));
+            log_message("SHUTDOWN", log);
+            last_report = now;
+        }
+        usleep(50000);
+    }
+
+    scoreboard_barrier(NULL);
+    if (export_close() < 0) {
+        log_message("ERROR", "Arrêt: export SQLite incomplet");
+    }
+    if (event_log_close() < 0) {
+        log_message("ERROR", "Arrêt: journal d'événements incomplet");
+    }
+    shm_export_board(scoreboard.published);
+
+    snprintf(log, sizeof(log),
+        "Arrêt terminé en %lld ms (%lu session(s) terminée(s), %lu fermée(s))",
+        (long long)(monotonic_ms() - drain.started_ms),
+        __atomic_load_n(&drain.finished, __ATOMIC_RELAXED),
+        __atomic_load_n(&drain.closed, __ATOMIC_RELAXED));
+    log_message("SHUTDOWN", log);
+}
+
+/**
+ * @brief Thread des signaux: SIGHUP recharge, SIGINT / SIGTERM arrêtent
+ * @param arg Non utilisé
+ * @return NULL
+ *
+ * Ces signaux sont bloqués dans tous les threads (masque hérité de main)
+ * et attendus ici par sigwait: rechargement et arrêt s'exécutent hors
+ * gestionnaire de signal. Un second signal d'arrêt termine immédiatement.
+ */
+void *signal_thread(void *arg) {
+    (void)arg;
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGHUP);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+
+    while (1) {
+        int sig;
+        if (sigwait(&set, &sig) != 0) {
+            continue;
+        }
+
+        if (sig == SIGHUP) {
+            config_reload();
+        } else if (!drain_active()) {
+            char reason[32];
+            snprintf(reason, sizeof(reason), "Signal %d reçu", sig);
+            drain_start(reason);
+        } else {
+            log_message("SHUTDOWN", "Second signal d'arrêt: arrêt immédiat");
+            server_exit(EXIT_FAILURE);
+        }
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * BASCULE À CHAUD (TRANSMISSION DES SOCKETS PAR SCM_RIGHTS)
+ * ============================================================================ */
+
+/**
+ * @brief Ouvre un socket Unix local (bascule, réplique de secours, jeu)
+ * @param path Chemin du socket (remplacé s'il existe)
+ * @param type SOCK_SEQPACKET ou SOCK_STREAM, avec drapeaux SOCK_*
+ * @param mode Droits d'accès du chemin
+ * @param backlog File d'attente de listen
+ * @return Descripteur d'écoute, -1 en cas d'erreur (errno conservé)
+ */
+int local_listen(const char *path, int type, mode_t mode, int backlog) {
+    struct sockaddr_un addr;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        errno = ENAMETOOLONG;
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    int listener = socket(AF_UNIX, type, 0);
+    if (listener < 0) {
+        return -1;
+    }
+    unlink(path);
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+        chmod(path, mode) < 0 || listen(listener, backlog) < 0) {
+        int saved = errno;
+        close(listener);
+        errno = saved;
+        return -1;
+    }
+
+    return listener;
+}
+
+/**
+ * @brief Ouvre le socket où un nouveau binaire peut demander la bascule
+ * @param path Chemin du socket Unix
+ * @return 0 si succès, -1 sinon
+ */
+int handoff_listen(const char *path) {
+    handoff.listener = local_listen(path, SOCK_SEQPACKET | SOCK_CLOEXEC, 0600, 1);
+    return (handoff.listener < 0) ? -1 : 0;
+}
+
+/**
+ * @brief Envoie un message de la bascule, avec un descripteur facultatif
+ * @param channel Socket Unix (SOCK_SEQPACKET: un message par appel)
+ * @param data Contenu
+ * @param len Taille du contenu
+ * @param fd Descripteur transmis par SCM_RIGHTS (-1 = aucun)
+ * @return 0 si succès, -1 sinon
+ */
+int handoff_send(int channel, const void *data, size_t len, int fd) {
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = { .iov_base = (void *)data, .iov_len = len };
+    struct msghdr msg = { .msg_iov = &iov, .msg_iovlen = 1 };
+
+    if (fd >= 0) {
+        memset(control, 0, sizeof(control));
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+    }
+
+    return (sendmsg(channel, &msg, MSG_NOSIGNAL) == (ssize_t)len) ? 0 : -1;
+}
+
+/**
+ * @brief Reçoit un message de la bascule de taille exacte
+ * @param channel Socket Unix
+ * @param data Buffer de réception
+ * @param len Taille attendue
+ * @param fd Descripteur reçu (-1 si absent), NULL si aucun n'est attendu
+ * @return 0 si succès, -1 si erreur, délai dépassé ou message inattendu
+ */
+int handoff_recv(int channel, void *data, size_t len, int *fd) {
+    char control[CMSG_SPACE(sizeof(int))];
+    struct iovec iov = { .iov_base = data, .iov_len = len };
+    struct msghdr msg = {
+        .msg_iov = &iov, .msg_iovlen = 1,
+        .msg_control = control, .msg_controllen = sizeof(control)
+    };
+    int received = -1;
+
+    ssize_t got = recvmsg(channel, &msg, MSG_CMSG_CLOEXEC);
+    if (got < 0) {
+        return -1;
+    }
+    for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            memcpy(&received, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+
+    if (got != (ssize_t)len || (msg.msg_flags & (MSG_TRUNC | MSG_CTRUNC))) {
+        if (received >= 0) {
+            close(received);
+        }
+        return -1;
+    }
+    if (fd) {
+        *fd = received;
+    } else if (received >= 0) {
+        close(received);
+    }
+    return 0;
+}
+
+/**
+ * @brief Met la session en attente de transmission (thread de la session)
+ * @param client Session hors salon, boîte d'envoi vidée
+ * @return 0 si la session sera transmise (socket confié), -1 sinon
+ *
+ * Refusé une fois la liste close par handoff_serve (handoff.requested
+ * repassé à 0): la session continue alors normalement.
+ */
+int handoff_collect(client_data_t *client) {
+    int collected = -1;
+
+    pthread_mutex_lock(&handoff.mutex);
+    if (handoff.requested && handoff.count == handoff.capacity) {
+        int capacity = handoff.capacity ? handoff.capacity * 2 : 16;
+        handoff_entry_t *grown = realloc(handoff.entries, capacity * sizeof(*grown));
+        if (grown) {
+            handoff.entries = grown;
+            handoff.capacity = capacity;
+        }
+    }
+    if (handoff.requested && handoff.count < handoff.capacity) {
+        handoff_entry_t *entry = &handoff.entries[handoff.count++];
+        memset(entry, 0, sizeof(*entry));
+        entry->state.client_id = client->client_id;
+        entry->state.level = (int32_t)(client->level - difficulties);
+        entry->state.attempts = client->attempts;
+        entry->state.playing = client->playing;
+        entry->state.target_number = client->target_number;
+        entry->state.start_time = (int64_t)client->start_time;
+        entry->state.resume_token = client->resume_token;
+        memcpy(entry->state.addr, &client->address.sin6_addr, sizeof(entry->state.addr));
+        entry->state.port = client->address.sin6_port;
+        entry->state.websocket = websocket_state(client->socket) == WEBSOCKET_OPEN;
+        memcpy(entry->state.name, client->name, MAX_NAME_LENGTH);
+        entry->socket = client->socket;
+
+        client->socket = -1;
+        client->handed_over = 1;
+        collected = 0;
+    }
+    pthread_mutex_unlock(&handoff.mutex);
+
+    return collected;
+}
+
+/**
+ * @brief Sérialise une partie suspendue (bascule, réplique)
+ * @param slot Emplacement occupé de la table de reprise
+ * @param entry État transmis
+ */
+void parked_serialize(const parked_session_t *slot, handoff_parked_t *entry) {
+    memset(entry, 0, sizeof(*entry));
+    entry->token = slot->token;
+    entry->start_time = (int64_t)slot->start_time;
+    entry->target_number = slot->target_number;
+    entry->level = (int32_t)(slot->level - difficulties);
+    entry->attempts = slot->attempts;
+    memcpy(entry->name, slot->name, MAX_NAME_LENGTH);
+}
+
+/**
+ * @brief Copie les parties suspendues encore valides (verrou de la table tenu)
+ * @param parked Tableau de RESUME_SLOTS entrées
+ * @return Nombre de parties copiées
+ */
+int parked_collect(handoff_parked_t *parked) {
+    int count = 0;
+    time_t now = time(NULL);
+
+    for (int i = 0; i < RESUME_SLOTS; i++) {
+        const parked_session_t *slot = &resume_table->slots[i];
+        if (slot->token != 0 && slot->expires > now) {
+            parked_serialize(slot, &parked[count++]);
+        }
+    }
+    return count;
+}
+
+/**
+ * @brief Relance une session transmise dans ce processus (nouveau thread)
+ * @param state État sérialisé
+ * @param socket Socket du client
+ * @return 0 si succès, -1 sinon (socket fermé)
+ */
+int session_adopt(const handoff_session_t *state, int socket) {
+    client_data_t *client = calloc(1, sizeof(client_data_t));
+    if (!client || (state->websocket && socket >= websockets.size)) {
+        close(socket);
+        free(client);
+        return -1;
+    }
+    websocket_set(socket, state->websocket ? WEBSOCKET_OPEN : WEBSOCKET_NONE);
+
+    int level = (state->level >= 0 && state->level < DIFFICULTY_LEVELS) ? state->level : 0;
+    client->socket = socket;
+    client->client_id = state->client_id;
+    client->address.sin6_family = AF_INET6;
+    memcpy(&client->address.sin6_addr, state->addr, sizeof(state->addr));
+    client->address.sin6_port = state->port;
+    client->level = &difficulties[level];
+    client->attempts = state->attempts;
+    client->target_number = state->target_number;
+    client->start_time = (time_t)state->start_time;
+    client->resume_token = state->resume_token;
+    memcpy(client->name, state->name, MAX_NAME_LENGTH);
+    client->name[MAX_NAME_LENGTH - 1] = '\0';
+    client->playing = state->playing;
+    client->adopted = 1;
+    // Options déjà posées par l'ancien processus, seul le réarmement est à reprendre
+    int domain = AF_UNIX;
+    socklen_t domain_len = sizeof(domain);
+    getsockopt(socket, SOL_SOCKET, SO_DOMAIN, &domain, &domain_len);
+    client->quickack = domain != AF_UNIX && CONFIG_GET(tcp_quickack);
+    // NULL: pair local, limite dépassée ou table pleine, session gardée sans suivi
+    client->ip = NULL;
+    if (!is_loopback(&client->address)) {
+        ip_acquire(&client->address, &client->ip);
+    }
+
+    pthread_t thread_id;
+    if (pthread_create(&thread_id, NULL, handle_client, client) != 0) {
+        close(socket);
+        ip_release(client->ip);
+        free(client);
+        return -1;
+    }
+    pthread_detach(thread_id);
+    return 0;
+}
+
+/**
+ * @brief Transmet l'écoute, les sessions et le leaderboard au nouveau processus
+ * @param next_client_id Dernier identifiant de session attribué
+ * @return 0 si le nouveau processus a tout repris, -1 sinon (service conservé)
+ *
+ * Déroulement (thread principal, accept suspendu):
+ *   1. les sessions hors salon se mettent en attente (wait_message)
+ *   2. envoi de l'en-tête et des écoutes TCP (puis du socket Unix de jeu),
+ *      de chaque session avec son socket, puis des parties suspendues
+ *   3. attente de HANDOFF_READY; en cas d'échec, les sessions sont relancées ici
+ *   4. leaderboard appliqué, export et journal vidés puis fermés, envoi du
+ *      leaderboard au nouveau processus, qui ouvre alors journal et export
+ * Les salons, tournois et spectateurs restent dans ce processus jusqu'à la
+ * fin de leur partie (arrêt progressif lancé par main).
+ */
+int handoff_serve(int next_client_id) {
+    char log[160];
+    int channel = accept(handoff.listener, NULL, NULL);
+    if (channel < 0) {
+        return -1;
+    }
+
+    // Seul le même utilisateur peut reprendre les sockets
+    struct ucred peer;
+    socklen_t peer_len = sizeof(peer);
+    if (getsockopt(channel, SOL_SOCKET, SO_PEERCRED, &peer, &peer_len) < 0 ||
+        peer.uid != getuid() || drain_active()) {
+        log_message("WARNING", "Bascule refusée (autre utilisateur ou arrêt en cours)");
+        close(channel);
+        return -1;
+    }
+    struct timeval timeout = { HANDOFF_TIMEOUT_MS / 1000, (HANDOFF_TIMEOUT_MS % 1000) * 1000 };
+    setsockopt(channel, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(channel, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    snprintf(log, sizeof(log), "Bascule demandée par le processus %d", (int)peer.pid);
+    log_message("SHUTDOWN", log);
+
+    // 1. Mise en attente des sessions hors salon (réveil par leur boîte d'envoi)
+    __atomic_store_n(&handoff.requested, 1, __ATOMIC_RELEASE);
+    uint64_t one = 1;
+    pthread_mutex_lock(&clients_mutex);
+    for (client_data_t *client = sessions; client; client = client->next_session) {
+        ssize_t ignored = write(client->outbox.wake_fd, &one, sizeof(one));
+        (void)ignored;
+    }
+    pthread_mutex_unlock(&clients_mutex);
+
+    int64_t deadline = monotonic_ms() + HANDOFF_WAIT_MS;
+    while (monotonic_ms() < deadline) {
+        int waiting = 0;
+        pthread_mutex_lock(&clients_mutex);
+        for (client_data_t *client = sessions; client; client = client->next_session) {
+            waiting += (!client->handed_over && !__atomic_load_n(&client->room, __ATOMIC_RELAXED));
+        }
+        pthread_mutex_unlock(&clients_mutex);
+        if (waiting == 0) {
+            break;
+        }
+        usleep(10000);
+    }
+
+    // Liste close: une session retardataire reste dans ce processus
+    pthread_mutex_lock(&handoff.mutex);
+    __atomic_store_n(&handoff.requested, 0, __ATOMIC_RELEASE);
+    handoff_entry_t *entries = handoff.entries;
+    int count = handoff.count;
+    handoff.entries = NULL;
+    handoff.count = handoff.capacity = 0;
+    pthread_mutex_unlock(&handoff.mutex);
+
+    // Parties suspendues encore valides
+    handoff_parked_t parked[RESUME_SLOTS];
+    shared_lock(&resume_table->mutex);
+    int parked_count = parked_collect(parked);
+    pthread_mutex_unlock(&resume_table->mutex);
+
+    // 2. En-tête et écoutes, sessions, parties suspendues
+    handoff_hello_t hello = {
+        .magic = HANDOFF_MAGIC, .version = HANDOFF_VERSION,
+        .session_size = sizeof(handoff_session_t), .parked_size = sizeof(handoff_parked_t),
+        .session_count = count, .parked_count = parked_count,
+        .next_client_id = next_client_id, .total_served = total_clients_served,
+        .listener_count = listener_count, .local_listener = (local_socket >= 0)
+    };
+    for (int i = 0; i < listener_count; i++) {
+        hello.websocket_listeners |= listeners[i].websocket << i;
+    }
+    int status = handoff_send(channel, &hello, sizeof(hello), listeners[0].fd);
+    for (int32_t i = 1; i < listener_count && status == 0; i++) {
+        status = handoff_send(channel, &i, sizeof(i), listeners[i].fd);
+    }
+    if (status == 0 && hello.local_listener) {
+        status = handoff_send(channel, &hello.local_listener, sizeof(hello.local_listener),
+                              local_socket);
+    }
+    for (int i = 0; i < count && status == 0; i++) {
+        status = handoff_send(channel, &entries[i].state, sizeof(entries[i].state),
+                              entries[i].socket);
+    }
+    if (status == 0 && parked_count > 0) {
+        status = handoff_send(channel, parked, parked_count * sizeof(parked[0]), -1);
+    }
+
+    // 3. Accusé de réception, sinon reprise locale des sessions
+    uint32_t ready = 0;
+    if (status == 0) {
+        status = handoff_recv(channel, &ready, sizeof(ready), NULL);
+    }
+    if (status < 0 || ready != HANDOFF_READY) {
+        close(channel);
+        snprintf(log, sizeof(log),
+            "Bascule échouée: %d session(s) reprise(s) par ce processus", count);
+        log_message("ERROR", log);
+        for (int i = 0; i < count; i++) {
+            session_adopt(&entries[i].state, entries[i].socket);
+        }
+        free(entries);
+        return -1;
+    }
+
+    // 4. Dernier état du leaderboard; journal et export fermés avant leur
+    //    réouverture par le nouveau processus (segment partagé cédé aussi)
+    prad_board_file_t *board = calloc(1, sizeof(prad_board_file_t));
+    __atomic_store_n(&shm_board, NULL, __ATOMIC_RELEASE);
+    scoreboard_barrier(board);
+    if (export_close() < 0) {
+        log_message("ERROR", "Bascule: export SQLite incomplet");
+    }
+    if (event_log_close() < 0) {
+        log_message("ERROR", "Bascule: journal d'événements incomplet");
+    }
+    __atomic_store_n(&export_queue.enabled, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&event_log.enabled, 0, __ATOMIC_RELAXED);
+    if (!board || handoff_send(channel, board, sizeof(*board), -1) < 0) {
+        log_message("ERROR", "Bascule: leaderboard non transmis");
+    }
+    free(board);
+
+    for (int i = 0; i < count; i++) {
+        close(entries[i].socket);
+    }
+    free(entries);
+    close(channel);
+    close(handoff.listener);
+    handoff.listener = -1;
+    __atomic_store_n(&handoff.sent, (unsigned long)count, __ATOMIC_RELAXED);
+
+    snprintf(log, sizeof(log),
+        "Bascule terminée: écoute, %d session(s) et %d partie(s) suspendue(s) transmises",
+        count, parked_count);
+    log_message("SUCCESS", log);
+    return 0;
+}
+
+/**
+ * @brief Reprend l'écoute et les sessions d'un processus en cours (option -u)
+ * @param path Socket Unix de l'ancien processus
+ * @param next_client_id Dernier identifiant attribué (sortie)
+ * @return 0 si succès (listeners et local_socket reçus, sessions dans
+ *         handoff.entries), -1 sinon
+ *
+ * Appelé avant la création des threads: le leaderboard reçu est appliqué
+ * directement et les sessions sont relancées par main (session_adopt) une
+ * fois le journal et l'export ouverts. Un échec avant HANDOFF_READY laisse
+ * l'ancien processus servir ses clients.
+ */
+int handoff_receive(const char *path, int *next_client_id) {
+    struct sockaddr_un addr;
+    handoff_hello_t hello;
+    char log[160];
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    int channel = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    if (channel < 0) {
+        return -1;
+    }
+    if (connect(channel, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        close(channel);
+        return -1;
+    }
+    // L'ancien processus attend d'abord ses sessions (HANDOFF_WAIT_MS)
+    int wait_ms = HANDOFF_WAIT_MS + HANDOFF_TIMEOUT_MS;
+    struct timeval timeout = { wait_ms / 1000, (wait_ms % 1000) * 1000 };
+    setsockopt(channel, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(channel, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    int listen_fd = -1;
+    if (handoff_recv(channel, &hello, sizeof(hello), &listen_fd) < 0 || listen_fd < 0 ||
+        hello.magic != HANDOFF_MAGIC || hello.version != HANDOFF_VERSION ||
+        hello.session_size != sizeof(handoff_session_t) ||
+        hello.parked_size != sizeof(handoff_parked_t) ||
+        hello.session_count < 0 || hello.parked_count < 0 || hello.parked_count > RESUME_SLOTS ||
+        hello.listener_count < 1 || hello.listener_count > LISTENERS_MAX) {
+        log_message("ERROR", "Bascule: en-tête invalide (versions différentes ?)");
+        if (listen_fd >= 0) {
+            close(listen_fd);
+        }
+        close(channel);
+        return -1;
+    }
+
+    handoff_entry_t *entries = calloc(hello.session_count ? hello.session_count : 1,
+                                      sizeof(handoff_entry_t));
+    handoff_parked_t parked[RESUME_SLOTS];
+    int listen_fds[LISTENERS_MAX] = { listen_fd };
+    int listen_received = 1;
+    int32_t marker = 0;
+    int local_fd = -1;
+    int received = 0;
+    int status = entries ? 0 : -1;
+    for (; listen_received < hello.listener_count && status == 0; listen_received++) {
+        listen_fds[listen_received] = -1;
+        status = handoff_recv(channel, &marker, sizeof(marker), &listen_fds[listen_received]);
+        if (status == 0 && listen_fds[listen_received] < 0) {
+            status = -1;
+        }
+    }
+    if (status == 0 && hello.local_listener &&
+        (handoff_recv(channel, &marker, sizeof(marker), &local_fd) < 0 || local_fd < 0)) {
+        status = -1;
+    }
+    for (; received < hello.session_count && status == 0; received++) {
+        entries[received].socket = -1;
+        status = handoff_recv(channel, &entries[received].state, sizeof(handoff_session_t),
+                              &entries[received].socket);
+        if (status == 0 && entries[received].socket < 0) {
+            status = -1;
+        }
+    }
+    if (status == 0 && hello.parked_count > 0) {
+        status = handoff_recv(channel, parked, hello.parked_count * sizeof(parked[0]), NULL);
+    }
+    uint32_t ready = HANDOFF_READY;
+    if (status == 0) {
+        status = handoff_send(channel, &ready, sizeof(ready), -1);
+    }
+    if (status < 0) {
+        log_message("ERROR", "Bascule: transmission interrompue");
+        for (int i = 0; i < received && entries; i++) {
+            if (entries[i].socket >= 0) {
+                close(entries[i].socket);
+            }
+        }
+        free(entries);
+        if (local_fd >= 0) {
+            close(local_fd);
+        }
+        for (int i = 0; i < listen_received; i++) {
+            if (listen_fds[i] >= 0) {
+                close(listen_fds[i]);
+            }
+        }
+        close(channel);
+        return -1;
+    }
+
+    // Sessions acquises: sans leaderboard, le service continue à vide
+    prad_board_file_t *board = malloc(sizeof(prad_board_file_t));
+    char error[256];
+    if (!board || handoff_recv(channel, board, sizeof(*board), NULL) < 0) {
+        log_message("WARNING", "Bascule: leaderboard non reçu, démarrage à vide");
+    } else if (board_validate(board, error, sizeof(error)) < 0) {
+        snprintf(log, sizeof(log), "Bascule: leaderboard ignoré (%.100s)", error);
+        log_message("WARNING", log);
+    } else {
+        board_replace(board);
+    }
+    free(board);
+    close(channel);
+
+    // Parties suspendues (durée de validité recomptée à partir de maintenant)
+    for (int i = 0; i < hello.parked_count; i++) {
+        client_data_t restored;
+        memset(&restored, 0, sizeof(restored));
+        int level = parked[i].level;
+        restored.resume_token = parked[i].token;
+        restored.start_time = (time_t)parked[i].start_time;
+        restored.target_number = parked[i].target_number;
+        restored.level = &difficulties[(level >= 0 && level < DIFFICULTY_LEVELS) ? level : 0];
+        restored.attempts = parked[i].attempts;
+        memcpy(restored.name, parked[i].name, MAX_NAME_LENGTH);
+        park_session(&restored);
+    }
+
+    // Écoutes reprises telles quelles (adresses de l'ancien processus)
+    for (int i = 0; i < hello.listener_count; i++) {
+        listener_t *entry = &listeners[i];
+        socklen_t addr_len = sizeof(entry->addr);
+        int v6_only = 1;
+        socklen_t opt_len = sizeof(v6_only);
+        entry->fd = listen_fds[i];
+        getsockname(entry->fd, (struct sockaddr *)&entry->addr, &addr_len);
+        entry->dual_stack = entry->addr.ss_family == AF_INET6 &&
+            getsockopt(entry->fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6_only, &opt_len) == 0 &&
+            !v6_only;
+        entry->websocket = (hello.websocket_listeners >> i) & 1;
+    }
+    listener_count = hello.listener_count;
+    if (local_fd >= 0 && !config.unix_socket[0]) {
+        close(local_fd); // Clé retirée: le proxy se rabat sur TCP
+        local_fd = -1;
+    }
+    local_socket = local_fd;
+    total_clients_served = hello.total_served;
+    *next_client_id = hello.next_client_id;
+    handoff.entries = entries;
+    handoff.count = hello.session_count;
+    handoff.capacity = hello.session_count;
+
+    snprintf(log, sizeof(log),
+        "Bascule reçue: écoute, %d session(s) et %d partie(s) suspendue(s)",
+        hello.session_count, hello.parked_count);
+    log_message("SUCCESS", log);
+    return 0;
+}
+
+/* ============================================================================
+ * WORKERS MULTI-PROCESSUS (SO_REUSEPORT, LEADERBOARD PARTAGÉ)
+ * ============================================================================ */
+
+/**
+ * @brief Verrouille un mutex éventuellement partagé entre processus
+ * @param mutex Mutex (robuste en mode workers)
+ * @return 0, ou 1 si le détenteur précédent est mort (état rendu cohérent)
+ */
+int shared_lock(pthread_mutex_t *mutex) {
+    if (pthread_mutex_lock(mutex) != EOWNERDEAD) {
+        return 0;
+    }
+    pthread_mutex_consistent(mutex);
+    log_message("WARNING", "Verrou partagé repris après la mort d'un worker");
+    return 1;
+}
+
+/**
+ * @brief Crée le segment partagé des workers (superviseur, avant fork)
+ * @param count Nombre de workers
+ * @return 0 si succès, -1 sinon
+ *
+ * Le segment reçoit l'état courant du leaderboard et remplace la table de
+ * reprise: une partie suspendue peut être reprise par n'importe quel worker.
+ */
+int workers_init(int count) {
+    workers_shared_t *shared = mmap(NULL, sizeof(workers_shared_t), PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) {
+        return -1;
+    }
+    memset(shared, 0, sizeof(*shared));
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    if (pthread_mutex_init(&shared->board_mutex, &attr) != 0 ||
+        pthread_mutex_init(&shared->resume.mutex, &attr) != 0) {
+        pthread_mutexattr_destroy(&attr);
+        munmap(shared, sizeof(*shared));
+        return -1;
+    }
+    pthread_mutexattr_destroy(&attr);
+
+    memcpy(shared->copies[0].boards, leaderboards, sizeof(leaderboards));
+    shared->copies[0].stats = global_stats;
+    shared->generation = 1;
+
+    workers.count = count;
+    workers.shared = shared;
+    resume_table = &shared->resume;
+    return 0;
+}
+
+/**
+ * @brief Recopie la copie partagée si un worker l'a modifiée (board_mutex tenu)
+ *
+ * Thread propriétaire du leaderboard uniquement.
+ */
+void board_share_pull(void) {
+    workers_shared_t *shared = workers.shared;
+    if (shared->generation == workers.seen) {
+        return;
+    }
+    const shared_board_t *copy = &shared->copies[shared->current];
+    memcpy(leaderboards, copy->boards, sizeof(leaderboards));
+    global_stats = copy->stats;
+    workers.seen = shared->generation;
+}
+
+/**
+ * @brief Publie l'état local dans la copie inactive puis la rend valide (board_mutex tenu)
+ */
+void board_share_push(void) {
+    workers_shared_t *shared = workers.shared;
+    int next = 1 - shared->current;
+
+    memcpy(shared->copies[next].boards, leaderboards, sizeof(leaderboards));
+    shared->copies[next].stats = global_stats;
+    __atomic_store_n(&shared->current, next, __ATOMIC_RELEASE);
+    __atomic_store_n(&shared->generation, shared->generation + 1, __ATOMIC_RELEASE);
+    workers.seen = shared->generation;
+}
+
+/**
+ * @brief Reprend les parties enregistrées par les autres workers
+ * @return 1 si l'état local a changé (nouvel instantané à publier), 0 sinon
+ */
+int board_share_refresh(void) {
+    workers_shared_t *shared = workers.shared;
+    if (!shared || __atomic_load_n(&shared->generation, __ATOMIC_ACQUIRE) == workers.seen) {
+        return 0;
+    }
+    shared_lock(&shared->board_mutex);
+    board_share_pull();
+    pthread_mutex_unlock(&shared->board_mutex);
+    return 1;
+}
+
+/**
+ * @brief Publie les compteurs de sessions du worker (clients_mutex tenu)
+ */
+void worker_account(void) {
+    if (!workers.shared) {
+        return;
+    }
+    worker_slot_t *slot = &workers.shared->slots[workers.index];
+    __atomic_store_n(&slot->active, active_clients, __ATOMIC_RELAXED);
+    __atomic_store_n(&slot->served, total_clients_served, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Lance les workers puis les surveille (processus superviseur)
+ * @return Index du worker, dans chaque worker; le superviseur ne revient pas
+ *
+ * Le superviseur ne crée aucun thread: il transmet SIGHUP et les signaux
+ * d'arrêt aux workers et relance (après WORKER_RESPAWN_MS s'il est mort
+ * au démarrage) tout worker terminé hors arrêt. Seules les sessions du
+ * worker mort sont perdues.
+ */
+int workers_start(void) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGHUP);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+    sigaddset(&set, SIGCHLD);
+    pthread_sigmask(SIG_BLOCK, &set, NULL);
+
+    pid_t supervisor = getpid();
+    int stopping = 0;
+    int failed = 0;
+    int alive = 0;
+    char log[160];
+
+    while (1) {
+        // Workers manquants: démarrage, puis relances
+        for (int i = 0; i < workers.count && !stopping; i++) {
+            worker_slot_t *slot = &workers.shared->slots[i];
+            if (slot->pid != 0) {
+                continue;
+            }
+            int64_t started = monotonic_ms();
+            fflush(stdout);
+            pid_t pid = fork();
+            if (pid == 0) {
+                // Worker: arrêt progressif si le superviseur disparaît
+                prctl(PR_SET_PDEATHSIG, SIGTERM);
+                if (getppid() != supervisor) {
+                    exit(EXIT_FAILURE);
+                }
+                workers.index = i;
+                seed_random();
+                srand((unsigned int)(time(NULL) ^ getpid()));
+                return i;
+            }
+            if (pid < 0) {
+                log_message("ERROR", "Création d'un worker impossible: arrêt");
+                stopping = 1;
+                failed = 1;
+                for (int j = 0; j < workers.count; j++) {
+                    if (workers.shared->slots[j].pid > 0) {
+                        kill(workers.shared->slots[j].pid, SIGTERM);
+                    }
+                }
+                break;
+            }
+            slot->pid = pid;
+            slot->started_ms = started;
+            alive++;
+        }
+        if (stopping && alive == 0) {
+            break;
+        }
+
+        int sig;
+        if (sigwait(&set, &sig) != 0) {
+            continue;
+        }
+        if (sig == SIGHUP || sig == SIGINT || sig == SIGTERM) {
+            stopping |= (sig != SIGHUP);
+            for (int i = 0; i < workers.count; i++) {
+                if (workers.shared->slots[i].pid > 0) {
+                    kill(workers.shared->slots[i].pid, sig);
+                }
+            }
+            continue;
+        }
+
+        // SIGCHLD: emplacements libérés, relancés au tour suivant sauf à l'arrêt
+        int status;
+        pid_t pid;
+        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
+            for (int i = 0; i < workers.count; i++) {
+                worker_slot_t *slot = &workers.shared->slots[i];
+                if (slot->pid != pid) {
+                    continue;
+                }
+                int64_t lived = monotonic_ms() - slot->started_ms;
+                memset(slot, 0, sizeof(*slot));
+                alive--;
+                if (stopping) {
+                    failed |= (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS);
+                    break;
+                }
+                snprintf(log, sizeof(log), "Worker %d (pid %d) terminé (%s %d): relance", i,
+                         (int)pid, WIFSIGNALED(status) ? "signal" : "code",
+                         WIFSIGNALED(status) ? WTERMSIG(status) : WEXITSTATUS(status));
+                log_message("ERROR", log);
+                workers.shared->respawns++;
+                if (lived < WORKER_RESPAWN_MS) {
+                    usleep(WORKER_RESPAWN_MS * 1000);
+                }
+            }
+        }
+    }
+
+    snprintf(log, sizeof(log), "Superviseur: %d worker(s) arrêté(s)", workers.count);
+    log_message("SHUTDOWN", log);
+    exit(failed ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/* ============================================================================
+ * RÉPLICATION ENTRE NŒUDS (BAVARDAGE PAR DELTAS SUR TCP)
+ * ============================================================================ */
+
+/**
+ * @brief Lit la liste des pairs "hôte:port,..." (clé cluster_peers)
+ * @param spec Liste de pairs
+ * @return Nombre de pairs, -1 si la liste est invalide
+ */
+int cluster_parse_peers(const char *spec) {
+    int count = 0;
+
+    while (*spec) {
+        size_t len = strcspn(spec, ",");
+        char item[CONFIG_VALUE_MAX];
+        if (len == 0 || len >= sizeof(item) || count == CLUSTER_PEERS_MAX) {
+            return -1;
+        }
+        memcpy(item, spec, len);
+        item[len] = '\0';
+
+        char *colon = strrchr(item, ':');
+        char *end;
+        long port = colon ? strtol(colon + 1, &end, 10) : 0;
+        if (!colon || colon == item || *end != '\0' || port < 1 || port > 65535) {
+            return -1;
+        }
+        *colon = '\0';
+
+        cluster_peer_t *peer = &cluster.peers[count++];
+        snprintf(peer->host, sizeof(peer->host), "%s", item);
+        snprintf(peer->port, sizeof(peer->port), "%ld", port);
+        peer->socket = -1;
+        peer->addr_count = 0;
+
+        spec += len;
+        if (*spec == ',') {
+            spec++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Résout un pair et retient ses adresses (admission des entrants)
+ * @param peer Pair
+ * @return Adresses à libérer par freeaddrinfo, NULL si la résolution échoue
+ *
+ * Les adresses précédentes restent retenues si la résolution échoue.
+ */
+struct addrinfo *cluster_resolve(cluster_peer_t *peer) {
+    struct addrinfo hints, *result = NULL;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(peer->host, peer->port, &hints, &result) != 0) {
+        return NULL;
+    }
+
+    peer->addr_count = 0;
+    for (struct addrinfo *ai = result; ai && peer->addr_count < CLUSTER_PEER_ADDRS;
+         ai = ai->ai_next) {
+        address_normalize(ai->ai_addr, &peer->addrs[peer->addr_count++]);
+    }
+    return result;
+}
+
+/**
+ * @brief Indique si une connexion entrante vient d'un pair déclaré
+ * @param addr Adresse normalisée (address_normalize)
+ * @return 1 si l'adresse est celle d'un hôte de cluster_peers
+ */
+int cluster_peer_allowed(const struct sockaddr_in6 *addr) {
+    for (int i = 0; i < cluster.peer_count; i++) {
+        const cluster_peer_t *peer = &cluster.peers[i];
+        for (int j = 0; j < peer->addr_count; j++) {
+            if (memcmp(&peer->addrs[j].sin6_addr, &addr->sin6_addr,
+                       sizeof(addr->sin6_addr)) == 0) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Ouvre le port de réplication (avant le thread propriétaire)
+ * @return 0 si succès, -1 sinon
+ *
+ * Écoute sur cluster_bind (une adresse, bouclage par défaut) et exige
+ * cluster_secret: sans lui, aucun pair ne pourrait se présenter.
+ */
+int cluster_init(void) {
+    cluster.node = (uint32_t)(config.cluster_node ? config.cluster_node : config.cluster_port);
+    cluster.peer_count = cluster_parse_peers(config.cluster_peers);
+    listener_t bound;
+    if (cluster.peer_count < 0 ||
+        bind_parse(config.cluster_bind, config.cluster_port, &bound, 1) != 1) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (!config.cluster_secret[0]) {
+        log_message("ERROR", "Cluster: clé cluster_secret (ou " CLUSTER_SECRET_ENV ") obligatoire");
+        errno = EINVAL;
+        return -1;
+    }
+    for (int i = 0; i < cluster.peer_count; i++) {
+        struct addrinfo *result = cluster_resolve(&cluster.peers[i]);
+        if (result) {
+            freeaddrinfo(result);
+        }
+    }
+    for (int i = 0; i < CLUSTER_INBOUND_MAX; i++) {
+        cluster.inbound[i].socket = -1;
+    }
+
+    int family = bound.addr.ss_family;
+    cluster.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    cluster.listener = socket(family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (cluster.wake_fd < 0 || cluster.listener < 0) {
+        return -1;
+    }
+
+    int opt = 1;
+    int v6_only = !bound.dual_stack;
+    socklen_t len = (family == AF_INET6) ? sizeof(struct sockaddr_in6)
+                                         : sizeof(struct sockaddr_in);
+    if (setsockopt(cluster.listener, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+        (family == AF_INET6 &&
+         setsockopt(cluster.listener, IPPROTO_IPV6, IPV6_V6ONLY, &v6_only, sizeof(v6_only)) < 0) ||
+        bind(cluster.listener, (struct sockaddr *)&bound.addr, len) < 0 ||
+        listen(cluster.listener, CLUSTER_INBOUND_MAX) < 0) {
+        return -1;
+    }
+
+    cluster.enabled = 1;
+    return 0;
+}
+
+/**
+ * @brief Ajoute un enregistrement à la file de chaque pair connecté
+ * @param record Enregistrement à diffuser
+ *
+ * Une file pleine est vidée: le pair recevra un envoi complet à la place.
+ */
+void cluster_enqueue(const cluster_record_t *record) {
+    pthread_mutex_lock(&cluster.mutex);
+    for (int i = 0; i < cluster.peer_count; i++) {
+        cluster_peer_t *peer = &cluster.peers[i];
+        if (peer->socket < 0 || peer->resync) {
+            continue; // Envoi complet déjà dû
+        }
+        if (peer->head - peer->tail == CLUSTER_QUEUE) {
+            peer->head = peer->tail = 0;
+            peer->resync = 1;
+            continue;
+        }
+        peer->queue[peer->head++ % CLUSTER_QUEUE] = *record;
+    }
+    pthread_mutex_unlock(&cluster.mutex);
+
+    uint64_t one = 1;
+    ssize_t ignored = write(cluster.wake_fd, &one, sizeof(one));
+    (void)ignored;
+}
+
+/**
+ * @brief Diffuse une entrée qui vient d'entrer dans un top-K (thread propriétaire)
+ * @param entry Entrée
+ * @param mode Mode de jeu
+ * @param level Difficulté
+ * @param origin_us Date de la victoire à l'origine (0 = inconnue)
+ * @param hops Relais déjà effectués
+ */
+void cluster_share(const score_t *entry, game_mode_t mode, int level, int64_t origin_us,
+                   int hops) {
+    if (!cluster.enabled || hops >= CLUSTER_MAX_HOPS) {
+        return;
+    }
+
+    cluster_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.magic = CLUSTER_MAGIC;
+    record.type = CLUSTER_SCORE;
+    record.mode = (uint8_t)mode;
+    record.level = (uint8_t)level;
+    record.origin = entry->origin;
+    record.origin_us = origin_us;
+    record.value = (int64_t)entry->timestamp;
+    record.score = entry->score;
+    record.attempts = entry->attempts;
+    record.duration = entry->duration;
+    record.hops = (uint8_t)hops;
+    memcpy(record.name, entry->name, MAX_NAME_LENGTH);
+    cluster_enqueue(&record);
+}
+
+/**
+ * @brief Applique une entrée reçue d'un autre nœud (thread propriétaire)
+ * @param record Enregistrement CLUSTER_SCORE validé
+ * @return 1 si l'entrée entre dans le top-K local, 0 sinon
+ *
+ * Seuls les leaderboards sont répliqués: les compteurs de parties de chaque
+ * nœud circulent à part (CLUSTER_STATS) et ne sont pas additionnés ici.
+ */
+int cluster_apply(const cluster_record_t *record) {
+    score_t entry;
+    memset(&entry, 0, sizeof(entry));
+    memcpy(entry.name, record->name, MAX_NAME_LENGTH);
+    entry.name[MAX_NAME_LENGTH - 1] = '\0';
+    entry.attempts = record->attempts;
+    entry.duration = record->duration;
+    entry.score = record->score;
+    entry.timestamp = (time_t)record->value;
+    entry.origin = record->origin;
+
+    if (!leaderboard_insert(&leaderboards[record->mode][record->level], &entry)) {
+        return 0;
+    }
+    standby_ship_game(&entry, record->mode, record->level, 0);
+
+    __atomic_add_fetch(&cluster.remote_applied, 1, __ATOMIC_RELAXED);
+    if (record->origin_us > 0) {
+        int64_t delay = realtime_us() - record->origin_us;
+        delay = (delay > 0) ? delay : 0;
+        __atomic_add_fetch(&cluster.convergence_total_us, delay, __ATOMIC_RELAXED);
+        if (delay > cluster.convergence_max_us) {
+            __atomic_store_n(&cluster.convergence_max_us, delay, __ATOMIC_RELAXED);
+        }
+    }
+    cluster_share(&entry, record->mode, record->level, record->origin_us, record->hops + 1);
+    return 1;
+}
+
+/**
+ * @brief Prépare l'enregistrement des compteurs de ce nœud
+ * @param record Enregistrement rempli (version = date courante)
+ */
+void cluster_stats_record(cluster_record_t *record) {
+    int slot;
+    board_snapshot_t *board = board_acquire(&slot);
+
+    memset(record, 0, sizeof(*record));
+    record->magic = CLUSTER_MAGIC;
+    record->type = CLUSTER_STATS;
+    record->origin = cluster.node;
+    record->origin_us = realtime_us();
+    record->value = board->total_games;
+    record->total = (int64_t)(board->avg_attempts * board->total_games + 0.5f);
+    record->score = (board->best_attempts == 999999) ? 0 : board->best_attempts;
+
+    board_release(slot, board);
+}
+
+/**
+ * @brief Envoie des enregistrements à un pair (déconnecté en cas d'échec)
+ * @param peer Pair connecté
+ * @param records Enregistrements
+ * @param count Nombre d'enregistrements
+ * @return 0 si succès, -1 sinon
+ */
+int cluster_send(cluster_peer_t *peer, const cluster_record_t *records, int count) {
+    size_t len = (size_t)count * sizeof(cluster_record_t);
+    const char *data = (const char *)records;
+
+    while (len > 0) {
+        ssize_t sent = send(peer->socket, data, len, MSG_NOSIGNAL);
+        if (sent <= 0) {
+            char log[CONFIG_VALUE_MAX + 64];
+            snprintf(log, sizeof(log), "Cluster: pair %s:%s perdu", peer->host, peer->port);
+            log_message("WARNING", log);
+            pthread_mutex_lock(&cluster.mutex);
+            close(peer->socket);
+            peer->socket = -1;
+            peer->head = peer->tail = 0;
+            peer->retry_ms = monotonic_ms() + CLUSTER_RETRY_MS;
+            pthread_mutex_unlock(&cluster.mutex);
+            return -1;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+
+    __atomic_add_fetch(&cluster.records_sent, (unsigned long)count, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&cluster.bytes_sent, (unsigned long)count * sizeof(cluster_record_t),
+                       __ATOMIC_RELAXED);
+    return 0;
+}
+
+/**
+ * @brief Envoi complet: tous les top-K et les compteurs connus
+ * @param peer Pair connecté
+ * @return 0 si succès, -1 sinon
+ *
+ * Les entrées partent sans date de victoire (origin_us = 0) pour ne pas
+ * fausser la mesure de convergence.
+ */
+int cluster_full_sync(cluster_peer_t *peer) {
+    static cluster_record_t records[1 + GAME_MODES * DIFFICULTY_LEVELS * TOP_SCORES +
+                                    CLUSTER_NODES_MAX];
+    int count = 0;
+
+    int slot;
+    board_snapshot_t *board = board_acquire(&slot);
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        for (int level = 0; level < DIFFICULTY_LEVELS; level++) {
+            const leaderboard_t *ranking = &board->boards[mode][level];
+            for (int i = 0; i < ranking->count; i++) {
+                const score_t *entry = &ranking->scores[i];
+                if (!entry->origin) {
+                    continue; // Entrée chargée d'un instantané: locale
+                }
+                cluster_record_t *record = &records[count++];
+                memset(record, 0, sizeof(*record));
+                record->magic = CLUSTER_MAGIC;
+                record->type = CLUSTER_SCORE;
+                record->mode = (uint8_t)mode;
+                record->level = (uint8_t)level;
+                record->origin = entry->origin;
+                record->value = (int64_t)entry->timestamp;
+                record->score = entry->score;
+                record->attempts = entry->attempts;
+                record->duration = entry->duration;
+                memcpy(record->name, entry->name, MAX_NAME_LENGTH);
+            }
+        }
+    }
+    board_release(slot, board);
+
+    cluster_stats_record(&records[count++]);
+    pthread_mutex_lock(&cluster.mutex);
+    for (int i = 0; i < cluster.node_count; i++) {
+        const cluster_node_t *node = &cluster.nodes[i];
+        cluster_record_t *record = &records[count++];
+        memset(record, 0, sizeof(*record));
+        record->magic = CLUSTER_MAGIC;
+        record->type = CLUSTER_STATS;
+        record->origin = node->node;
+        record->origin_us = node->version_us;
+        record->value = node->games;
+        record->total = node->attempts;
+        record->score = node->best;
+        record->hops = 1;
+    }
+    pthread_mutex_unlock(&cluster.mutex);
+
+    __atomic_add_fetch(&cluster.full_syncs, 1, __ATOMIC_RELAXED);
+    return cluster_send(peer, records, count);
+}
+
+/**
+ * @brief Répond au défi du pair contacté (présentation signée)
+ * @param fd Socket connecté (délais d'envoi et de réception posés)
+ * @return 0 si la présentation est envoyée, -1 sinon
+ */
+int cluster_handshake(int fd) {
+    cluster_hello_t hello;
+
+    if (recv(fd, &hello, sizeof(hello), MSG_WAITALL) != (ssize_t)sizeof(hello) ||
+        hello.magic != CLUSTER_MAGIC || hello.type != CLUSTER_CHALLENGE) {
+        return -1;
+    }
+
+    hello.type = CLUSTER_HELLO;
+    hello.reserved = 0;
+    hello.node = cluster.node;
+    memset(hello.padding, 0, sizeof(hello.padding));
+    hmac_sha1(config.cluster_secret, (const uint8_t *)&hello, offsetof(cluster_hello_t, mac),
+              hello.mac);
+    return (send(fd, &hello, sizeof(hello), MSG_NOSIGNAL) == (ssize_t)sizeof(hello)) ? 0 : -1;
+}
+
+/**
+ * @brief Tente la connexion à un pair (envoi complet au succès)
+ * @param peer Pair déconnecté dont le délai de reconnexion est écoulé
+ */
+void cluster_connect(cluster_peer_t *peer) {
+    peer->retry_ms = monotonic_ms() + CLUSTER_RETRY_MS;
+    struct addrinfo *result = cluster_resolve(peer);
+    if (!result) {
+        return;
+    }
+
+    int fd = socket(result->ai_family, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    struct timeval timeout = {.tv_sec = CLUSTER_RETRY_MS / 1000,
+                              .tv_usec = (CLUSTER_RETRY_MS % 1000) * 1000};
+    int opt = 1;
+    if (fd < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) < 0 ||
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) < 0 ||
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt)) < 0 ||
+        connect(fd, result->ai_addr, result->ai_addrlen) < 0) {
+        if (fd >= 0) {
+            close(fd);
+        }
+        freeaddrinfo(result);
+        return;
+    }
+    freeaddrinfo(result);
+
+    char log[CONFIG_VALUE_MAX + 96];
+    if (cluster_handshake(fd) < 0) {
+        snprintf(log, sizeof(log), "Cluster: pair %s:%s sans défi (cluster_peers du pair?)",
+                 peer->host, peer->port);
+        log_message("WARNING", log);
+        close(fd);
+        return;
+    }
+
+    pthread_mutex_lock(&cluster.mutex);
+    peer->socket = fd;
+    peer->head = peer->tail = 0;
+    peer->resync = 1;
+    pthread_mutex_unlock(&cluster.mutex);
+
+    snprintf(log, sizeof(log), "Cluster: connecté au pair %s:%s", peer->host, peer->port);
+    log_message("INFO", log);
+}
+
+/**
+ * @brief Traite un enregistrement reçu et validé (thread de réplication)
+ * @param record Enregistrement
+ */
+void cluster_handle(const cluster_record_t *record) {
+    if (record->type == CLUSTER_HELLO) {
+        char log[64];
+        snprintf(log, sizeof(log), "Cluster: nœud %llu connecté",
+                 (unsigned long long)record->origin);
+        log_message("INFO", log);
+        return;
+    }
+
+    if (record->type == CLUSTER_SCORE) {
+        // Sans identifiant, une entrée ne peut pas être dédoublonnée; celles de
+        // ce nœud sont acceptées (instance précédente, avant un redémarrage)
+        if (!record->origin) {
+            return;
+        }
+        score_event_t *event = calloc(1, sizeof(score_event_t));
+        cluster_record_t *copy = malloc(sizeof(cluster_record_t));
+        if (!event || !copy) {
+            free(event);
+            free(copy);
+            __atomic_add_fetch(&scoreboard.dropped, 1, __ATOMIC_RELAXED);
+            return;
+        }
+        *copy = *record;
+        event->remote = copy;
+        event->posted_us = monotonic_us();
+        scoreboard_push(event, event);
+        return;
+    }
+
+    // Compteurs d'un nœud: conservés s'ils sont plus récents, puis relayés
+    if (record->origin == cluster.node) {
+        return;
+    }
+    pthread_mutex_lock(&cluster.mutex);
+    cluster_node_t *node = NULL;
+    for (int i = 0; i < cluster.node_count && !node; i++) {
+        if (cluster.nodes[i].node == record->origin) {
+            node = &cluster.nodes[i];
+        }
+    }
+    if (!node && cluster.node_count < CLUSTER_NODES_MAX) {
+        node = &cluster.nodes[cluster.node_count++];
+        memset(node, 0, sizeof(*node));
+        node->node = (uint32_t)record->origin;
+    }
+    int newer = node && record->origin_us > node->version_us;
+    if (newer) {
+        node->version_us = record->origin_us;
+        node->games = record->value;
+        node->attempts = record->total;
+        node->best = record->score;
+    }
+    pthread_mutex_unlock(&cluster.mutex);
+
+    if (newer && record->hops + 1 < CLUSTER_MAX_HOPS) {
+        cluster_record_t relay = *record;
+        relay.hops++;
+        cluster_enqueue(&relay);
+    }
+}
+
+/**
+ * @brief Accepte un pair entrant: adresse vérifiée, puis défi envoyé
+ *
+ * Sans place libre ou sans défi envoyé d'un coup, la connexion est fermée
+ * et le pair réessaiera.
+ */
+void cluster_accept(void) {
+    struct sockaddr_storage raw;
+    socklen_t raw_len = sizeof(raw);
+    struct sockaddr_in6 peer;
+
+    int fd = accept4(cluster.listener, (struct sockaddr *)&raw, &raw_len, SOCK_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    address_normalize((struct sockaddr *)&raw, &peer);
+    if (!cluster_peer_allowed(&peer)) {
+        char address[ADDRESS_TEXT_MAX];
+        char log[ADDRESS_TEXT_MAX + 64];
+        snprintf(log, sizeof(log), "Cluster: connexion de %s refusée (absent de cluster_peers)",
+                 format_address((struct sockaddr *)&peer, address, sizeof(address)));
+        log_message("WARNING", log);
+        close(fd);
+        return;
+    }
+
+    cluster_inbound_t *inbound = NULL;
+    for (int i = 0; i < CLUSTER_INBOUND_MAX && !inbound; i++) {
+        if (cluster.inbound[i].socket < 0) {
+            inbound = &cluster.inbound[i];
+        }
+    }
+
+    cluster_hello_t challenge;
+    memset(&challenge, 0, sizeof(challenge));
+    challenge.magic = CLUSTER_MAGIC;
+    challenge.type = CLUSTER_CHALLENGE;
+    if (!inbound ||
+        getrandom(challenge.nonce, sizeof(challenge.nonce), 0) != (ssize_t)sizeof(challenge.nonce) ||
+        send(fd, &challenge, sizeof(challenge), MSG_DONTWAIT | MSG_NOSIGNAL) !=
+            (ssize_t)sizeof(challenge)) {
+        close(fd);
+        return;
+    }
+
+    inbound->socket = fd;
+    inbound->filled = 0;
+    inbound->authenticated = 0;
+    inbound->deadline_ms = monotonic_ms() + CLUSTER_HELLO_MS;
+    memcpy(inbound->nonce, challenge.nonce, sizeof(inbound->nonce));
+}
+
+/**
+ * @brief Vérifie la présentation d'un pair entrant
+ * @param inbound Connexion dont le défi est parti
+ * @param record Premier enregistrement reçu
+ * @return 1 si c'est une présentation signée avec cluster_secret pour ce défi
+ */
+int cluster_hello_valid(const cluster_inbound_t *inbound, const cluster_record_t *record) {
+    cluster_hello_t hello;
+    uint8_t expected[20];
+    uint8_t diff = 0;
+
+    memcpy(&hello, record, sizeof(hello));
+    if (hello.magic != CLUSTER_MAGIC || hello.type != CLUSTER_HELLO ||
+        memcmp(hello.nonce, inbound->nonce, sizeof(hello.nonce)) != 0) {
+        return 0;
+    }
+
+    // Comparaison en temps constant
+    hmac_sha1(config.cluster_secret, (const uint8_t *)&hello, offsetof(cluster_hello_t, mac),
+              expected);
+    for (size_t i = 0; i < sizeof(expected); i++) {
+        diff |= expected[i] ^ hello.mac[i];
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief Lit les enregistrements disponibles d'une connexion entrante
+ * @param inbound Connexion entrante
+ *
+ * Le premier enregistrement doit être la présentation signée; une
+ * présentation ultérieure est refusée comme tout enregistrement invalide.
+ */
+void cluster_receive(cluster_inbound_t *inbound) {
+    while (1) {
+        char *target = (char *)&inbound->pending + inbound->filled;
+        ssize_t n = recv(inbound->socket, target, sizeof(cluster_record_t) - inbound->filled,
+                         MSG_DONTWAIT);
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+            return;
+        }
+        if (n <= 0) {
+            break;
+        }
+        __atomic_add_fetch(&cluster.bytes_received, (unsigned long)n, __ATOMIC_RELAXED);
+        inbound->filled += (size_t)n;
+        if (inbound->filled < sizeof(cluster_record_t)) {
+            continue;
+        }
+
+        inbound->filled = 0;
+        cluster_record_t *record = &inbound->pending;
+        if (!inbound->authenticated) {
+            if (!cluster_hello_valid(inbound, record)) {
+                log_message("WARNING", "Cluster: présentation refusée (cluster_secret), "
+                            "connexion fermée");
+                break;
+            }
+            inbound->authenticated = 1;
+            cluster_handle(record);
+            continue;
+        }
+        if (record->magic != CLUSTER_MAGIC || record->type <= CLUSTER_HELLO ||
+            record->type > CLUSTER_STATS || record->mode >= GAME_MODES ||
+            record->level >= DIFFICULTY_LEVELS) {
+            log_message("WARNING", "Cluster: enregistrement invalide, connexion fermée");
+            break;
+        }
+        record->name[MAX_NAME_LENGTH - 1] = '\0';
+        cluster_handle(record);
+    }
+
+    close(inbound->socket);
+    inbound->socket = -1;
+    inbound->filled = 0;
+    inbound->authenticated = 0;
+}
+
+/**
+ * @brief Thread de réplication: pairs sortants (envoi) et entrants (réception)
+ * @param arg Non utilisé
+ * @return NULL
+ *
+ * Les deltas sont regroupés en un envoi par pair à chaque réveil; les
+ * compteurs de ce nœud partent au plus toutes les CLUSTER_FLUSH_MS quand
+ * ils ont changé.
+ */
+void *cluster_thread(void *arg) {
+    (void)arg;
+    struct pollfd pfds[2 + CLUSTER_INBOUND_MAX];
+    static cluster_record_t pending[CLUSTER_QUEUE];
+
+    while (1) {
+        int count = 0;
+        pfds[count++] = (struct pollfd){.fd = cluster.wake_fd, .events = POLLIN};
+        pfds[count++] = (struct pollfd){.fd = cluster.listener, .events = POLLIN};
+        for (int i = 0; i < CLUSTER_INBOUND_MAX; i++) {
+            pfds[count++] = (struct pollfd){.fd = cluster.inbound[i].socket, .events = POLLIN};
+        }
+        if (poll(pfds, (nfds_t)count, CLUSTER_FLUSH_MS) < 0) {
+            continue;
+        }
+
+        if (pfds[0].revents & POLLIN) {
+            uint64_t wakeups;
+            ssize_t ignored = read(cluster.wake_fd, &wakeups, sizeof(wakeups));
+            (void)ignored;
+        }
+
+        // Nouveaux pairs entrants
+        if (pfds[1].revents & POLLIN) {
+            cluster_accept();
+        }
+        for (int i = 0; i < CLUSTER_INBOUND_MAX; i++) {
+            if (pfds[2 + i].fd >= 0 && pfds[2 + i].revents) {
+                cluster_receive(&cluster.inbound[i]);
+            }
+        }
+
+        // Pairs entrants toujours sans présentation: place rendue
+        int64_t now = monotonic_ms();
+        for (int i = 0; i < CLUSTER_INBOUND_MAX; i++) {
+            cluster_inbound_t *inbound = &cluster.inbound[i];
+            if (inbound->socket >= 0 && !inbound->authenticated && now >= inbound->deadline_ms) {
+                log_message("WARNING", "Cluster: pair entrant sans présentation, connexion fermée");
+                close(inbound->socket);
+                inbound->socket = -1;
+                inbound->filled = 0;
+            }
+        }
+
+        // Compteurs de ce nœud, s'ils ont changé
+        int slot;
+        board_snapshot_t *board = board_acquire(&slot);
+        int64_t games = board->total_games;
+        board_release(slot, board);
+        if (games != cluster.stats_sent_games) {
+            cluster_record_t stats;
+            cluster_stats_record(&stats);
+            cluster.stats_sent_games = games;
+            cluster_enqueue(&stats);
+        }
+
+        // Pairs sortants: connexion, envoi complet ou deltas en attente
+        int up = 0;
+        for (int i = 0; i < cluster.peer_count; i++) {
+            cluster_peer_t *peer = &cluster.peers[i];
+            if (peer->socket < 0 && now >= peer->retry_ms) {
+                cluster_connect(peer);
+            }
+            if (peer->socket < 0) {
+                continue;
+            }
+
+            pthread_mutex_lock(&cluster.mutex);
+            int resync = peer->resync;
+            int queued = 0;
+            peer->resync = 0;
+            while (!resync && peer->tail != peer->head) {
+                pending[queued++] = peer->queue[peer->tail++ % CLUSTER_QUEUE];
+            }
+            peer->head = peer->tail = 0;
+            pthread_mutex_unlock(&cluster.mutex);
+
+            int failed = resync ? cluster_full_sync(peer) : 0;
+            if (!failed && queued > 0) {
+                failed = cluster_send(peer, pending, queued);
+            }
+            up += !failed;
+        }
+        __atomic_store_n(&cluster.peers_up, up, __ATOMIC_RELAXED);
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * RÉPLIQUE DE SECOURS (JOURNAL DES CHANGEMENTS SUR SOCKET UNIX)
+ * ============================================================================ */
+
+/**
+ * @brief Ajoute un enregistrement au journal si une réplique le suit
+ * @param record Enregistrement (numéro et date remplis ici)
+ */
+void standby_append(standby_record_t *record) {
+    pthread_mutex_lock(&standby.mutex);
+    if (standby.active) {
+        record->seq = standby.head;
+        record->time_us = realtime_us();
+        standby.ring[standby.head++ % STANDBY_RING] = *record;
+        pthread_cond_signal(&standby.cond);
+    }
+    pthread_mutex_unlock(&standby.mutex);
+}
+
+/**
+ * @brief Journalise une partie appliquée (thread propriétaire)
+ * @param entry Entrée construite par le propriétaire
+ * @param mode Mode de jeu
+ * @param level Difficulté
+ * @param counted 1 = partie locale (statistiques), 0 = entrée d'un autre nœud
+ */
+void standby_ship_game(const score_t *entry, game_mode_t mode, int level, int counted) {
+    if (!__atomic_load_n(&standby.active, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    standby_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.type = STANDBY_GAME;
+    record.mode = mode;
+    record.level = level;
+    record.counted = counted;
+    record.entry = *entry;
+    standby_append(&record);
+}
+
+/**
+ * @brief Journalise une partie suspendue ou reprise (verrou de la table tenu)
+ * @param type STANDBY_PARK ou STANDBY_CLAIM
+ * @param parked État (jeton seul pour une reprise)
+ */
+void standby_ship_parked(standby_type_t type, const handoff_parked_t *parked) {
+    standby_record_t record;
+    memset(&record, 0, sizeof(record));
+    record.type = type;
+    record.parked = *parked;
+    standby_append(&record);
+}
+
+/**
+ * @brief Capture l'état demandé par le thread d'envoi (propriétaire, à une barrière)
+ *
+ * Les parties journalisées avant capture_seq y sont déjà comptées.
+ */
+void standby_capture(void) {
+    pthread_mutex_lock(&standby.mutex);
+    if (standby.capture) {
+        memcpy(standby.capture->boards, leaderboards, sizeof(leaderboards));
+        standby.capture->stats = global_stats;
+        standby.capture_seq = standby.head;
+        standby.capture = NULL;
+    }
+    pthread_mutex_unlock(&standby.mutex);
+}
+
+/**
+ * @brief Alimente une réplique connectée jusqu'à sa déconnexion
+ * @param channel Connexion de la réplique
+ * @return -1 quand la réplique est perdue
+ *
+ * 1. parties suspendues et début du journal, sous les verrous de la table
+ *    puis du journal (ordre de park_session);
+ * 2. état capturé par le propriétaire à une barrière;
+ * 3. journal depuis le début, sans les parties déjà dans l'état, par
+ *    messages de STANDBY_BATCH enregistrements (au moins un toutes les
+ *    STANDBY_HEARTBEAT_MS). Retour à 1 après un échange admin ou si la
+ *    réplique a plus de STANDBY_RING enregistrements de retard.
+ */
+int standby_serve(int channel) {
+    static handoff_parked_t parked[RESUME_SLOTS];
+    static standby_record_t batch[STANDBY_BATCH];
+    standby_state_t *state = malloc(sizeof(standby_state_t));
+    int status = state ? 0 : -1;
+
+    while (status == 0) {
+        shared_lock(&resume_table->mutex);
+        pthread_mutex_lock(&standby.mutex);
+        int parked_count = parked_collect(parked);
+        uint64_t next = standby.head;
+        __atomic_store_n(&standby.active, 1, __ATOMIC_RELEASE);
+        standby.resync = 0;
+        standby.capture = state;
+        pthread_mutex_unlock(&standby.mutex);
+        pthread_mutex_unlock(&resume_table->mutex);
+
+        scoreboard_barrier(NULL);
+        pthread_mutex_lock(&standby.mutex);
+        int captured = (standby.capture == NULL);
+        standby.capture = NULL;
+        uint64_t included = standby.capture_seq;
+        pthread_mutex_unlock(&standby.mutex);
+
+        standby_hello_t hello = {
+            .magic = STANDBY_MAGIC, .version = STANDBY_VERSION,
+            .record_size = sizeof(standby_record_t), .state_size = sizeof(standby_state_t),
+            .parked_count = parked_count, .reserved = 0,
+        };
+        if (!captured || handoff_send(channel, &hello, sizeof(hello), -1) < 0 ||
+            handoff_send(channel, state, sizeof(*state), -1) < 0 ||
+            (parked_count > 0 &&
+             handoff_send(channel, parked, parked_count * sizeof(parked[0]), -1) < 0)) {
+            status = -1;
+            break;
+        }
+        __atomic_add_fetch(&standby.resyncs, 1, __ATOMIC_RELAXED);
+
+        while (status == 0) {
+            pthread_mutex_lock(&standby.mutex);
+            if (standby.head == next && !standby.resync) {
+                struct timespec deadline;
+                clock_gettime(CLOCK_REALTIME, &deadline);
+                deadline.tv_nsec += STANDBY_HEARTBEAT_MS * 1000000L;
+                deadline.tv_sec += deadline.tv_nsec / 1000000000L;
+                deadline.tv_nsec %= 1000000000L;
+                pthread_cond_timedwait(&standby.cond, &standby.mutex, &deadline);
+            }
+            int resync = standby.resync || standby.head - next > STANDBY_RING;
+            int count = 0;
+            while (!resync && next != standby.head && count < STANDBY_BATCH) {
+                const standby_record_t *record = &standby.ring[next++ % STANDBY_RING];
+                if (record->type != STANDBY_GAME || record->seq >= included) {
+                    batch[count++] = *record;
+                }
+            }
+            pthread_mutex_unlock(&standby.mutex);
+            if (resync) {
+                break; // Nouvel état complet
+            }
+
+            int shipped = count;
+            if (count == 0) {
+                memset(&batch[0], 0, sizeof(batch[0]));
+                batch[0].type = STANDBY_HEARTBEAT;
+                batch[0].seq = next;
+                batch[0].time_us = realtime_us();
+                count = 1;
+            }
+            status = handoff_send(channel, batch, count * sizeof(batch[0]), -1);
+            __atomic_add_fetch(&standby.shipped, (unsigned long)shipped, __ATOMIC_RELAXED);
+
+            // Accusés: retard de la réplique
+            standby_ack_t ack;
+            ssize_t n = -1;
+            while (status == 0 && (n = recv(channel, &ack, sizeof(ack), MSG_DONTWAIT)) != 0) {
+                if (n < 0) {
+                    status = (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+                    break;
+                }
+                if (n == sizeof(ack)) {
+                    __atomic_store_n(&standby.acked, ack.seq, __ATOMIC_RELAXED);
+                    __atomic_store_n(&standby.lag_us, ack.lag_us, __ATOMIC_RELAXED);
+                    if (ack.lag_us > standby.lag_max_us) {
+                        __atomic_store_n(&standby.lag_max_us, ack.lag_us, __ATOMIC_RELAXED);
+                    }
+                }
+            }
+            if (n == 0) {
+                status = -1;
+            }
+        }
+    }
+
+    pthread_mutex_lock(&standby.mutex);
+    __atomic_store_n(&standby.active, 0, __ATOMIC_RELEASE);
+    standby.capture = NULL;
+    pthread_mutex_unlock(&standby.mutex);
+    free(state);
+    return -1;
+}
+
+/**
+ * @brief Thread d'envoi: accepte une réplique à la fois (primaire)
+ * @param arg Non utilisé
+ * @return NULL
+ */
+void *standby_thread(void *arg) {
+    (void)arg;
+    char log[96];
+
+    while (1) {
+        int channel = accept4(standby.listener, NULL, NULL, SOCK_CLOEXEC);
+        if (channel < 0) {
+            continue;
+        }
+
+        // Même utilisateur seulement (leaderboard et parties suspendues)
+        struct ucred peer;
+        socklen_t peer_len = sizeof(peer);
+        if (getsockopt(channel, SOL_SOCKET, SO_PEERCRED, &peer, &peer_len) < 0 ||
+            peer.uid != getuid()) {
+            log_message("WARNING", "Réplique refusée (autre utilisateur)");
+            close(channel);
+            continue;
+        }
+        struct timeval timeout = { HANDOFF_TIMEOUT_MS / 1000, (HANDOFF_TIMEOUT_MS % 1000) * 1000 };
+        setsockopt(channel, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        snprintf(log, sizeof(log), "Réplique de secours connectée (processus %d)", (int)peer.pid);
+        log_message("INFO", log);
+        standby_serve(channel);
+        close(channel);
+        log_message("WARNING", "Réplique de secours déconnectée");
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Applique un enregistrement du journal (réplique, thread principal)
+ * @param record Enregistrement reçu
+ *
+ * Avant la promotion, aucun autre thread ne touche au leaderboard.
+ */
+void standby_apply(const standby_record_t *record) {
+    client_data_t restored;
+
+    switch (record->type) {
+    case STANDBY_GAME:
+        if (record->mode < 0 || record->mode >= GAME_MODES ||
+            record->level < 0 || record->level >= DIFFICULTY_LEVELS) {
+            return;
+        }
+        if (record->counted) {
+            stats_account(record->entry.attempts);
+        }
+        leaderboard_insert(&leaderboards[record->mode][record->level], &record->entry);
+        break;
+    case STANDBY_PARK:
+        memset(&restored, 0, sizeof(restored));
+        restored.resume_token = record->parked.token;
+        restored.start_time = (time_t)record->parked.start_time;
+        restored.target_number = record->parked.target_number;
+        restored.level = &difficulties[(record->parked.level >= 0 &&
+                                        record->parked.level < DIFFICULTY_LEVELS)
+                                       ? record->parked.level : 0];
+        restored.attempts = record->parked.attempts;
+        memcpy(restored.name, record->parked.name, MAX_NAME_LENGTH);
+        park_session(&restored);
+        break;
+    case STANDBY_CLAIM:
+        claim_parked_session(record->parked.token, &restored);
+        break;
+    default:
+        return; // Battement: rien à appliquer
+    }
+    standby.replayed++;
+}
+
+/**
+ * @brief Arrêt demandé pendant le suivi (signaux bloqués, pas encore de signal_thread)
+ * @return 1 si SIGINT ou SIGTERM est en attente
+ */
+int standby_stopping(void) {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGHUP);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+    struct timespec now = {0, 0};
+    int sig;
+    while ((sig = sigtimedwait(&set, NULL, &now)) == SIGHUP) {
+        // Rechargement sans objet avant la promotion
+    }
+    return sig == SIGINT || sig == SIGTERM;
+}
+
+/**
+ * @brief Suit le primaire puis prend son port quand il disparaît (option -r)
+ * @param path Socket Unix du primaire (clé standby_socket)
+ * @return 0 une fois le port ouvert (listeners), -1 si le chemin est invalide
+ *
+ * Si le port est encore occupé à la fin du flux (primaire remplacé par
+ * bascule à chaud ou relancé), la réplique suit le nouveau primaire.
+ */
+int standby_follow(const char *path) {
+    static standby_record_t batch[STANDBY_BATCH];
+    static handoff_parked_t parked[RESUME_SLOTS];
+    struct sockaddr_un addr;
+    char log[CONFIG_VALUE_MAX + 96];
+    int followed = 0;
+    int waiting = 0;
+    int stop = 0;
+
+    standby_state_t *state = malloc(sizeof(standby_state_t));
+    if (!state || strlen(path) >= sizeof(addr.sun_path)) {
+        free(state);
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    while (!stop && !(stop = standby_stopping())) {
+        // Primaire disparu: le port se libère avec son processus
+        if (followed && server_listen() == 0) {
+            free(state);
+            snprintf(log, sizeof(log), "Réplique: port %d repris", config.port);
+            log_message("SUCCESS", log);
+            return 0;
+        }
+
+        int channel = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+        if (channel < 0 || connect(channel, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+            if (channel >= 0) {
+                close(channel);
+            }
+            if (followed) {
+                usleep(STANDBY_BIND_MS * 1000); // Port libéré à la fin du processus
+                continue;
+            }
+            if (!waiting++) {
+                snprintf(log, sizeof(log), "Réplique: primaire injoignable sur %s, nouvel essai",
+                         path);
+                log_message("WARNING", log);
+            }
+            usleep(STANDBY_RETRY_MS * 1000);
+            continue;
+        }
+        waiting = 0;
+
+        // État complet, parties suspendues
+        standby_hello_t hello;
+        if (handoff_recv(channel, &hello, sizeof(hello), NULL) < 0 ||
+            hello.magic != STANDBY_MAGIC || hello.version != STANDBY_VERSION ||
+            hello.record_size != sizeof(standby_record_t) ||
+            hello.state_size != sizeof(standby_state_t) ||
+            hello.parked_count < 0 || hello.parked_count > RESUME_SLOTS ||
+            handoff_recv(channel, state, sizeof(*state), NULL) < 0 ||
+            (hello.parked_count > 0 &&
+             handoff_recv(channel, parked, hello.parked_count * sizeof(parked[0]), NULL) < 0)) {
+            log_message("ERROR", "Réplique: en-tête ou état invalide (versions différentes ?)");
+            close(channel);
+            usleep(STANDBY_RETRY_MS * 1000);
+            continue;
+        }
+        time_t started = global_stats.server_start_time;
+        memcpy(leaderboards, state->boards, sizeof(leaderboards));
+        global_stats = state->stats;
+        global_stats.server_start_time = started;
+        shared_lock(&resume_table->mutex);
+        memset(resume_table->slots, 0, sizeof(resume_table->slots));
+        pthread_mutex_unlock(&resume_table->mutex);
+        for (int i = 0; i < hello.parked_count; i++) {
+            standby_record_t record = {.type = STANDBY_PARK, .parked = parked[i]};
+            standby_apply(&record);
+        }
+        followed = 1;
+        snprintf(log, sizeof(log), "Réplique synchronisée: %d partie(s), %d partie(s) suspendue(s)",
+                 global_stats.total_games, hello.parked_count);
+        log_message("SUCCESS", log);
+
+        // Journal: un accusé par message (retard mesuré par le primaire)
+        struct pollfd pfd = {.fd = channel, .events = POLLIN};
+        while (!(stop = standby_stopping())) {
+            if (poll(&pfd, 1, STANDBY_HEARTBEAT_MS * 10) == 0) {
+                continue;
+            }
+            ssize_t n = recv(channel, batch, sizeof(batch), 0);
+            if (n <= 0 || n % sizeof(batch[0]) != 0) {
+                break;
+            }
+            int count = (int)(n / sizeof(batch[0]));
+            for (int i = 0; i < count; i++) {
+                standby_apply(&batch[i]);
+            }
+            const standby_record_t *last = &batch[count - 1];
+            standby_ack_t ack = {
+                .seq = (last->type == STANDBY_HEARTBEAT) ? last->seq : last->seq + 1,
+                .lag_us = realtime_us() - last->time_us,
+            };
+            standby.lag_us = ack.lag_us;
+            if (send(channel, &ack, sizeof(ack), MSG_NOSIGNAL) < 0) {
+                break;
+            }
+        }
+        close(channel);
+        if (!stop) {
+            standby.lost_ms = monotonic_ms();
+            log_message("WARNING", "Réplique: flux du primaire interrompu, reprise du port");
+        }
+    }
+
+    free(state);
+    printf("\n✅ Réplique arrêtée\n\n");
+    exit(EXIT_SUCCESS);
+}
+
+/* ============================================================================
+ * ADMINISTRATION (SOCKET UNIX LOCAL, MÊME UTILISATEUR)
+ * ============================================================================ */
+
+/**
+ * @brief Ouvre le socket d'administration et son thread (clé admin_socket)
+ * @return 0 si succès ou clé absente, -1 sinon
+ *
+ * Droits 0600 et SO_PEERCRED à chaque connexion: seul l'utilisateur du
+ * serveur lit les métriques ou remplace le leaderboard, jamais un joueur
+ * (même local ou derrière le proxy).
+ */
+int admin_listen(void) {
+    pthread_t admin_id;
+
+    if (!config.admin_socket[0]) {
+        return 0;
+    }
+    admin_listener = local_listen(config.admin_socket, SOCK_STREAM | SOCK_CLOEXEC, 0600, 4);
+    if (admin_listener < 0) {
+        return -1;
+    }
+    if (pthread_create(&admin_id, NULL, admin_thread, NULL) != 0) {
+        close(admin_listener);
+        admin_listener = -1;
+        return -1;
+    }
+    pthread_detach(admin_id);
+    return 0;
+}
+
+/**
+ * @brief Exécute une commande d'administration
+ * @param channel Connexion d'administration
+ * @param line Commande (sans retour à la ligne): "metrics" ou "swap <fichier>"
+ */
+void admin_command(int channel, char *line) {
+    char error[256];
+    char log[320];
+
+    if (strcasecmp(line, "metrics") == 0) {
+        char json[3072];
+        format_json_metrics(json, sizeof(json));
+        send_message(channel, json);
+        return;
+    }
+    if (strncasecmp(line, "swap ", 5) == 0) {
+        if (board_swap(line + 5, error, sizeof(error)) < 0) {
+            send_json_error(channel, error);
+            return;
+        }
+        send_message(channel, "{\"type\":\"admin\",\"message\":\"Leaderboard remplace\"}\n");
+        snprintf(log, sizeof(log), "Administration: leaderboard remplacé depuis '%.200s'", line + 5);
+        log_message("WARNING", log);
+        return;
+    }
+    send_json_error(channel, "Commande inconnue (metrics, swap <fichier>)");
+}
+
+/**
+ * @brief Lit les commandes d'une connexion d'administration, une par ligne
+ * @param channel Connexion (délai de réception ADMIN_TIMEOUT_MS)
+ */
+void admin_serve(int channel) {
+    char buffer[BUFFER_SIZE];
+    size_t filled = 0;
+
+    while (1) {
+        ssize_t received = recv(channel, buffer + filled, sizeof(buffer) - 1 - filled, 0);
+        if (received <= 0) {
+            return;
+        }
+        filled += (size_t)received;
+        buffer[filled] = '\0';
+
+        char *line = buffer;
+        char *end;
+        while ((end = strchr(line, '\n')) != NULL) {
+            *end = '\0';
+            line[strcspn(line, "\r")] = '\0';
+            if (*line) {
+                admin_command(channel, line);
+            }
+            line = end + 1;
+        }
+        filled = strlen(line);
+        if (filled == sizeof(buffer) - 1) {
+            send_json_error(channel, "Commande trop longue");
+            return;
+        }
+        memmove(buffer, line, filled);
+    }
+}
+
+/**
+ * @brief Thread d'administration: une connexion à la fois
+ * @param arg Non utilisé
+ * @return NULL
+ */
+void *admin_thread(void *arg) {
+    (void)arg;
+
+    while (1) {
+        int channel = accept4(admin_listener, NULL, NULL, SOCK_CLOEXEC);
+        if (channel < 0) {
+            continue;
+        }
+
+        // Même utilisateur seulement (les droits 0600 suffisent, sauf root)
+        struct ucred peer;
+        socklen_t peer_len = sizeof(peer);
+        if (getsockopt(channel, SOL_SOCKET, SO_PEERCRED, &peer, &peer_len) < 0 ||
+            peer.uid != getuid()) {
+            log_message("WARNING", "Administration refusée (autre utilisateur)");
+            close(channel);
+            continue;
+        }
+        struct timeval timeout = { ADMIN_TIMEOUT_MS / 1000, (ADMIN_TIMEOUT_MS % 1000) * 1000 };
+        setsockopt(channel, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(channel, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+        websocket_set(channel, WEBSOCKET_NONE); // Réponses par send_message
+
+        admin_serve(channel);
+        close(channel);
+    }
+
+    return NULL;
+}
+
+/* ============================================================================
+ * ÉCOUTE ET ACCEPTATION (IPv4/IPv6, PLUSIEURS ADRESSES, SOCKET UNIX)
+ * ============================================================================ */
+
+/**
+ * @brief Lit la liste des adresses d'écoute (clé "bind")
+ * @param spec "adresse[:port],..." (vide = "*")
+ * @param port Port des adresses qui n'en précisent pas (clé "port")
+ * @param out Écoutes décrites, fd à -1 (sortie)
+ * @param max Capacité de out
+ * @return Nombre d'adresses, -1 si la liste est invalide
+ *
+ * "a.b.c.d[:port]" pour IPv4, "adresse" ou "[adresse]:port" pour IPv6
+ * seule, "*[:port]" pour toutes les interfaces IPv4 et IPv6 (double pile).
+ */
+int bind_parse(const char *spec, int port, listener_t *out, int max) {
+    char item[CONFIG_VALUE_MAX];
+    int count = 0;
+
+    if (!spec[0]) {
+        spec = "*";
+    }
+    while (*spec) {
+        size_t len = strcspn(spec, ",");
+        if (len >= sizeof(item) || count == max) {
+            return -1;
+        }
+        memcpy(item, spec, len);
+        item[len] = '\0';
+        spec += len;
+        if (*spec == ',') {
+            spec++;
+        }
+
+        // Port facultatif: "[v6]:port", ou "hôte:port" s'il n'y a qu'un ':'
+        char *host = trim_spaces(item);
+        char *port_text = NULL;
+        char *colon = strchr(host, ':');
+        if (*host == '[') {
+            char *bracket = strchr(host, ']');
+            if (!bracket || (bracket[1] && bracket[1] != ':')) {
+                return -1;
+            }
+            *bracket = '\0';
+            port_text = bracket[1] ? bracket + 2 : NULL;
+            host++;
+        } else if (colon && colon == strrchr(host, ':')) {
+            *colon = '\0';
+            port_text = colon + 1;
+        }
+        int item_port = port;
+        if (port_text) {
+            char *end;
+            errno = 0;
+            long parsed = strtol(port_text, &end, 10);
+            if (end == port_text || *end != '\0' || errno != 0 || parsed < 1 || parsed > 65535) {
+                return -1;
+            }
+            item_port = (int)parsed;
+        }
+
+        listener_t *entry = &out[count++];
+        struct sockaddr_in *v4 = (struct sockaddr_in *)&entry->addr;
+        struct sockaddr_in6 *v6 = (struct sockaddr_in6 *)&entry->addr;
+        memset(entry, 0, sizeof(*entry));
+        entry->fd = -1;
+        if (strcmp(host, "*") == 0) {
+            v6->sin6_family = AF_INET6;
+            v6->sin6_addr = in6addr_any;
+            v6->sin6_port = htons((uint16_t)item_port);
+            entry->dual_stack = 1;
+        } else if (inet_pton(AF_INET, host, &v4->sin_addr) == 1) {
+            v4->sin_family = AF_INET;
+            v4->sin_port = htons((uint16_t)item_port);
+        } else if (inet_pton(AF_INET6, host, &v6->sin6_addr) == 1) {
+            v6->sin6_family = AF_INET6;
+            v6->sin6_port = htons((uint16_t)item_port);
+        } else {
+            return -1;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief Ouvre les écoutes TCP (clés "bind", "port" et "ws_port")
+ * @return 0 si toutes sont ouvertes, -1 sinon (aucune gardée, errno conservé)
+ *
+ * "*" ouvre un socket IPv6 double pile (IPV6_V6ONLY à 0: les clients IPv4
+ * arrivent en ::ffff:a.b.c.d), ou IPv4 seule si le noyau n'a pas IPv6. Une
+ * adresse IPv6 explicite reste IPv6 seule, pour cohabiter avec une adresse
+ * IPv4 sur le même port. Workers: chaque processus ouvre toutes les
+ * adresses (SO_REUSEPORT), connexions réparties par le noyau.
+ */
+int server_listen(void) {
+    listener_t opened[LISTENERS_MAX];
+    int count = bind_parse(config.bind_addresses, config.port, opened, BIND_MAX);
+    if (count < 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    // WebSocket: mêmes adresses, port "ws_port" à la place de celui du jeu
+    if (config.ws_port > 0) {
+        for (int i = 0; i < count; i++) {
+            listener_t *entry = &opened[count + i];
+            *entry = opened[i];
+            entry->websocket = 1;
+            if (entry->addr.ss_family == AF_INET6) {
+                ((struct sockaddr_in6 *)&entry->addr)->sin6_port = htons((uint16_t)config.ws_port);
+            } else {
+                ((struct sockaddr_in *)&entry->addr)->sin_port = htons((uint16_t)config.ws_port);
+            }
+        }
+        count *= 2;
+    }
+
+    for (int i = 0; i < count; i++) {
+        listener_t *entry = &opened[i];
+        int family = entry->addr.ss_family;
+        int fd = socket(family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0 && entry->dual_stack && errno == EAFNOSUPPORT) {
+            // Noyau sans IPv6: toutes les interfaces IPv4
+            in_port_t port = ((struct sockaddr_in6 *)&entry->addr)->sin6_port;
+            struct sockaddr_in *v4 = (struct sockaddr_in *)&entry->addr;
+            memset(&entry->addr, 0, sizeof(entry->addr));
+            v4->sin_family = family = AF_INET;
+            v4->sin_addr.s_addr = INADDR_ANY;
+            v4->sin_port = port;
+            entry->dual_stack = 0;
+            fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        }
+        if (fd >= 0) {
+            listener_tune(fd);
+        }
+
+        // Option pour réutiliser le port immédiatement
+        int opt = 1;
+        int v6_only = !entry->dual_stack;
+        socklen_t len = (family == AF_INET6) ? sizeof(struct sockaddr_in6)
+                                             : sizeof(struct sockaddr_in);
+        if (fd < 0 ||
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0 ||
+            (workers.count > 1 &&
+             setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) ||
+            (family == AF_INET6 &&
+             setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6_only, sizeof(v6_only)) < 0) ||
+            bind(fd, (struct sockaddr *)&entry->addr, len) < 0 ||
+            listen(fd, config.max_clients) < 0) {
+            int saved = errno;
+            if (fd >= 0) {
+                close(fd);
+            }
+            for (int j = 0; j < i; j++) {
+                close(opened[j].fd);
+            }
+            errno = saved;
+            return -1;
+        }
+        entry->fd = fd;
+    }
+
+    memcpy(listeners, opened, count * sizeof(opened[0]));
+    listener_count = count;
+    return 0;
+}
+
+/**
+ * @brief Ferme les écoutes TCP (arrêt, bascule réussie, erreur de démarrage)
+ */
+void listeners_close(void) {
+    for (int i = 0; i < listener_count; i++) {
+        close(listeners[i].fd);
+    }
+    listener_count = 0;
+}
+
+/**
+ * @brief Ouvre le socket Unix de jeu (clé "unix_socket") s'il n'a pas été reçu
+ * @return 0 si succès ou clé absente, -1 en cas d'erreur (errno conservé)
+ *
+ * Même protocole que le port TCP, pour le proxy WebSocket de la même
+ * machine (sessions vues comme 127.0.0.1). Non bloquant: avec des workers,
+ * le socket est ouvert avant eux et partagé, et une connexion prise par un
+ * autre processus laisse accept sans résultat (EAGAIN).
+ */
+int local_game_listen(void) {
+    if (!config.unix_socket[0] || local_socket >= 0) {
+        return 0;
+    }
+    local_socket = local_listen(config.unix_socket, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC,
+                                LOCAL_SOCKET_MODE, config.max_clients);
+    return (local_socket < 0) ? -1 : 0;
+}
+
+/**
+ * @brief Ramène une adresse source à une seule forme (IPv6, IPv4 mappée)
+ * @param addr Adresse renvoyée par accept (AF_INET, AF_INET6 ou AF_UNIX)
+ * @param out Adresse normalisée: ::ffff:a.b.c.d pour IPv4, ::ffff:127.0.0.1
+ *            pour le socket Unix de jeu
+ */
+void address_normalize(const struct sockaddr *addr, struct sockaddr_in6 *out) {
+    if (addr->sa_family == AF_INET6) {
+        memcpy(out, addr, sizeof(*out));
+        return;
+    }
+
+    const struct sockaddr_in *v4 = (const struct sockaddr_in *)addr;
+    uint32_t ipv4 = (addr->sa_family == AF_INET) ? v4->sin_addr.s_addr : htonl(INADDR_LOOPBACK);
+    memset(out, 0, sizeof(*out));
+    out->sin6_family = AF_INET6;
+    out->sin6_addr.s6_addr[10] = 0xff;
+    out->sin6_addr.s6_addr[11] = 0xff;
+    memcpy(&out->sin6_addr.s6_addr[12], &ipv4, sizeof(ipv4));
+    out->sin6_port = (addr->sa_family == AF_INET) ? v4->sin_port : 0;
+}
+
+/**
+ * @brief Met en forme une adresse pour le journal, sans allocation
+ * @param addr Adresse IPv4 ou IPv6 (IPv4 mappée affichée en IPv4)
+ * @param out Buffer de l'appelant (ADDRESS_TEXT_MAX octets)
+ * @param size Taille de out
+ * @return out: "a.b.c.d[:port]" ou "2001:db8::1" / "[2001:db8::1]:port"
+ *
+ * Utilisable par tous les threads: inet_ntop écrit dans le buffer fourni,
+ * là où inet_ntoa partage un buffer statique.
+ */
+char *format_address(const struct sockaddr *addr, char *out, size_t size) {
+    char host[INET6_ADDRSTRLEN] = "?";
+    in_port_t port = 0;
+    int bracket = 0;
+
+    if (addr->sa_family == AF_INET) {
+        const struct sockaddr_in *v4 = (const struct sockaddr_in *)addr;
+        inet_ntop(AF_INET, &v4->sin_addr, host, sizeof(host));
+        port = v4->sin_port;
+    } else if (addr->sa_family == AF_INET6) {
+        const struct sockaddr_in6 *v6 = (const struct sockaddr_in6 *)addr;
+        if (IN6_IS_ADDR_V4MAPPED(&v6->sin6_addr)) {
+            inet_ntop(AF_INET, &v6->sin6_addr.s6_addr[12], host, sizeof(host));
+        } else {
+            inet_ntop(AF_INET6, &v6->sin6_addr, host, sizeof(host));
+            bracket = 1;
         }
+        port = v6->sin6_port;
+    }
 
-        leaderboard.scores[insert_pos] = new_score;
+    if (port == 0) {
+        snprintf(out, size, "%s", host);
+    } else {
+        snprintf(out, size, "%s%s%s:%u", bracket ? "[" : "", host, bracket ? "]" : "",
+                 (unsigned int)ntohs(port));
+    }
+    return out;
+}
 
-        if (leaderboard.count < TOP_SCORES) {
-            leaderboard.count++;
+/**
+ * @brief Pose une option de socket réglée par la configuration
+ * @param fd Socket
+ * @param level SOL_SOCKET ou IPPROTO_TCP
+ * @param option SO_* ou TCP_*
+ * @param value Valeur entière
+ * @param key Clé de configuration concernée (journal)
+ *
+ * Un refus (noyau ancien, SO_BUSY_POLL sans CAP_NET_ADMIN...) n'empêche
+ * pas la connexion: il est signalé une seule fois par clé pour ne pas
+ * inonder le journal à chaque accept.
+ */
+void socket_option(int fd, int level, int option, int value, const char *key) {
+    static int warned[CONFIG_KEY_COUNT];    // Refus déjà signalé, par clé
+
+    if (setsockopt(fd, level, option, &value, sizeof(value)) < 0) {
+        int error = errno;
+        const config_key_t *entry = config_find(key);
+
+        if (!entry || !__atomic_exchange_n(&warned[entry - config_keys], 1, __ATOMIC_RELAXED)) {
+            char log[128];
+            snprintf(log, sizeof(log), "Option de socket \"%s\" refusée (%s), ignorée",
+                     key, strerror(error));
+            log_message("WARNING", log);
         }
     }
+}
 
-    pthread_mutex_unlock(&leaderboard.mutex);
+/**
+ * @brief Règle une écoute TCP avant bind (clés de démarrage)
+ * @param fd Socket d'écoute
+ *
+ * SO_SNDBUF et SO_RCVBUF sont hérités par les connexions acceptées; posés
+ * avant listen, ils fixent aussi la fenêtre annoncée dans la poignée de
+ * main. TCP_DEFER_ACCEPT retient la connexion jusqu'aux premières données
+ * du client: le serveur parlant le premier (invite du nom), un client qui
+ * attend l'invite n'est accepté qu'au bout du délai.
+ */
+void listener_tune(int fd) {
+    if (config.sndbuf > 0) {
+        socket_option(fd, SOL_SOCKET, SO_SNDBUF, config.sndbuf, "sndbuf");
+    }
+    if (config.rcvbuf > 0) {
+        socket_option(fd, SOL_SOCKET, SO_RCVBUF, config.rcvbuf, "rcvbuf");
+    }
+    if (config.tcp_defer_accept > 0) {
+        socket_option(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, config.tcp_defer_accept,
+                      "tcp_defer_accept");
+    }
+    if (config.tcp_fastopen > 0) {
+        socket_option(fd, IPPROTO_TCP, TCP_FASTOPEN, config.tcp_fastopen, "tcp_fastopen");
+    }
 }
 
 /**
- * @brief Affiche les statistiques du serveur au client
- * @param socket Socket du client
+ * @brief Règle une connexion TCP acceptée (clés rechargeables)
+ * @param fd Socket du client
+ *
+ * TCP_NODELAY envoie sans attendre chaque réponse (quelques dizaines
+ * d'octets): sans lui, Nagle retient une réponse tant que la précédente
+ * n'est pas acquittée. Keepalive: sondes toutes les tcp_keepalive /
+ * KEEPALIVE_PROBES secondes après tcp_keepalive secondes de silence.
  */
-void display_server_stats(int socket) {
-    char msg[2048];
-    char buffer[256];
+void connection_tune(int fd) {
+    int keepalive = CONFIG_GET(tcp_keepalive);
+    int busy_poll = CONFIG_GET(busy_poll);
 
-    pthread_mutex_lock(&global_stats.mutex);
+    if (CONFIG_GET(tcp_nodelay)) {
+        socket_option(fd, IPPROTO_TCP, TCP_NODELAY, 1, "tcp_nodelay");
+    }
+    if (CONFIG_GET(tcp_quickack)) {
+        socket_option(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "tcp_quickack");
+    }
+    if (keepalive > 0) {
+        int interval = keepalive / KEEPALIVE_PROBES;
+        socket_option(fd, SOL_SOCKET, SO_KEEPALIVE, 1, "tcp_keepalive");
+        socket_option(fd, IPPROTO_TCP, TCP_KEEPIDLE, keepalive, "tcp_keepalive");
+        socket_option(fd, IPPROTO_TCP, TCP_KEEPINTVL, interval > 0 ? interval : 1,
+                      "tcp_keepalive");
+        socket_option(fd, IPPROTO_TCP, TCP_KEEPCNT, KEEPALIVE_PROBES, "tcp_keepalive");
+    }
+    if (busy_poll > 0) {
+        socket_option(fd, SOL_SOCKET, SO_BUSY_POLL, busy_poll, "busy_poll");
+    }
+}
 
-    time_t now = time(NULL);
-    int uptime = (int)difftime(now, global_stats.server_start_time);
-    int hours = uptime / 3600;
-    int minutes = (uptime % 3600) / 60;
-    int seconds = uptime % 60;
+/**
+ * @brief Accepte une connexion sur une écoute prête et lance sa session
+ * @param listener Écoute TCP ou socket Unix de jeu (non bloquants)
+ * @param websocket 1 = écoute WebSocket (poignée de main dans le thread de la session)
+ * @param client_counter Dernier numéro de session attribué (mis à jour)
+ *
+ * Rien à accepter (EAGAIN: connexion prise par un autre worker) n'est pas
+ * une erreur. Pendant l'arrêt, une connexion tout juste acceptée reçoit
+ * "server_shutdown" et main sort de sa boucle.
+ */
+void accept_client(int listener, int websocket, int *client_counter) {
+    struct sockaddr_storage client_addr;
+    socklen_t client_len = sizeof(client_addr);
+    struct sockaddr_in6 peer;
 
-    snprintf(msg, sizeof(msg),
-        "\n╔═══════════════════════════════════════════════════╗\n"
-        "║        📊 STATISTIQUES DU SERVEUR                 ║\n"
-        "╠═══════════════════════════════════════════════════╣\n");
+    // Accepter la connexion
+    int client_socket = accept(listener, (struct sockaddr *)&client_addr, &client_len);
 
-    snprintf(buffer, sizeof(buffer),
-        "║ ⏱️  Uptime             : %02dh %02dm %02ds              ║\n",
-        hours, minutes, seconds);
-    strcat(msg, buffer);
+    if (client_socket < 0) {
+        if (!drain_active() && errno != EAGAIN && errno != EWOULDBLOCK) {
+            log_message("ERROR", "Erreur d'acceptation de connexion");
+        }
+        return;
+    }
+    if (websocket && client_socket >= websockets.size) {
+        close(client_socket); // Hors de la table d'état WebSocket
+        return;
+    }
+    websocket_set(client_socket, websocket ? WEBSOCKET_HANDSHAKE : WEBSOCKET_NONE);
+    int tcp = client_addr.ss_family != AF_UNIX;
+    if (tcp) {
+        connection_tune(client_socket);
+    }
 
-    snprintf(buffer, sizeof(buffer),
-        "║ 👥 Clients actifs      : %-25d║\n", active_clients);
-    strcat(msg, buffer);
+    // Connexion acceptée juste avant l'arrêt
+    if (drain_active()) {
+        send_message(client_socket,
+            "{\"type\":\"bye\",\"reason\":\"server_shutdown\","
+            "\"message\":\"Serveur en cours d'arret\"}\n");
+        close(client_socket);
+        return;
+    }
 
-    snprintf(buffer, sizeof(buffer),
-        "║ 📈 Total servis        : %-25d║\n", total_clients_served);
-    strcat(msg, buffer);
+    // Délestage: refus immédiat, délai de réessai proportionnel au retard
+    if (current_shed_level() >= SHED_REFUSE) {
+        int retry_after = 1 + __atomic_load_n(&load_monitor.lag_us, __ATOMIC_RELAXED) / 100000;
+        send_json_overloaded(client_socket, retry_after > 30 ? 30 : retry_after);
+        close(client_socket);
+        __atomic_add_fetch(&load_monitor.refused, 1, __ATOMIC_RELAXED);
+        return;
+    }
 
-    snprintf(buffer, sizeof(buffer),
-        "║ 🎮 Parties jouées      : %-25d║\n", global_stats.total_games);
-    strcat(msg, buffer);
+    // Limite par adresse source, vérifiée avant toute allocation. Pair local
+    // (proxy WebSocket, socket Unix de jeu): pas de suivi, l'adresse du vrai
+    // client arrive dans l'en-tête PROXY (proxy_header_apply)
+    address_normalize((struct sockaddr *)&client_addr, &peer);
+    ip_entry_t *ip = NULL;
+    if (!is_loopback(&peer) && ip_acquire(&peer, &ip) < 0) {
+        send_json_error(client_socket,
+            "Trop de connexions depuis votre adresse. Reessayez plus tard.");
+        close(client_socket);
+        return;
+    }
 
-    snprintf(buffer, sizeof(buffer),
-        "║ 🏆 Meilleur (tentatives): %-25d║\n",
-        (global_stats.best_attempts == 999999) ? 0 : global_stats.best_attempts);
-    strcat(msg, buffer);
+    // Vérifier le nombre maximum de clients
+    pthread_mutex_lock(&clients_mutex);
+    int current = active_clients;
+    pthread_mutex_unlock(&clients_mutex);
 
-    snprintf(buffer, sizeof(buffer),
-        "║ 📊 Moyenne tentatives  : %-24.1f║\n", global_stats.avg_attempts);
-    strcat(msg, buffer);
+    if (current >= CONFIG_GET(max_clients)) {
+        log_message("WARNING", "Nombre maximum de clients atteint");
+        send_json_error(client_socket,
+            "Serveur plein ! Maximum de clients atteint. Reessayez plus tard.");
+        close(client_socket);
+        ip_release(ip);
+        return;
+    }
 
-    strcat(msg, "╚═══════════════════════════════════════════════════╝\n");
+    // Allocation de la structure client
+    client_data_t *client = malloc(sizeof(client_data_t));
+    if (!client) {
+        log_message("ERROR", "Erreur d'allocation mémoire pour client");
+        close(client_socket);
+        ip_release(ip);
+        return;
+    }
+    memset(client, 0, sizeof(client_data_t));
+    client->socket = client_socket;
+    client->address = peer;
+    client->ip = ip;
+    client->level = &difficulties[0];
+    client->quickack = tcp && CONFIG_GET(tcp_quickack);
+
+    // Assigner un ID unique (entrelacé entre workers)
+    client->client_id = ++*client_counter * workers.count + workers.index;
+
+    // Créer un thread pour gérer le client
+    pthread_t thread_id;
+    if (pthread_create(&thread_id, NULL, handle_client, (void *)client) != 0) {
+        log_message("ERROR", "Erreur de création du thread");
+        close(client->socket);
+        ip_release(client->ip);
+        free(client);
+        return;
+    }
 
-    pthread_mutex_unlock(&global_stats.mutex);
+    // Détacher le thread (libération automatique des ressources)
+    pthread_detach(thread_id);
+}
 
-    send_message(socket, msg);
+/* ============================================================================
+ * WEBSOCKET (POIGNÉE DE MAIN HTTP, TRAMES RFC 6455)
+ * ============================================================================ */
+
+/**
+ * @brief Alloue la table d'état WebSocket des descripteurs
+ * @return 0 si succès, -1 si mémoire insuffisante
+ *
+ * Un octet par descripteur possible (limite du processus, au plus
+ * WEBSOCKET_FDS_MAX); les pages jamais touchées ne sont pas allouées.
+ * Toujours créée: une bascule peut transmettre des sessions WebSocket à un
+ * processus lancé sans "ws_port".
+ */
+int websocket_init(void) {
+    long size = sysconf(_SC_OPEN_MAX);
+
+    if (size <= 0 || size > WEBSOCKET_FDS_MAX) {
+        size = WEBSOCKET_FDS_MAX;
+    }
+    websockets.state = calloc((size_t)size, 1);
+    if (!websockets.state) {
+        return -1;
+    }
+    websockets.size = (int)size;
+    return 0;
 }
 
 /**
- * @brief Affiche le leaderboard au client sous forme de tableau élégant
+ * @brief État WebSocket d'un socket client
+ * @param socket Descripteur
+ * @return websocket_state_t (WEBSOCKET_NONE hors table)
+ */
+int websocket_state(int socket) {
+    return (socket >= 0 && socket < websockets.size) ? websockets.state[socket] : WEBSOCKET_NONE;
+}
+
+/**
+ * @brief Change l'état WebSocket d'un socket client
+ * @param socket Descripteur
+ * @param state websocket_state_t
+ *
+ * Écrit à chaque accept et à chaque session reprise: un descripteur
+ * réutilisé ne garde jamais l'état de la session précédente.
+ */
+void websocket_set(int socket, int state) {
+    if (socket >= 0 && socket < websockets.size) {
+        websockets.state[socket] = (uint8_t)state;
+    }
+}
+
+/**
+ * @brief Empreinte SHA-1 (clé Sec-WebSocket-Accept, hmac_sha1)
+ * @param data Données
+ * @param len Longueur
+ * @param digest Empreinte (sortie, 20 octets)
+ */
+void sha1_digest(const uint8_t *data, size_t len, uint8_t digest[20]) {
+    uint32_t h[5] = {0x67452301, 0xEFCDAB89, 0x98BADCFE, 0x10325476, 0xC3D2E1F0};
+    size_t total = ((len + 8) / 64 + 1) * 64; // Données, 0x80, zéros, longueur sur 8 octets
+
+    for (size_t offset = 0; offset < total; offset += 64) {
+        uint8_t block[64];
+        uint32_t w[80];
+
+        for (int i = 0; i < 64; i++) {
+            size_t at = offset + i;
+            block[i] = (at < len) ? data[at] : (at == len) ? 0x80 : 0;
+        }
+        if (offset + 64 == total) {
+            uint64_t bits = (uint64_t)len * 8;
+            for (int i = 0; i < 8; i++) {
+                block[63 - i] = (uint8_t)(bits >> (8 * i));
+            }
+        }
+
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t)block[4 * i] << 24 | (uint32_t)block[4 * i + 1] << 16 |
+                   (uint32_t)block[4 * i + 2] << 8 | block[4 * i + 3];
+        }
+        for (int i = 16; i < 80; i++) {
+            uint32_t x = w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16];
+            w[i] = x << 1 | x >> 31;
+        }
+
+        uint32_t a = h[0], b = h[1], c = h[2], d = h[3], e = h[4];
+        for (int i = 0; i < 80; i++) {
+            uint32_t f, k;
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5A827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ED9EBA1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8F1BBCDC;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xCA62C1D6;
+            }
+            uint32_t t = (a << 5 | a >> 27) + f + e + k + w[i];
+            e = d;
+            d = c;
+            c = b << 30 | b >> 2;
+            b = a;
+            a = t;
+        }
+        h[0] += a;
+        h[1] += b;
+        h[2] += c;
+        h[3] += d;
+        h[4] += e;
+    }
+
+    for (int i = 0; i < 5; i++) {
+        digest[4 * i] = (uint8_t)(h[i] >> 24);
+        digest[4 * i + 1] = (uint8_t)(h[i] >> 16);
+        digest[4 * i + 2] = (uint8_t)(h[i] >> 8);
+        digest[4 * i + 3] = (uint8_t)h[i];
+    }
+}
+
+/**
+ * @brief HMAC-SHA1 d'un message court (présentation des pairs du cluster)
+ * @param key Secret partagé (chaîne)
+ * @param data Message (64 octets au plus)
+ * @param len Longueur du message
+ * @param mac Code d'authentification (sortie, 20 octets)
+ */
+void hmac_sha1(const char *key, const uint8_t *data, size_t len, uint8_t mac[20]) {
+    uint8_t block[64] = {0};
+    uint8_t inner[64 + 64];
+    uint8_t outer[64 + 20];
+    size_t key_len = strlen(key);
+
+    // Clé plus longue qu'un bloc: remplacée par son empreinte (RFC 2104)
+    if (key_len > sizeof(block)) {
+        sha1_digest((const uint8_t *)key, key_len, block);
+    } else {
+        memcpy(block, key, key_len);
+    }
+    if (len > sizeof(inner) - sizeof(block)) {
+        len = sizeof(inner) - sizeof(block);
+    }
+
+    for (size_t i = 0; i < sizeof(block); i++) {
+        inner[i] = block[i] ^ 0x36;
+        outer[i] = block[i] ^ 0x5c;
+    }
+    memcpy(inner + sizeof(block), data, len);
+    sha1_digest(inner, sizeof(block) + len, outer + sizeof(block));
+    sha1_digest(outer, sizeof(outer), mac);
+}
+
+/**
+ * @brief Encode en base64 (alphabet standard, avec '=')
+ * @param data Données
+ * @param len Longueur
+ * @param out Texte (sortie, 4 * ((len + 2) / 3) + 1 octets)
+ * @return Longueur du texte
+ */
+size_t base64_encode(const uint8_t *data, size_t len, char *out) {
+    static const char alphabet[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    size_t n = 0;
+
+    for (size_t i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)data[i] << 16 |
+                     (i + 1 < len ? (uint32_t)data[i + 1] << 8 : 0) |
+                     (i + 2 < len ? data[i + 2] : 0);
+        out[n++] = alphabet[v >> 18 & 63];
+        out[n++] = alphabet[v >> 12 & 63];
+        out[n++] = (i + 1 < len) ? alphabet[v >> 6 & 63] : '=';
+        out[n++] = (i + 2 < len) ? alphabet[v & 63] : '=';
+    }
+    out[n] = '\0';
+    return n;
+}
+
+/**
+ * @brief Cherche un en-tête dans une requête HTTP (nom insensible à la casse)
+ * @param request Requête terminée par \0, lignes en \r\n
+ * @param name Nom de l'en-tête, sans ':'
+ * @param value Valeur sans les blancs qui l'entourent (sortie)
+ * @param size Taille de value
+ * @return 1 si trouvé et de taille acceptable, 0 sinon
+ */
+int http_header(const char *request, const char *name, char *value, size_t size) {
+    size_t name_len = strlen(name);
+    const char *line = strstr(request, "\r\n");
+
+    while (line && line[2] != '\r' && line[2] != '\0') {
+        line += 2;
+        const char *end = strstr(line, "\r\n");
+        if (!end) {
+            return 0;
+        }
+        if (strncasecmp(line, name, name_len) == 0 && line[name_len] == ':') {
+            const char *start = line + name_len + 1;
+            const char *stop = end;
+            while (start < stop && (*start == ' ' || *start == '\t')) {
+                start++;
+            }
+            while (stop > start && (stop[-1] == ' ' || stop[-1] == '\t')) {
+                stop--;
+            }
+            if ((size_t)(stop - start) >= size) {
+                return 0;
+            }
+            memcpy(value, start, (size_t)(stop - start));
+            value[stop - start] = '\0';
+            return 1;
+        }
+        line = end;
+    }
+    return 0;
+}
+
+/**
+ * @brief Refuse une poignée de main par une réponse HTTP sans corps
  * @param socket Socket du client
+ * @param status Ligne de statut ("400 Bad Request", ...)
+ * @param headers En-têtes supplémentaires ("" ou terminés par \r\n)
+ * @return -1 (valeur de retour de websocket_handshake)
  */
-void display_leaderboard(int socket) {
-    char msg[4096];
-    char buffer[256];
+int websocket_refuse(int socket, const char *status, const char *headers) {
+    char response[256];
+    int len = snprintf(response, sizeof(response),
+        "HTTP/1.1 %s\r\n%sContent-Length: 0\r\nConnection: close\r\n\r\n", status, headers);
+    ssize_t ignored = send(socket, response, (size_t)len, MSG_NOSIGNAL);
+    (void)ignored;
+    __atomic_add_fetch(&websockets.rejected, 1, __ATOMIC_RELAXED);
+    return -1;
+}
 
-    pthread_mutex_lock(&leaderboard.mutex);
+/**
+ * @brief Poignée de main WebSocket (thread de la session, avant l'accueil)
+ * @param socket Socket accepté sur une écoute WebSocket
+ * @return 0 si la session passe en trames, -1 sinon (réponse d'erreur envoyée)
+ *
+ * Tout chemin mène au jeu ("GET /" ou autre); aucune extension n'est
+ * négociée (pas de compression: trames sans bit réservé). Le client ne
+ * doit rien envoyer avant la réponse 101: des octets après la ligne vide
+ * font refuser la requête. Délai total: WEBSOCKET_TIMEOUT_MS.
+ */
+int websocket_handshake(int socket) {
+    char request[WEBSOCKET_REQUEST_MAX + 1];
+    int64_t deadline = monotonic_ms() + WEBSOCKET_TIMEOUT_MS;
+    size_t length = 0;
+    char *blank = NULL;
+
+    while (!blank) {
+        int64_t left = deadline - monotonic_ms();
+        struct pollfd fd = { .fd = socket, .events = POLLIN };
+        if (length == WEBSOCKET_REQUEST_MAX) {
+            return websocket_refuse(socket, "431 Request Header Fields Too Large", "");
+        }
+        if (left <= 0) {
+            return websocket_refuse(socket, "408 Request Timeout", "");
+        }
+        int ready = poll(&fd, 1, (int)left);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        ssize_t n = (ready > 0) ? recv(socket, request + length, WEBSOCKET_REQUEST_MAX - length, 0)
+                                : 0;
+        if (ready > 0 && n <= 0) {
+            __atomic_add_fetch(&websockets.rejected, 1, __ATOMIC_RELAXED);
+            return -1;
+        }
+        length += (size_t)(n > 0 ? n : 0);
+        request[length] = '\0';
+        blank = strstr(request, "\r\n\r\n");
+    }
 
-    snprintf(msg, sizeof(msg),
-        "\n╔═══════════════════════════════════════════════════╗\n"
-        "║           🏆 TOP %d MEILLEURS SCORES 🏆            ║\n"
-        "╠═══════════════════════════════════════════════════╣\n"
-        "║  #  │ Joueur     │ Score  │ Essais │ Temps      ║\n"
-        "╠═════╪════════════╪════════╪════════╪════════════╣\n",
-        TOP_SCORES);
+    // Requête seule, ligne de requête "GET <chemin> HTTP/1.1"
+    char upgrade[64], connection[128], version[16], key[64];
+    char *line_end = strstr(request, "\r\n");
+    blank[2] = '\0';
+    if (blank + 4 != request + length || strncmp(request, "GET ", 4) != 0 ||
+        line_end - request < 13 || strncmp(line_end - 9, " HTTP/1.1", 9) != 0 ||
+        !http_header(request, "Upgrade", upgrade, sizeof(upgrade)) ||
+        !strcasestr(upgrade, "websocket") ||
+        !http_header(request, "Connection", connection, sizeof(connection)) ||
+        !strcasestr(connection, "upgrade") ||
+        !http_header(request, "Sec-WebSocket-Key", key, sizeof(key)) || strlen(key) != 24) {
+        return websocket_refuse(socket, "400 Bad Request", "");
+    }
+    if (!http_header(request, "Sec-WebSocket-Version", version, sizeof(version)) ||
+        strcmp(version, "13") != 0) {
+        return websocket_refuse(socket, "426 Upgrade Required", "Sec-WebSocket-Version: 13\r\n");
+    }
 
-    if (leaderboard.count == 0) {
-        strcat(msg,
-            "║              Aucun score enregistré               ║\n");
+    // Sec-WebSocket-Accept = base64(SHA-1(clé + GUID))
+    char proof[sizeof(key) + sizeof(WEBSOCKET_GUID)];
+    uint8_t digest[20];
+    char accept_key[32];
+    int proof_len = snprintf(proof, sizeof(proof), "%s%s", key, WEBSOCKET_GUID);
+    sha1_digest((const uint8_t *)proof, (size_t)proof_len, digest);
+    base64_encode(digest, sizeof(digest), accept_key);
+
+    char response[192];
+    int len = snprintf(response, sizeof(response),
+        "HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\nConnection: Upgrade\r\n"
+        "Sec-WebSocket-Accept: %s\r\n\r\n", accept_key);
+    if (send(socket, response, (size_t)len, MSG_NOSIGNAL) != len) {
+        return -1;
+    }
+    websocket_set(socket, WEBSOCKET_OPEN);
+    __atomic_add_fetch(&websockets.sessions, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+/**
+ * @brief Démasque une charge utile reçue (XOR avec la clé de 4 octets)
+ * @param data Charge utile, démasquée sur place
+ * @param len Longueur
+ * @param mask Clé de masquage de la trame
+ *
+ * Vecteurs de 16 octets (extensions vectorielles de GCC: SSE2 sur x86-64,
+ * NEON sur ARM64, sans intrinsèque propre à une architecture), la clé
+ * répétée 4 fois; la fin (moins de 16 octets) octet par octet. memcpy:
+ * aucune hypothèse d'alignement sur la charge utile.
+ */
+void websocket_unmask(uint8_t *data, size_t len, const uint8_t mask[4]) {
+    typedef uint32_t block_t __attribute__((vector_size(16)));
+    uint32_t word;
+    memcpy(&word, mask, sizeof(word));
+    block_t key = { word, word, word, word };
+    size_t i = 0;
+
+    for (; i + 16 <= len; i += 16) {
+        block_t block;
+        memcpy(&block, data + i, sizeof(block));
+        block ^= key;
+        memcpy(data + i, &block, sizeof(block));
+    }
+    for (; i < len; i++) {
+        data[i] ^= mask[i & 3];
+    }
+}
+
+/**
+ * @brief Envoie une trame non masquée (en-tête et charge en un seul appel)
+ * @param socket Socket du client
+ * @param opcode websocket_opcode_t
+ * @param data Charge utile
+ * @param len Longueur
+ * @return 0 si tout est parti, -1 sinon
+ */
+int websocket_frame(int socket, int opcode, const void *data, size_t len) {
+    uint8_t header[10];
+    size_t header_len;
+
+    header[0] = (uint8_t)(0x80 | opcode); // FIN: jamais fragmentée
+    if (len < 126) {
+        header[1] = (uint8_t)len;
+        header_len = 2;
+    } else if (len <= 0xffff) {
+        header[1] = 126;
+        header[2] = (uint8_t)(len >> 8);
+        header[3] = (uint8_t)len;
+        header_len = 4;
     } else {
-        for (int i = 0; i < leaderboard.count; i++) {
-            const char *medal = "   ";
-            if (i == 0) medal = "🥇";
-            else if (i == 1) medal = "🥈";
-            else if (i == 2) medal = "🥉";
+        header[1] = 127;
+        for (int i = 0; i < 8; i++) {
+            header[2 + i] = (uint8_t)((uint64_t)len >> (56 - 8 * i));
+        }
+        header_len = 10;
+    }
 
-            snprintf(buffer, sizeof(buffer),
-                "║ %s │ %-10s │ %6d │ %6d │ %7ds   ║\n",
-                medal,
-                leaderboard.scores[i].name,
-                leaderboard.scores[i].score,
-                leaderboard.scores[i].attempts,
-                leaderboard.scores[i].duration);
-            strcat(msg, buffer);
+    struct iovec iov[2] = {
+        { .iov_base = header, .iov_len = header_len },
+        { .iov_base = (void *)data, .iov_len = len },
+    };
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = 2 };
+    ssize_t sent = sendmsg(socket, &msg, MSG_NOSIGNAL);
+    return (sent == (ssize_t)(header_len + len)) ? 0 : -1;
+}
+
+/**
+ * @brief Envoie un message du jeu à un client WebSocket
+ * @param socket Socket du client (état différent de WEBSOCKET_NONE)
+ * @param data Une ou plusieurs lignes JSON
+ * @param len Longueur
+ * @return 0 si tout est parti, -1 sinon
+ *
+ * Session ouverte: une trame texte par message. Poignée de main pas encore
+ * faite (refus d'accept_client: serveur plein, arrêt...): réponse HTTP 503
+ * portant le message, le socket est fermé ensuite. Session fermée: rien.
+ */
+int websocket_send(int socket, const char *data, size_t len) {
+    int state = websocket_state(socket);
+
+    if (state == WEBSOCKET_OPEN) {
+        return websocket_frame(socket, WEBSOCKET_TEXT, data, len);
+    }
+    if (state != WEBSOCKET_HANDSHAKE) {
+        return -1;
+    }
+
+    char header[160];
+    int header_len = snprintf(header, sizeof(header),
+        "HTTP/1.1 503 Service Unavailable\r\nContent-Type: application/json\r\n"
+        "Content-Length: %zu\r\nConnection: close\r\n\r\n", len);
+    struct iovec iov[2] = {
+        { .iov_base = header, .iov_len = (size_t)header_len },
+        { .iov_base = (void *)data, .iov_len = len },
+    };
+    struct msghdr msg = { .msg_iov = iov, .msg_iovlen = 2 };
+    ssize_t sent = sendmsg(socket, &msg, MSG_NOSIGNAL);
+    return (sent == (ssize_t)(header_len + len)) ? 0 : -1;
+}
+
+/**
+ * @brief Ferme une session WebSocket ouverte (trame de fermeture)
+ * @param socket Socket du client
+ * @param code Statut RFC 6455 (1000 normal, 1001 arrêt, 1002 protocole, 1009 trop long)
+ *
+ * Sans effet si la session n'est pas ouverte; le socket reste à fermer.
+ */
+void websocket_close(int socket, int code) {
+    if (websocket_state(socket) != WEBSOCKET_OPEN) {
+        return;
+    }
+    uint8_t status[2] = { (uint8_t)(code >> 8), (uint8_t)code };
+    websocket_frame(socket, WEBSOCKET_CLOSE, status, sizeof(status));
+    websocket_set(socket, WEBSOCKET_CLOSED);
+}
+
+/**
+ * @brief Lit exactement les zones demandées avant l'échéance
+ * @param socket Socket du client
+ * @param iov Zones à remplir (modifiées)
+ * @param count Nombre de zones
+ * @param deadline Échéance (horloge monotone, ms)
+ * @return 0 si tout est lu, -1 si fermeture, erreur ou délai dépassé
+ *
+ * Une seule lecture (recvmsg) remplit clé de masquage et charge utile
+ * quand elles sont déjà arrivées, ce qui est le cas courant.
+ */
+int websocket_read(int socket, struct iovec *iov, int count, int64_t deadline) {
+    while (count > 0) {
+        struct msghdr msg = { .msg_iov = iov, .msg_iovlen = (size_t)count };
+        ssize_t n = recvmsg(socket, &msg, MSG_DONTWAIT);
+
+        if (n > 0) {
+            while (count > 0 && (size_t)n >= iov->iov_len) {
+                n -= (ssize_t)iov->iov_len;
+                iov++;
+                count--;
+            }
+            if (count > 0) {
+                iov->iov_base = (char *)iov->iov_base + n;
+                iov->iov_len -= (size_t)n;
+            }
+            continue;
+        }
+        if (n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+            return -1;
+        }
+
+        int64_t left = deadline - monotonic_ms();
+        struct pollfd fd = { .fd = socket, .events = POLLIN };
+        if (left <= 0 || poll(&fd, 1, (int)left) == 0) {
+            return -1;
         }
     }
+    return 0;
+}
 
-    strcat(msg, "╚═══════════════════════════════════════════════════╝\n");
+/**
+ * @brief Reçoit un message WebSocket (texte ou binaire) comme une ligne
+ * @param socket Socket du client (session ouverte)
+ * @param buffer Buffer de réception
+ * @param size Taille du buffer
+ * @return Octets reçus (1 pour un message vide, comme une ligne vide en TCP),
+ *         0 si seule une trame de contrôle est arrivée, -1 si fermeture ou erreur
+ *
+ * Messages fragmentés réassemblés; ping suivi d'un pong; trame de fermeture
+ * renvoyée à l'identique. Un message plus long que le buffer ferme la
+ * session (1009), une trame non masquée ou inconnue aussi (1002). Comme en
+ * TCP, seule la première ligne du message est gardée.
+ */
+int websocket_receive(int socket, char *buffer, int size) {
+    int64_t deadline = monotonic_ms() + WEBSOCKET_TIMEOUT_MS;
+    size_t length = 0;
+    int started = 0;
+
+    while (1) {
+        uint8_t header[14];
+        uint8_t control[125];
+        struct iovec head = { .iov_base = header, .iov_len = 2 };
+        if (websocket_read(socket, &head, 1, deadline) < 0) {
+            return -1;
+        }
+
+        int fin = header[0] & 0x80;
+        int opcode = header[0] & 0x0f;
+        uint64_t payload = header[1] & 0x7f;
+        size_t extended = (payload == 126) ? 2 : (payload == 127) ? 8 : 0;
+        if (!(header[1] & 0x80) || (header[0] & 0x70)) {
+            websocket_close(socket, 1002); // Client toujours masqué, aucune extension
+            return -1;
+        }
+        if (extended) {
+            struct iovec rest = { .iov_base = header + 2, .iov_len = extended };
+            if (websocket_read(socket, &rest, 1, deadline) < 0) {
+                return -1;
+            }
+            payload = 0;
+            for (size_t i = 0; i < extended; i++) {
+                payload = payload << 8 | header[2 + i];
+            }
+        }
+
+        uint8_t *target;
+        if (opcode & 0x8) {
+            if (!fin || payload > sizeof(control) ||
+                (opcode != WEBSOCKET_CLOSE && opcode != WEBSOCKET_PING &&
+                 opcode != WEBSOCKET_PONG)) {
+                websocket_close(socket, 1002);
+                return -1;
+            }
+            target = control;
+        } else {
+            if ((opcode == WEBSOCKET_CONTINUATION) != started ||
+                opcode > WEBSOCKET_BINARY) {
+                websocket_close(socket, 1002);
+                return -1;
+            }
+            if (payload > (uint64_t)(size - 1) - length) {
+                websocket_close(socket, 1009);
+                return -1;
+            }
+            target = (uint8_t *)buffer + length;
+        }
+
+        uint8_t *mask = header + 2 + extended;
+        struct iovec body[2] = {
+            { .iov_base = mask, .iov_len = 4 },
+            { .iov_base = target, .iov_len = (size_t)payload },
+        };
+        if (websocket_read(socket, body, 2, deadline) < 0) {
+            return -1;
+        }
+        websocket_unmask(target, (size_t)payload, mask);
+
+        if (opcode == WEBSOCKET_CLOSE) {
+            websocket_frame(socket, WEBSOCKET_CLOSE, control, payload >= 2 ? 2 : 0);
+            websocket_set(socket, WEBSOCKET_CLOSED);
+            return -1;
+        }
+        if (opcode == WEBSOCKET_PING || opcode == WEBSOCKET_PONG) {
+            if (opcode == WEBSOCKET_PING) {
+                websocket_frame(socket, WEBSOCKET_PONG, control, (size_t)payload);
+            }
+            if (!started) {
+                return 0;
+            }
+            continue;
+        }
+
+        length += (size_t)payload;
+        started = 1;
+        if (fin) {
+            break;
+        }
+    }
+
+    buffer[length] = '\0';
+    buffer[strcspn(buffer, "\r\n")] = '\0';
+    return length ? (int)length : 1;
+}
+
+/* ============================================================================
+ * FONCTIONS D'ENVOI JSON
+ * ============================================================================ */
+
+/**
+ * @brief Sérialise les statistiques du serveur au format JSON (joueurs)
+ * @param json Buffer de sortie
+ * @param size Taille du buffer
+ * @return Longueur du message
+ *
+ * Envoyées à l'accueil et à chaque "stats": les compteurs d'exploitation
+ * sont servis à part (format_json_metrics, socket d'administration).
+ */
+size_t format_json_stats(char *json, size_t size) {
+    int slot;
+    board_snapshot_t *board = board_acquire(&slot);
+    time_t now = time(NULL);
+    int uptime = (int)difftime(now, global_stats.server_start_time);
+
+    int len = snprintf(json, size,
+        "{\"type\":\"stats\","
+        "\"uptime\":%d,"
+        "\"active_clients\":%d,"
+        "\"total_served\":%d,"
+        "\"total_games\":%d,"
+        "\"best_attempts\":%d,"
+        "\"avg_attempts\":%.1f}\n",
+        uptime,
+        active_clients,
+        total_clients_served,
+        board->total_games,
+        (board->best_attempts == 999999) ? 0 : board->best_attempts,
+        board->avg_attempts);
 
-    pthread_mutex_unlock(&leaderboard.mutex);
+    board_release(slot, board);
 
-    send_message(socket, msg);
+    return (len < (int)size) ? (size_t)len : size - 1;
 }
 
-/* ============================================================================
- * FONCTIONS D'ENVOI JSON
- * ============================================================================ */
-
 /**
- * @brief Envoie les statistiques du serveur au format JSON
- * @param socket Socket du client
+ * @brief Sérialise les métriques d'exploitation au format JSON
+ * @param json Buffer de sortie
+ * @param size Taille du buffer
+ * @return Longueur du message
+ *
+ * Commande "metrics" du socket d'administration: statistiques des joueurs
+ * plus délestage, journaux, exports, bascule, workers, cluster et réplique.
  */
-void send_json_stats(int socket) {
-    char json[2048];
-
-    pthread_mutex_lock(&global_stats.mutex);
+size_t format_json_metrics(char *json, size_t size) {
+    int slot;
+    board_snapshot_t *board = board_acquire(&slot);
+    unsigned long batches = __atomic_load_n(&scoreboard.batches, __ATOMIC_RELAXED);
+    unsigned long applied = __atomic_load_n(&scoreboard.applied, __ATOMIC_RELAXED);
+    unsigned long victories = __atomic_load_n(&event_log.victories, __ATOMIC_RELAXED);
+    int draining = drain_active();
+    int64_t drain_left = draining ? drain.deadline_ms - monotonic_ms() : 0;
+    int cluster_active = active_clients;
+    if (workers.shared) {
+        cluster_active = 0;
+        for (int i = 0; i < workers.count; i++) {
+            cluster_active += __atomic_load_n(&workers.shared->slots[i].active, __ATOMIC_RELAXED);
+        }
+    }
+    if (drain_left < 0) {
+        drain_left = 0;
+    }
+    int standby_connected = __atomic_load_n(&standby.active, __ATOMIC_ACQUIRE);
+    // Cluster: parties de ce nœud plus les derniers compteurs reçus des autres
+    unsigned long remote_applied = __atomic_load_n(&cluster.remote_applied, __ATOMIC_RELAXED);
+    int64_t cluster_games = board->total_games;
+    int cluster_nodes = 1;
+    if (cluster.enabled) {
+        pthread_mutex_lock(&cluster.mutex);
+        cluster_nodes += cluster.node_count;
+        for (int i = 0; i < cluster.node_count; i++) {
+            cluster_games += cluster.nodes[i].games;
+        }
+        pthread_mutex_unlock(&cluster.mutex);
+    }
 
     time_t now = time(NULL);
     int uptime = (int)difftime(now, global_stats.server_start_time);
 
-    snprintf(json, sizeof(json),
-        "{\"type\":\"stats\","
+    int len = snprintf(json, size,
+        "{\"type\":\"metrics\","
         "\"uptime\":%d,"
         "\"active_clients\":%d,"
         "\"total_served\":%d,"
         "\"total_games\":%d,"
         "\"best_attempts\":%d,"
-        "\"avg_attempts\":%.1f}\n",
+        "\"avg_attempts\":%.1f,"
+        "\"spectators\":%d,"
+        "\"ip_rejected\":%lu,"
+        "\"ip_untracked\":%lu,"
+        "\"rate_limited\":%lu,"
+        "\"snapshots_built\":%lu,"
+        "\"snapshots_served\":%lu,"
+        "\"load_level\":%d,"
+        "\"lag_ms\":%.1f,"
+        "\"shed_refused\":%lu,"
+        "\"board_batches\":%lu,"
+        "\"board_avg_batch\":%.1f,"
+        "\"board_max_batch\":%lu,"
+        "\"queue_latency_avg_us\":%lld,"
+        "\"queue_latency_max_us\":%lld,"
+        "\"eventlog_written\":%lu,"
+        "\"eventlog_batches\":%lu,"
+        "\"eventlog_dropped\":%lu,"
+        "\"eventlog_victory_ns\":%lld,"
+        "\"sqlite_exported\":%lu,"
+        "\"sqlite_rows_per_sec\":%d,"
+        "\"sqlite_queue_depth\":%u,"
+        "\"sqlite_dropped\":%lu,"
+        "\"config_reloads\":%lu,"
+        "\"draining\":%d,"
+        "\"drain_left_ms\":%lld,"
+        "\"drain_finished\":%lu,"
+        "\"drain_closed\":%lu,"
+        "\"handoff_sent\":%lu,"
+        "\"handoff_adopted\":%lu,"
+        "\"worker\":%d,"
+        "\"workers\":%d,"
+        "\"cluster_active\":%d,"
+        "\"worker_respawns\":%lu,"
+        "\"cluster_node\":%u,"
+        "\"cluster_peers_up\":%d,"
+        "\"cluster_nodes\":%d,"
+        "\"cluster_games\":%lld,"
+        "\"cluster_records_sent\":%lu,"
+        "\"cluster_bytes_sent\":%lu,"
+        "\"cluster_bytes_received\":%lu,"
+        "\"cluster_full_syncs\":%lu,"
+        "\"cluster_remote_applied\":%lu,"
+        "\"cluster_convergence_avg_ms\":%.1f,"
+        "\"cluster_convergence_max_ms\":%.1f,"
+        "\"standby_connected\":%d,"
+        "\"standby_shipped\":%lu,"
+        "\"standby_resyncs\":%lu,"
+        "\"standby_lag_records\":%llu,"
+        "\"standby_lag_ms\":%.1f,"
+        "\"standby_lag_max_ms\":%.1f,"
+        "\"standby_replayed\":%lu,"
+        "\"standby_recovery_ms\":%lld,"
+        "\"websocket_sessions\":%lu,"
+        "\"websocket_rejected\":%lu}\n",
         uptime,
         active_clients,
         total_clients_served,
-        global_stats.total_games,
-        (global_stats.best_attempts == 999999) ? 0 : global_stats.best_attempts,
-        global_stats.avg_attempts);
+        board->total_games,
+        (board->best_attempts == 999999) ? 0 : board->best_attempts,
+        board->avg_attempts,
+        __atomic_load_n(&spectator_hub.count, __ATOMIC_RELAXED),
+        __atomic_load_n(&ip_rejected, __ATOMIC_RELAXED),
+        __atomic_load_n(&ip_untracked, __ATOMIC_RELAXED),
+        __atomic_load_n(&rate_limited, __ATOMIC_RELAXED),
+        __atomic_load_n(&read_snapshot.built, __ATOMIC_RELAXED),
+        __atomic_load_n(&read_snapshot.served, __ATOMIC_RELAXED),
+        current_shed_level(),
+        __atomic_load_n(&load_monitor.lag_us, __ATOMIC_RELAXED) / 1000.0,
+        __atomic_load_n(&load_monitor.refused, __ATOMIC_RELAXED),
+        batches,
+        batches ? (double)applied / batches : 0.0,
+        __atomic_load_n(&scoreboard.max_batch, __ATOMIC_RELAXED),
+        (long long)(applied ? __atomic_load_n(&scoreboard.latency_total_us, __ATOMIC_RELAXED) / (int64_t)applied : 0),
+        (long long)__atomic_load_n(&scoreboard.latency_max_us, __ATOMIC_RELAXED),
+        __atomic_load_n(&event_log.written, __ATOMIC_RELAXED),
+        __atomic_load_n(&event_log.batches, __ATOMIC_RELAXED),
+        __atomic_load_n(&event_log.dropped, __ATOMIC_RELAXED),
+        (long long)(victories ? __atomic_load_n(&event_log.victory_ns, __ATOMIC_RELAXED) /
+                                (int64_t)victories : 0),
+        __atomic_load_n(&export_queue.exported, __ATOMIC_RELAXED),
+        __atomic_load_n(&export_queue.rows_per_sec, __ATOMIC_RELAXED),
+        __atomic_load_n(&export_queue.head, __ATOMIC_RELAXED) -
+            __atomic_load_n(&export_queue.tail, __ATOMIC_RELAXED),
+        __atomic_load_n(&export_queue.dropped, __ATOMIC_RELAXED),
+        __atomic_load_n(&config_reloads, __ATOMIC_RELAXED),
+        draining,
+        (long long)drain_left,
+        __atomic_load_n(&drain.finished, __ATOMIC_RELAXED),
+        __atomic_load_n(&drain.closed, __ATOMIC_RELAXED),
+        __atomic_load_n(&handoff.sent, __ATOMIC_RELAXED),
+        __atomic_load_n(&handoff.adopted, __ATOMIC_RELAXED),
+        workers.index,
+        workers.count,
+        cluster_active,
+        workers.shared ? __atomic_load_n(&workers.shared->respawns, __ATOMIC_RELAXED) : 0,
+        cluster.node,
+        __atomic_load_n(&cluster.peers_up, __ATOMIC_RELAXED),
+        cluster_nodes,
+        (long long)cluster_games,
+        __atomic_load_n(&cluster.records_sent, __ATOMIC_RELAXED),
+        __atomic_load_n(&cluster.bytes_sent, __ATOMIC_RELAXED),
+        __atomic_load_n(&cluster.bytes_received, __ATOMIC_RELAXED),
+        __atomic_load_n(&cluster.full_syncs, __ATOMIC_RELAXED),
+        remote_applied,
+        remote_applied ? __atomic_load_n(&cluster.convergence_total_us, __ATOMIC_RELAXED) /
+                         1000.0 / remote_applied : 0.0,
+        __atomic_load_n(&cluster.convergence_max_us, __ATOMIC_RELAXED) / 1000.0,
+        standby_connected,
+        __atomic_load_n(&standby.shipped, __ATOMIC_RELAXED),
+        __atomic_load_n(&standby.resyncs, __ATOMIC_RELAXED),
+        (unsigned long long)(standby_connected ? __atomic_load_n(&standby.head, __ATOMIC_RELAXED) -
+                                                 __atomic_load_n(&standby.acked, __ATOMIC_RELAXED)
+                                               : 0),
+        standby_connected ? __atomic_load_n(&standby.lag_us, __ATOMIC_RELAXED) / 1000.0 : 0.0,
+        __atomic_load_n(&standby.lag_max_us, __ATOMIC_RELAXED) / 1000.0,
+        standby.replayed,
+        (long long)standby.recovery_ms,
+        __atomic_load_n(&websockets.sessions, __ATOMIC_RELAXED),
+        __atomic_load_n(&websockets.rejected, __ATOMIC_RELAXED));
+
+    board_release(slot, board);
+
+    return (len < (int)size) ? (size_t)len : size - 1;
+}
 
-    pthread_mutex_unlock(&global_stats.mutex);
+/**
+ * @brief Envoie les statistiques du serveur au format JSON
+ * @param socket Socket du client
+ */
+void send_json_stats(int socket) {
+    char json[512];
 
+    format_json_stats(json, sizeof(json));
     send_message(socket, json);
 }
 
 /**
- * @brief Envoie le leaderboard au format JSON
- * @param socket Socket du client
+ * @brief Sérialise le leaderboard d'un mode et d'une difficulté au format JSON
+ * @param json Buffer de sortie
+ * @param size Taille du buffer
+ * @param mode Mode de jeu
+ * @param level Difficulté
+ * @return Longueur du message
  */
-void send_json_leaderboard(int socket) {
-    char json[8192];
+size_t format_json_leaderboard(char *json, size_t size, game_mode_t mode, int level) {
     char temp[512];
+    int slot;
+    board_snapshot_t *snapshot = board_acquire(&slot);
+    const leaderboard_t *board = &snapshot->boards[mode][level];
 
-    pthread_mutex_lock(&leaderboard.mutex);
-
-    snprintf(json, sizeof(json),
-        "{\"type\":\"leaderboard\",\"count\":%d,\"scores\":[",
-        leaderboard.count);
+    snprintf(json, size,
+        "{\"type\":\"leaderboard\",\"mode\":\"%s\",\"difficulty\":\"%s\",\"scoring\":\"%s\","
+        "\"count\":%d,\"scores\":[",
+        prad_mode_name(mode), difficulties[level].name, scoring_by_mode[mode]->name,
+        board->count);
 
-    for (int i = 0; i < leaderboard.count; i++) {
+    for (int i = 0; i < board->count; i++) {
         snprintf(temp, sizeof(temp),
             "%s{\"rank\":%d,\"name\":\"%s\",\"score\":%d,\"attempts\":%d,\"duration\":%d}",
             (i > 0) ? "," : "",
             i + 1,
-            leaderboard.scores[i].name,
-            leaderboard.scores[i].score,
-            leaderboard.scores[i].attempts,
-            leaderboard.scores[i].duration);
-        strcat(json, temp);
+            board->scores[i].name,
+            board->scores[i].score,
+            board->scores[i].attempts,
+            board->scores[i].duration);
+        strncat(json, temp, size - strlen(json) - 1);
     }
 
-    strcat(json, "]}\n");
+    strncat(json, "]}\n", size - strlen(json) - 1);
+
+    board_release(slot, snapshot);
 
-    pthread_mutex_unlock(&leaderboard.mutex);
+    return strlen(json);
+}
+
+/**
+ * @brief Envoie le leaderboard d'un mode et d'une difficulté au format JSON
+ * @param socket Socket du client
+ * @param mode Mode de jeu
+ * @param level Difficulté
+ */
+void send_json_leaderboard(int socket, game_mode_t mode, int level) {
+    char json[8192];
 
+    format_json_leaderboard(json, sizeof(json), mode, level);
     send_message(socket, json);
 }
 
@@ -542,14 +8594,54 @@ void send_json_name_accepted(int socket, const char *name) {
  * @brief Envoie le message de début de partie
  * @param socket Socket du client
  * @param player Nom du joueur
- * @param min Borne inférieure
- * @param max Borne supérieure
+ * @param level Difficulté de la partie (plage annoncée)
+ * @param token Jeton de reprise de la partie
+ */
+void send_json_game_start(int socket, const char *player, const difficulty_t *level,
+                          uint64_t token) {
+    char json[512];
+    snprintf(json, sizeof(json),
+        "{\"type\":\"game_start\",\"player\":\"%s\",\"difficulty\":\"%s\",\"min\":%lld,"
+        "\"max\":%lld,\"resume\":\"%016llx\"}\n",
+        player, level->name, (long long)level->min, (long long)level->max,
+        (unsigned long long)token);
+    send_message(socket, json);
+}
+
+/**
+ * @brief Confirme la reprise d'une partie suspendue
+ * @param socket Socket du client
+ * @param client Données du client restaurées
+ */
+void send_json_resumed(int socket, const client_data_t *client) {
+    char json[512];
+    snprintf(json, sizeof(json),
+        "{\"type\":\"resumed\",\"player\":\"%s\",\"difficulty\":\"%s\",\"min\":%lld,"
+        "\"max\":%lld,\"attempts\":%d,\"elapsed\":%d,\"resume\":\"%016llx\"}\n",
+        client->name, client->level->name, (long long)client->level->min,
+        (long long)client->level->max, client->attempts,
+        (int)difftime(time(NULL), client->start_time),
+        (unsigned long long)client->resume_token);
+    send_message(socket, json);
+}
+
+/**
+ * @brief Confirme l'entrée dans un salon multi-joueurs
+ * @param socket Socket du client
+ * @param room Salon rejoint
  */
-void send_json_game_start(int socket, const char *player, int min, int max) {
+void send_json_room_joined(int socket, room_t *room) {
     char json[512];
+
+    pthread_mutex_lock(&room->mutex);
     snprintf(json, sizeof(json),
-        "{\"type\":\"game_start\",\"player\":\"%s\",\"min\":%d,\"max\":%d}\n",
-        player, min, max);
+        "{\"type\":\"room_joined\",\"room\":\"%s\",\"mode\":\"%s\",\"scoring\":\"%s\","
+        "\"difficulty\":\"%s\",\"round\":%u,\"players\":%d,\"min\":%lld,\"max\":%lld}\n",
+        room->name, (room->mode == ROOM_TOURNAMENT) ? "tournament" : "race",
+        room->scoring->name, room->level->name, room->round, room->member_count,
+        (long long)room->level->min, (long long)room->level->max);
+    pthread_mutex_unlock(&room->mutex);
+
     send_message(socket, json);
 }
 
@@ -576,11 +8668,11 @@ void send_json_hint(int socket, const char *direction, int attempts) {
  * @param duration Durée en secondes
  * @param score Score final
  */
-void send_json_victory(int socket, const char *player, int number, int attempts, int duration, int score) {
+void send_json_victory(int socket, const char *player, int64_t number, int attempts, int duration, int score) {
     char json[512];
     snprintf(json, sizeof(json),
-        "{\"type\":\"victory\",\"player\":\"%s\",\"number\":%d,\"attempts\":%d,\"duration\":%d,\"score\":%d}\n",
-        player, number, attempts, duration, score);
+        "{\"type\":\"victory\",\"player\":\"%s\",\"number\":%lld,\"attempts\":%d,\"duration\":%d,\"score\":%d}\n",
+        player, (long long)number, attempts, duration, score);
     send_message(socket, json);
 }
 
@@ -610,104 +8702,252 @@ void send_json_bye(int socket, const char *message) {
     send_message(socket, json);
 }
 
+/**
+ * @brief Démarre une partie solo: nouvelle cible et nouveau jeton de reprise
+ * @param client Données du client
+ */
+void start_solo_game(client_data_t *client) {
+    char log[256];
+
+    client->target_number = random_target(client->level);
+    client->attempts = 0;
+    client->start_time = time(NULL);
+    client->resume_token = issue_resume_token();
+
+    snprintf(log, sizeof(log),
+        "Client #%d - %s: Partie démarrée (%s, cible: %lld)",
+        client->client_id, client->name, client->level->name,
+        (long long)client->target_number);
+    log_message("INFO", log);
+
+    // Message de début de partie (avec difficulté et jeton de reprise)
+    send_json_game_start(client->socket, client->name, client->level, client->resume_token);
+    event_log_append(PRAD_EVENT_GAME_START, client, client->target_number, 0, 0, 0);
+}
+
 /**
  * @brief Fonction principale de gestion d'un client (exécutée dans un thread)
  * @param arg Pointeur vers client_data_t
  * @return NULL
  *
  * Cycle de vie:
+ * 0. Reprise immédiate si le client présente "resume <jeton>" à la connexion
  * 1. Afficher les stats serveur et leaderboard
  * 2. Demander et valider le nom du joueur (3-10 lettres uniquement)
- * 3. Générer le nombre aléatoire à deviner (0-100)
+ * 3. Générer le nombre à deviner (plage de la difficulté) et émettre le jeton
  * 4. Boucle de jeu: recevoir tentatives, envoyer indices (Grand/Petit)
  * 5. Victoire: calculer score, mettre à jour leaderboard
- * 6. Nettoyage et fermeture
+ * 6. Nettoyage et fermeture (partie suspendue si la connexion est perdue)
+ * Une session reçue par bascule à chaud reprend à l'étape 2 ou 4, sans accueil.
  */
 void *handle_client(void *arg) {
     client_data_t *client = (client_data_t *)arg;
     char buffer[BUFFER_SIZE];
     char response[BUFFER_SIZE];
 
-    // Mise à jour des compteurs
+    // Client WebSocket: poignée de main HTTP avant tout message du jeu
+    if (websocket_state(client->socket) == WEBSOCKET_HANDSHAKE &&
+        websocket_handshake(client->socket) < 0) {
+        close(client->socket);
+        ip_release(client->ip);
+        free(client);
+        pthread_exit(NULL);
+    }
+
+    // Boîte d'envoi des messages diffusés (salons)
+    if (outbox_init(&client->outbox) < 0) {
+        log_message("ERROR", "Erreur de création de la boîte d'envoi");
+        close(client->socket);
+        ip_release(client->ip);
+        free(client);
+        pthread_exit(NULL);
+    }
+
+    // Mise à jour des compteurs et inscription (avis d'arrêt)
     pthread_mutex_lock(&clients_mutex);
     active_clients++;
-    total_clients_served++;
+    if (!client->adopted) {
+        total_clients_served++;
+    }
+    client->next_session = sessions;
+    if (sessions) {
+        sessions->prev_session = client;
+    }
+    sessions = client;
+    worker_account();
     pthread_mutex_unlock(&clients_mutex);
 
-    // Log de connexion
+    // Log de connexion (format_address: sans allocation ni buffer partagé)
+    char address[ADDRESS_TEXT_MAX];
     snprintf(buffer, sizeof(buffer),
-        "Client #%d connecté depuis %s",
+        client->adopted ? "Client #%d repris après bascule (%s)%s" : "Client #%d connecté depuis %s%s",
         client->client_id,
-        inet_ntoa(client->address.sin_addr));
+        format_address((const struct sockaddr *)&client->address, address, sizeof(address)),
+        websocket_state(client->socket) == WEBSOCKET_OPEN ? " en WebSocket" : "");
     log_message("INFO", buffer);
+    if (!client->adopted) {
+        event_log_append(PRAD_EVENT_CONNECT, client, 0, 0, 0, 0);
+    }
 
     // ========================================================================
-    // ÉTAPE 1: AFFICHER LES STATISTIQUES ET LEADERBOARD EN JSON
-    // ========================================================================
-    send_json_stats(client->socket);
-    send_json_leaderboard(client->socket);
-
-    // ========================================================================
-    // ÉTAPE 2: DEMANDER ET VALIDER LE NOM DU JOUEUR
+    // ÉTAPE 0: REPRISE IMMÉDIATE D'UNE PARTIE SUSPENDUE
     // ========================================================================
-    send_json_prompt(client->socket, "Entrez votre nom (3-10 lettres, a-z uniquement)");
-
-    // Boucle de validation du nom
-    int name_validated = 0;
-    int name_attempts = 0;
-    const int MAX_NAME_ATTEMPTS = 5;
+    // Un client qui se reconnecte envoie "resume <jeton>" dès la connexion:
+    // si la ligne est déjà arrivée, l'accueil n'est pas rejoué. Une session
+    // reprise après bascule continue là où l'ancien processus l'a laissée.
+    // En WebSocket, la reprise arrive après la réponse 101: reprise tardive.
+    int resumed = 0;
+    uint64_t token;
+    char peek[32];
+
+    // Proxy local: en-tête PROXY avec l'adresse du vrai client, avant tout
+    if (!client->adopted && websocket_state(client->socket) == WEBSOCKET_NONE &&
+        is_loopback(&client->address) && proxy_header_peek(client) < 0) {
+        send_json_error(client->socket,
+            "Trop de connexions depuis votre adresse. Reessayez plus tard.");
+        goto cleanup;
+    }
 
-    while (!name_validated && name_attempts < MAX_NAME_ATTEMPTS) {
-        if (receive_message(client->socket, buffer, BUFFER_SIZE) <= 0) {
-            log_message("WARNING", "Client déconnecté pendant la saisie du nom");
-            goto cleanup;
+    ssize_t peeked = (client->adopted || websocket_state(client->socket) != WEBSOCKET_NONE)
+        ? 0 : recv(client->socket, peek, sizeof(peek) - 1, MSG_PEEK | MSG_DONTWAIT);
+
+    if (peeked > 0) {
+        peek[peeked] = '\0';
+        if (parse_resume_command(peek, &token)) {
+            if (receive_message(client->socket, buffer, BUFFER_SIZE) <= 0) {
+                goto cleanup;
+            }
+            if (parse_resume_command(buffer, &token) && claim_parked_session(token, client)) {
+                resumed = 1;
+            } else {
+                send_json_error(client->socket, "Jeton de reprise invalide ou expire");
+            }
         }
+    }
 
-        name_attempts++;
-
-        // Validation stricte du nom
-        if (validate_name(buffer)) {
-            strncpy(client->name, buffer, MAX_NAME_LENGTH - 1);
-            client->name[MAX_NAME_LENGTH - 1] = '\0';
-            name_validated = 1;
+    if (!resumed && !client->playing) {
+        if (!client->adopted) {
+            // ================================================================
+            // ÉTAPE 1: AFFICHER LES STATISTIQUES ET LEADERBOARD EN JSON
+            // ================================================================
+            send_read_snapshot(client->socket, GAME_SOLO, (int)(client->level - difficulties));
 
-            send_json_name_accepted(client->socket, client->name);
+            // ================================================================
+            // ÉTAPE 2: DEMANDER ET VALIDER LE NOM DU JOUEUR (OU REPRENDRE)
+            // ================================================================
+            send_json_prompt(client->socket, "Entrez votre nom (3-10 lettres, a-z uniquement)");
+        }
 
-            snprintf(buffer, sizeof(buffer),
-                "Client #%d: Nom validé '%s'", client->client_id, client->name);
-            log_message("SUCCESS", buffer);
-        } else {
-            send_json_error(client->socket,
-                "Nom invalide ! Longueur: 3-10 lettres (a-z, A-Z uniquement)");
+        // Boucle de validation du nom
+        int name_validated = 0;
+        int name_attempts = 0;
+        const int MAX_NAME_ATTEMPTS = 5;
+
+        while (!name_validated && name_attempts < MAX_NAME_ATTEMPTS) {
+            if (wait_message(client, buffer, BUFFER_SIZE) <= 0) {
+                if (!client->drained && !client->handed_over) {
+                    log_message("WARNING", "Client déconnecté pendant la saisie du nom");
+                }
+                goto cleanup;
+            }
+
+            name_attempts++;
+
+            // En-tête PROXY arrivé après la connexion (pair local uniquement)
+            if (strncmp(buffer, "PROXY ", 6) == 0) {
+                name_attempts--;
+                if (is_loopback(&client->address) && proxy_header_apply(client, buffer) < 0) {
+                    send_json_error(client->socket,
+                        "Trop de connexions depuis votre adresse. Reessayez plus tard.");
+                    goto cleanup;
+                }
+                continue;
+            }
+
+            // Mode spectateur: le socket est confié au flux d'événements (lignes brutes)
+            if (strcasecmp(buffer, "spectate") == 0 &&
+                websocket_state(client->socket) != WEBSOCKET_NONE) {
+                name_attempts--;
+                send_json_error(client->socket, "Mode spectateur disponible en TCP uniquement");
+                continue;
+            }
+            if (strcasecmp(buffer, "spectate") == 0) {
+                send_message(client->socket,
+                    "{\"type\":\"spectating\",\"message\":\"Mode spectateur: leaderboard et victoires en direct\"}\n");
+                if (spectator_attach(client->socket) == 0) {
+                    snprintf(buffer, sizeof(buffer),
+                        "Client #%d: passe en mode spectateur", client->client_id);
+                    log_message("INFO", buffer);
+                    client->socket = -1;
+                } else {
+                    send_json_error(client->socket, "Trop de spectateurs. Reessayez plus tard.");
+                }
+                goto cleanup;
+            }
+
+            // Reprise tardive (accueil déjà envoyé)
+            if (parse_resume_command(buffer, &token)) {
+                if (claim_parked_session(token, client)) {
+                    resumed = 1;
+                    name_validated = 1;
+                } else {
+                    send_json_error(client->socket, "Jeton de reprise invalide ou expire");
+                }
+                continue;
+            }
+
+            // Validation stricte du nom
+            if (validate_name(buffer)) {
+                strncpy(client->name, buffer, MAX_NAME_LENGTH - 1);
+                client->name[MAX_NAME_LENGTH - 1] = '\0';
+                name_validated = 1;
+
+                send_json_name_accepted(client->socket, client->name);
+                event_log_append(PRAD_EVENT_NAME, client, 0, 0, 0, 0);
+
+                snprintf(buffer, sizeof(buffer),
+                    "Client #%d: Nom validé '%s'", client->client_id, client->name);
+                log_message("SUCCESS", buffer);
+            } else {
+                send_json_error(client->socket,
+                    "Nom invalide ! Longueur: 3-10 lettres (a-z, A-Z uniquement)");
+            }
         }
-    }
 
-    if (!name_validated) {
-        send_json_error(client->socket, "Trop de tentatives invalides. Deconnexion.");
-        goto cleanup;
+        if (!name_validated) {
+            send_json_error(client->socket, "Trop de tentatives invalides. Deconnexion.");
+            goto cleanup;
+        }
     }
 
-    // ========================================================================
-    // ÉTAPE 3: GÉNÉRER LE NOMBRE ALÉATOIRE ET INITIALISER LA PARTIE
-    // ========================================================================
-    client->target_number = (rand() % (MAX_NUMBER - MIN_NUMBER + 1)) + MIN_NUMBER;
-    client->attempts = 0;
-    client->start_time = time(NULL);
-
-    snprintf(buffer, sizeof(buffer),
-        "Client #%d - %s: Partie démarrée (cible: %d)",
-        client->client_id, client->name, client->target_number);
-    log_message("INFO", buffer);
+    if (resumed) {
+        send_json_resumed(client->socket, client);
 
-    // Message de début de partie
-    send_json_game_start(client->socket, client->name, MIN_NUMBER, MAX_NUMBER);
+        snprintf(buffer, sizeof(buffer),
+            "Client #%d - %s: Partie reprise (%d tentatives)",
+            client->client_id, client->name, client->attempts);
+        log_message("SUCCESS", buffer);
+    } else if (!client->playing) {
+        // ====================================================================
+        // ÉTAPE 3: GÉNÉRER LE NOMBRE ALÉATOIRE ET INITIALISER LA PARTIE
+        // ====================================================================
+        start_solo_game(client);
+    }
 
     // ========================================================================
     // ÉTAPE 4: BOUCLE DE JEU PRINCIPALE
     // ========================================================================
+    client->playing = 1;
     while (1) {
-        if (receive_message(client->socket, buffer, BUFFER_SIZE) <= 0) {
-            log_message("WARNING", "Client déconnecté");
+        if (wait_message(client, buffer, BUFFER_SIZE) <= 0) {
+            if (client->drained || client->handed_over) {
+                break;
+            }
+            // Connexion perdue en cours de partie solo: la suspendre pour reprise
+            if (!client->room && client->resume_token != 0) {
+                park_session(client);
+            }
+            log_message("WARNING", "Client déconnecté (partie suspendue)");
             break;
         }
 
@@ -719,41 +8959,193 @@ void *handle_client(void *arg) {
             break;
         }
 
-        // Commande STATS
-        if (strcasecmp(buffer, "stats") == 0) {
-            send_json_stats(client->socket);
-            send_json_leaderboard(client->socket);
+        // Commande STATS [mode] [difficulté]: partie courante par défaut
+        if (strcasecmp(buffer, "stats") == 0 || strncasecmp(buffer, "stats ", 6) == 0) {
+            game_mode_t mode = client_game_mode(client);
+            const difficulty_t *level = client_difficulty(client);
+            char *save = NULL;
+            int known = 1;
             client->attempts--; // Ne pas compter comme tentative
+            for (char *word = strtok_r(buffer + 5, " ", &save); word && known;
+                 word = strtok_r(NULL, " ", &save)) {
+                known = 0;
+                for (int m = 0; m < GAME_MODES; m++) {
+                    if (strcasecmp(word, prad_mode_name(m)) == 0) {
+                        mode = (game_mode_t)m;
+                        known = 1;
+                    }
+                }
+                if (find_difficulty(word)) {
+                    level = find_difficulty(word);
+                    known = 1;
+                }
+            }
+            if (!known) {
+                send_json_error(client->socket,
+                    "Mode ou difficulte inconnu (solo, race, tournament; easy, medium, hard, extreme)");
+                continue;
+            }
+            if (!ip_consume(client->ip, BUCKET_STATS)) {
+                send_json_error(client->socket, "Trop de requetes stats, ralentissez");
+                continue;
+            }
+            send_read_snapshot(client->socket, mode, (int)(level - difficulties));
             continue;
         }
 
-        // Validation de l'entrée (nombre entier)
-        char *endptr;
-        errno = 0;
-        long guess = strtol(buffer, &endptr, 10);
+        // Arrêt en cours: la partie courante peut se terminer, pas en commencer une
+        int is_join = (strncasecmp(buffer, "join ", 5) == 0);
+        int is_tournament = (strncasecmp(buffer, "tournament ", 11) == 0);
+        if (drain_active() && (is_join || is_tournament || strcasecmp(buffer, "leave") == 0 ||
+                               strncasecmp(buffer, "level ", 6) == 0)) {
+            client->attempts--;
+            send_json_error(client->socket, "Arret du serveur en cours: pas de nouvelle partie");
+            continue;
+        }
 
-        if (errno != 0 || *endptr != '\0' || endptr == buffer) {
-            send_json_error(client->socket, "Entrez un nombre entier valide");
+        // Commande LEVEL <difficulté>: nouvelle partie solo dans cette plage
+        if (strncasecmp(buffer, "level ", 6) == 0) {
+            const difficulty_t *level = find_difficulty(buffer + 6);
+            client->attempts--;
+            if (!level) {
+                send_json_error(client->socket,
+                    "Difficulte inconnue (easy, medium, hard, extreme)");
+                continue;
+            }
+            if (client->room) {
+                send_json_error(client->socket,
+                    "La difficulte d'un salon est celle de son createur (leave d'abord)");
+                continue;
+            }
+            client->level = level;
+            start_solo_game(client);
+            continue;
+        }
+
+        // Commandes JOIN <salon> / TOURNAMENT <salon>: partie multi-joueurs
+        if (is_join || is_tournament) {
+            const char *room_name = buffer + (is_join ? 5 : 11);
+            room_mode_t mode = is_join ? ROOM_RACE : ROOM_TOURNAMENT;
+
+            client->attempts--;
+            if (!validate_room_name(room_name)) {
+                send_json_error(client->socket, "Nom de salon invalide (1-15 lettres ou chiffres)");
+                continue;
+            }
+            room_leave(client);
+            if (!room_join(client, room_name, mode)) {
+                send_json_error(client->socket, "Salon plein, d'un autre type ou trop de salons ouverts");
+                start_solo_game(client);
+                continue;
+            }
+            send_json_room_joined(client->socket, client->room);
+            event_log_append(PRAD_EVENT_GAME_START, client, -1, 0, 0, 0);
+
+            snprintf(response, sizeof(response),
+                "Client #%d - %s: Entrée dans le salon '%s' (%s)",
+                client->client_id, client->name, client->room->name,
+                is_join ? "course" : "tournoi");
+            log_message("INFO", response);
+            continue;
+        }
+
+        // Commande LEAVE: quitter le salon et revenir à une partie solo
+        if (strcasecmp(buffer, "leave") == 0) {
             client->attempts--;
+            if (client->room) {
+                room_leave(client);
+                start_solo_game(client);
+            }
             continue;
         }
 
-        // Vérification de la plage
-        if (guess < MIN_NUMBER || guess > MAX_NUMBER) {
+        // Validation de l'entrée (entier dans la plage de la difficulté)
+        const difficulty_t *level = client_difficulty(client);
+        int64_t guess;
+        int invalid = parse_guess(buffer, level, &guess);
+
+        if (invalid < 0) {
+            send_json_error(client->socket, "Entrez un nombre entier valide");
+            client->attempts--;
+            continue;
+        }
+        if (invalid > 0) {
             snprintf(response, sizeof(response),
-                "Le nombre doit etre entre %d et %d",
-                MIN_NUMBER, MAX_NUMBER);
+                "Le nombre doit etre entre %lld et %lld",
+                (long long)level->min, (long long)level->max);
             send_json_error(client->socket, response);
             client->attempts--;
             continue;
         }
 
-        // Log de tentative
-        snprintf(buffer, sizeof(buffer),
-            "Client #%d - %s: Tentative %d → %ld (cible: %d)",
-            client->client_id, client->name, client->attempts,
-            guess, client->target_number);
-        log_message("INFO", buffer);
+        // Limite de débit des tentatives (par adresse source)
+        if (!ip_consume(client->ip, BUCKET_GUESS)) {
+            send_json_error(client->socket, "Trop de tentatives par seconde, ralentissez");
+            client->attempts--;
+            continue;
+        }
+        event_log_append(PRAD_EVENT_GUESS, client, guess, client->attempts, 0, 0);
+
+        // ====================================================================
+        // PARTIE EN SALON: CIBLE PARTAGÉE, ÉVÉNEMENTS DIFFUSÉS
+        // ====================================================================
+        if (client->room && client->room->mode == ROOM_TOURNAMENT) {
+            unsigned int turn;
+            client->attempts--; // Comptée par tour dans room_submit
+            __atomic_add_fetch(&moves_in_flight, 1, __ATOMIC_RELAXED);
+            int64_t remaining = room_submit(client, guess, &turn);
+            __atomic_sub_fetch(&moves_in_flight, 1, __ATOMIC_RELAXED);
+
+            snprintf(response, sizeof(response),
+                "{\"type\":\"submitted\",\"room\":\"%s\",\"turn\":%u,\"guess\":%lld,"
+                "\"closes_in\":%lld}\n",
+                client->room->name, turn, (long long)guess, (long long)remaining);
+            send_message(client->socket, response);
+            continue;
+        }
+
+        if (client->room) {
+            int duration = 0, score = 0;
+            __atomic_add_fetch(&moves_in_flight, 1, __ATOMIC_RELAXED);
+            int result = room_guess(client, guess, &duration, &score);
+
+            if (result != 0) {
+                __atomic_sub_fetch(&moves_in_flight, 1, __ATOMIC_RELAXED);
+                send_json_hint(client->socket, (result > 0) ? "grand" : "petit", client->attempts);
+                continue;
+            }
+
+            send_json_victory(client->socket, client->name, guess,
+                              client->attempts, duration, score);
+            announce_victory(client->room->name, client->name, guess,
+                             client->attempts, duration, score);
+            event_log_append(PRAD_EVENT_VICTORY, client, guess, client->attempts,
+                             duration, score);
+            record_game(client->name, GAME_RACE, (int)(level - difficulties), client->attempts,
+                        duration, score, 0);
+            __atomic_sub_fetch(&moves_in_flight, 1, __ATOMIC_RELAXED);
+
+            snprintf(buffer, sizeof(buffer),
+                "Client #%d - %s: VICTOIRE dans le salon '%s' en %d tentatives (%ds) - Score: %d",
+                client->client_id, client->name, client->room->name,
+                client->attempts, duration, score);
+            log_message("SUCCESS", buffer);
+
+            // Arrêt en cours: la partie est terminée, pas de manche suivante
+            if (drain_active()) {
+                break;
+            }
+            continue;
+        }
+
+        // Log de tentative (mise en forme évitée si le niveau INFO est masqué)
+        if (log_enabled("INFO")) {
+            snprintf(buffer, sizeof(buffer),
+                "Client #%d - %s: Tentative %d → %lld (cible: %lld)",
+                client->client_id, client->name, client->attempts,
+                (long long)guess, (long long)client->target_number);
+            log_message("INFO", buffer);
+        }
 
         // ====================================================================
         // COMPARAISON ET RÉPONSE
@@ -770,18 +9162,27 @@ void *handle_client(void *arg) {
             // ================================================================
             time_t end_time = time(NULL);
             int duration = (int)difftime(end_time, client->start_time);
-            int score = calculate_score(client->attempts, duration);
+            int score = scoring_by_mode[GAME_SOLO]->score(client->attempts, duration,
+                                                          level->bits);
 
             // Message de victoire JSON
             send_json_victory(client->socket, client->name, client->target_number,
                             client->attempts, duration, score);
 
-            // Mise à jour des statistiques et leaderboard
-            update_stats(client->attempts);
-            add_to_leaderboard(client->name, client->attempts, duration, score);
-
-            // Afficher le nouveau leaderboard
-            send_json_leaderboard(client->socket);
+            // Mise à jour des statistiques et leaderboard par le thread propriétaire
+            announce_victory(NULL, client->name, client->target_number,
+                             client->attempts, duration, score);
+            event_log_append(PRAD_EVENT_VICTORY, client, client->target_number,
+                             client->attempts, duration, score);
+            __atomic_add_fetch(&moves_in_flight, 1, __ATOMIC_RELAXED);
+            record_game(client->name, GAME_SOLO, (int)(level - difficulties), client->attempts,
+                        duration, score, 1);
+            __atomic_sub_fetch(&moves_in_flight, 1, __ATOMIC_RELAXED);
+
+            // Afficher le nouveau leaderboard (sauf délestage)
+            if (current_shed_level() < SHED_NO_PUSH) {
+                send_json_leaderboard(client->socket, GAME_SOLO, (int)(level - difficulties));
+            }
 
             // Log de victoire
             snprintf(buffer, sizeof(buffer),
@@ -799,15 +9200,47 @@ cleanup:
     // NETTOYAGE ET DÉCONNEXION
     // ========================================================================
     snprintf(buffer, sizeof(buffer),
-        "Client #%d - %s: Déconnexion",
+        client->handed_over ? "Client #%d - %s: Transmis au nouveau processus"
+                            : "Client #%d - %s: Déconnexion",
         client->client_id,
         client->name[0] ? client->name : "Anonyme");
     log_message("INFO", buffer);
+    if (!client->handed_over) {
+        event_log_append(PRAD_EVENT_DISCONNECT, client, 0, client->attempts, 0, 0);
+    }
+
+    if (client->drained) {
+        send_message(client->socket,
+            "{\"type\":\"bye\",\"reason\":\"server_shutdown\","
+            "\"message\":\"Serveur arrete, a bientot\"}\n");
+        __atomic_add_fetch(&drain.closed, 1, __ATOMIC_RELAXED);
+    } else if (drain_active()) {
+        __atomic_add_fetch(&drain.finished, 1, __ATOMIC_RELAXED);
+    }
+
+    // Désinscription avant la destruction de la boîte d'envoi
+    pthread_mutex_lock(&clients_mutex);
+    if (client->prev_session) {
+        client->prev_session->next_session = client->next_session;
+    } else {
+        sessions = client->next_session;
+    }
+    if (client->next_session) {
+        client->next_session->prev_session = client->prev_session;
+    }
+    pthread_mutex_unlock(&clients_mutex);
 
-    close(client->socket);
+    room_leave(client);
+    if (client->socket >= 0) {
+        websocket_close(client->socket, client->drained ? 1001 : 1000);
+        close(client->socket);
+    }
+    outbox_destroy(&client->outbox);
+    ip_release(client->ip);
 
     pthread_mutex_lock(&clients_mutex);
     active_clients--;
+    worker_account();
     pthread_mutex_unlock(&clients_mutex);
 
     free(client);
@@ -816,21 +9249,87 @@ cleanup:
 
 /**
  * @brief Fonction principale du serveur
+ * @param argc Nombre d'arguments
+ * @param argv Arguments (-c fichier, -p port, -o clé=valeur, -u socket, -r socket)
  * @return EXIT_SUCCESS ou EXIT_FAILURE
  */
-int main(void) {
-    struct sockaddr_in server_addr, client_addr;
-    socklen_t client_len = sizeof(client_addr);
+int main(int argc, char **argv) {
     int client_counter = 0;
+    int takeover = 0;
+    int following = 0;
 
-    // Initialisation du générateur aléatoire
+    // Initialisation des générateurs aléatoires
     srand((unsigned int)time(NULL));
+    seed_random();
+    for (int i = 0; i < MAX_ROOMS; i++) {
+        pthread_mutex_init(&rooms[i].mutex, NULL);
+    }
     global_stats.server_start_time = time(NULL);
 
-    // Configuration des gestionnaires de signaux
-    signal(SIGINT, handle_signal);
-    signal(SIGTERM, handle_signal);
-    signal(SIGPIPE, SIG_IGN); // Ignorer SIGPIPE
+    // Options: fichier de configuration et surcharges (réappliquées sur SIGHUP)
+    int option;
+    while ((option = getopt(argc, argv, "c:p:o:u:r:h")) != -1) {
+        if (option == 'c') {
+            config_path = optarg;
+            continue;
+        }
+        if ((option != 'p' && option != 'o' && option != 'u' && option != 'r') ||
+            config_override_count == CONFIG_OVERRIDES || (takeover && option == 'r') ||
+            (following && option == 'u')) {
+            usage(argv[0]);
+            exit(option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE);
+        }
+        const char **override = config_overrides[config_override_count++];
+        if (option == 'p') {
+            override[0] = "port";
+            override[1] = optarg;
+        } else if (option == 'u') {
+            override[0] = "handoff_socket";
+            override[1] = optarg;
+            takeover = 1;
+        } else if (option == 'r') {
+            override[0] = "standby_socket";
+            override[1] = optarg;
+            following = 1;
+        } else {
+            char *equal = strchr(optarg, '=');
+            if (!equal) {
+                usage(argv[0]);
+                exit(EXIT_FAILURE);
+            }
+            *equal = '\0';
+            override[0] = optarg;
+            override[1] = equal + 1;
+        }
+    }
+    if (optind < argc) {
+        usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    // Configuration initiale: défauts < fichier < environnement < options
+    server_config_t initial;
+    char config_error[BUFFER_SIZE];
+    if (config_build(&initial, config_error, sizeof(config_error)) < 0) {
+        fprintf(stderr, "❌ Configuration invalide: %s\n", config_error);
+        exit(EXIT_FAILURE);
+    }
+    config_apply(&initial, 1);
+    configure_scoring(config.scoring[0] ? config.scoring : NULL);
+    if (ip_table_init(config.max_clients) < 0) {
+        fprintf(stderr, "❌ Allocation de la table des adresses impossible\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Signaux: SIGPIPE ignoré; SIGHUP, SIGINT et SIGTERM bloqués avant tout
+    // thread (masque hérité) et reçus par signal_thread
+    signal(SIGPIPE, SIG_IGN);
+    sigset_t signal_set;
+    sigemptyset(&signal_set);
+    sigaddset(&signal_set, SIGHUP);
+    sigaddset(&signal_set, SIGINT);
+    sigaddset(&signal_set, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signal_set, NULL);
 
     // Bannière de démarrage
     printf("\n");
@@ -843,107 +9342,326 @@ int main(void) {
     printf("║  Cours  : PRAD - TP1 (Architecture Distribuée)        ║\n");
     printf("╚════════════════════════════════════════════════════════╝\n\n");
 
-    // Création du socket serveur
-    server_socket = socket(AF_INET, SOCK_STREAM, 0);
-    if (server_socket < 0) {
-        perror("❌ Erreur de création du socket");
+    // WebSocket: port distinct, table d'état des sockets (aussi pour les sessions reprises)
+    if (config.ws_port && config.ws_port == config.port) {
+        fprintf(stderr, "❌ Clé ws_port identique au port de jeu (%d)\n", config.port);
+        exit(EXIT_FAILURE);
+    }
+    if (websocket_init() < 0) {
+        perror("❌ Erreur d'allocation de la table WebSocket");
         exit(EXIT_FAILURE);
     }
 
-    // Option pour réutiliser le port immédiatement
-    int opt = 1;
-    if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
-        perror("❌ Erreur setsockopt");
-        close(server_socket);
+    // Cluster: un seul processus par nœud, qui garde son port de réplication
+    if (config.cluster_port && (config.workers > 1 || config.handoff_socket[0])) {
+        fprintf(stderr, "❌ Clé cluster_port incompatible avec workers > 1 et handoff_socket\n");
+        exit(EXIT_FAILURE);
+    }
+
+    // Workers: segment partagé puis un processus par worker (le superviseur ne revient pas)
+    if (config.workers > 1) {
+        if (config.handoff_socket[0] || config.standby_socket[0]) {
+            fprintf(stderr, "❌ Bascule à chaud (handoff_socket, -u) et réplique (standby_socket, -r)"
+                            " incompatibles avec workers > 1\n");
+            exit(EXIT_FAILURE);
+        }
+        if (workers_init(config.workers) < 0) {
+            perror("❌ Erreur de création du segment partagé des workers");
+            exit(EXIT_FAILURE);
+        }
+        if (local_game_listen() < 0) { // Partagé par les workers
+            perror("❌ Erreur d'ouverture du socket Unix de jeu (clé unix_socket)");
+            exit(EXIT_FAILURE);
+        }
+        char log[80];
+        snprintf(log, sizeof(log), "Superviseur: lancement de %d workers", config.workers);
+        log_message("INFO", log);
+        workers_start();
+    }
+
+    // Bascule à chaud: socket d'écoute, sessions et leaderboard de l'ancien processus
+    if (takeover && handoff_receive(config.handoff_socket, &client_counter) < 0) {
+        fprintf(stderr, "❌ Bascule impossible depuis %s (ancien processus conservé)\n",
+                config.handoff_socket);
         exit(EXIT_FAILURE);
     }
 
-    // Configuration de l'adresse du serveur
-    memset(&server_addr, 0, sizeof(server_addr));
-    server_addr.sin_family = AF_INET;
-    server_addr.sin_addr.s_addr = INADDR_ANY; // Écoute sur toutes les interfaces
-    server_addr.sin_port = htons(PORT);
+    // Réplique de secours: leaderboard et parties suspendues suivis en mémoire
+    // jusqu'à la disparition du primaire, puis son port
+    if (following && standby_follow(config.standby_socket) < 0) {
+        fprintf(stderr, "❌ Chemin de réplique invalide: %s\n", config.standby_socket);
+        exit(EXIT_FAILURE);
+    }
+
+    // Création des écoutes TCP (sauf si elles ont été reçues ou reprises)
+    if (!takeover && !following) {
+        if (server_listen() < 0) {
+            perror("❌ Erreur d'ouverture des écoutes (clés bind, port)");
+            exit(EXIT_FAILURE);
+        }
+    }
+    // Socket Unix de jeu: après la fin du suivi du primaire pour une réplique
+    if (local_game_listen() < 0) {
+        perror("❌ Erreur d'ouverture du socket Unix de jeu (clé unix_socket)");
+        exit(EXIT_FAILURE);
+    }
+
+    // Thread unique du flux spectateurs
+    spectator_hub.wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    pthread_t spectator_id;
+    if (spectator_hub.wake_fd < 0 ||
+        pthread_create(&spectator_id, NULL, spectator_thread, NULL) != 0) {
+        perror("❌ Erreur de création du flux spectateurs");
+        listeners_close();
+        exit(EXIT_FAILURE);
+    }
+    pthread_detach(spectator_id);
+
+    // Journal d'événements (facultatif: clé "event_log" ou PRAD_EVENT_LOG);
+    // un sous-répertoire par worker, chaque journal n'ayant qu'un écrivain
+    char worker_dir[CONFIG_VALUE_MAX + 16];
+    const char *event_dir = config.event_log;
+    if (*event_dir && workers.count > 1) {
+        mkdir(event_dir, 0755);
+        snprintf(worker_dir, sizeof(worker_dir), "%s/worker-%d", event_dir, workers.index);
+        event_dir = worker_dir;
+    }
+    if (*event_dir) {
+        pthread_t event_log_id;
+        if (event_log_open(event_dir) < 0 ||
+            pthread_create(&event_log_id, NULL, event_log_thread, NULL) != 0) {
+            event_log.enabled = 0;
+            log_message("WARNING", "Journal d'événements indisponible");
+        } else {
+            pthread_detach(event_log_id);
+        }
+    }
+
+    // Export SQLite des parties terminées (facultatif: clé "sqlite" ou PRAD_SQLITE)
+    const char *export_path = config.sqlite;
+    if (*export_path) {
+#ifdef PRAD_WITH_SQLITE
+        sqlite3 *db = export_open(export_path);
+        pthread_t export_id;
+        export_queue.enabled = 1;
+        if (db && pthread_create(&export_id, NULL, export_thread, db) == 0) {
+            pthread_detach(export_id);
+        } else {
+            export_queue.enabled = 0;
+            sqlite3_close(db);
+            log_message("WARNING", "Export SQLite indisponible");
+        }
+#else
+        log_message("WARNING", "Clé sqlite ignorée: serveur compilé sans PRAD_WITH_SQLITE");
+#endif
+    }
+
+    // Export en mémoire partagée (facultatif, worker 0 seul), puis premier instantané
+    if (workers.index == 0 && shm_export_init() < 0) {
+        log_message("WARNING", "Export mémoire partagée indisponible (" PRAD_SHM_NAME ")");
+    }
+
+    // Réplication entre nœuds (facultative: clé cluster_port); les identifiants
+    // de scores partent de la date courante pour rester uniques après un redémarrage,
+    // et portent le nœud et le worker: deux workers démarrés dans la même
+    // milliseconde ne se prennent pas leurs entrées (board_share_pull)
+    if (config.cluster_port && cluster_init() < 0) {
+        perror("❌ Erreur d'ouverture du port de réplication (cluster_port, cluster_bind, "
+               "cluster_peers, cluster_secret)");
+        listeners_close();
+        exit(EXIT_FAILURE);
+    }
+    cluster.next_origin = ((uint64_t)cluster.node << 48) | ((uint64_t)workers.index << 42) |
+                          ((uint64_t)(realtime_us() / 1000) & ((1ULL << 42) - 1));
+
+    // Thread propriétaire du leaderboard et des statistiques
+    board_share_refresh();
+    board_publish();
+    scoreboard.wake_fd = eventfd(0, EFD_CLOEXEC);
+    pthread_t scoreboard_id;
+    if (!scoreboard.published || scoreboard.wake_fd < 0 ||
+        pthread_create(&scoreboard_id, NULL, scoreboard_thread, NULL) != 0) {
+        perror("❌ Erreur de création du thread du leaderboard");
+        listeners_close();
+        exit(EXIT_FAILURE);
+    }
+    pthread_detach(scoreboard_id);
+
+    // Thread de réplication (après le premier instantané: envoi complet)
+    if (cluster.enabled) {
+        pthread_t cluster_id;
+        if (pthread_create(&cluster_id, NULL, cluster_thread, NULL) != 0) {
+            perror("❌ Erreur de création du thread de réplication");
+            listeners_close();
+            exit(EXIT_FAILURE);
+        }
+        pthread_detach(cluster_id);
+    }
+
+    // Thread de résolution des tournois par tours
+    pthread_t tournament_id;
+    if (pthread_create(&tournament_id, NULL, tournament_thread, NULL) != 0) {
+        perror("❌ Erreur de création du thread de tournoi");
+        listeners_close();
+        exit(EXIT_FAILURE);
+    }
+    pthread_detach(tournament_id);
 
-    // Liaison du socket
-    if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
-        perror("❌ Erreur de liaison du port");
-        close(server_socket);
+    // Sonde de retard pour le délestage
+    pthread_t lag_id;
+    if (pthread_create(&lag_id, NULL, lag_monitor_thread, NULL) != 0) {
+        perror("❌ Erreur de création de la sonde de charge");
+        listeners_close();
         exit(EXIT_FAILURE);
     }
+    pthread_detach(lag_id);
 
-    // Mise en écoute
-    if (listen(server_socket, MAX_CLIENTS) < 0) {
-        perror("❌ Erreur de mise en écoute");
-        close(server_socket);
+    // Rechargement (SIGHUP) et arrêt progressif (SIGINT, SIGTERM)
+    pthread_t signal_id;
+    if (pthread_create(&signal_id, NULL, signal_thread, NULL) != 0) {
+        perror("❌ Erreur de création du thread des signaux");
+        listeners_close();
         exit(EXIT_FAILURE);
     }
+    pthread_detach(signal_id);
+
+    // Sessions reçues par bascule, puis écoute d'une bascule suivante
+    for (int i = 0; i < handoff.count; i++) {
+        if (session_adopt(&handoff.entries[i].state, handoff.entries[i].socket) == 0) {
+            handoff.adopted++;
+        }
+    }
+    free(handoff.entries);
+    handoff.entries = NULL;
+    handoff.count = handoff.capacity = 0;
+    if (config.handoff_socket[0] && handoff_listen(config.handoff_socket) < 0) {
+        log_message("WARNING", "Socket de bascule indisponible (clé handoff_socket)");
+    }
+
+    // Journal vers une réplique de secours (aussi après une promotion)
+    if (config.standby_socket[0]) {
+        pthread_t standby_id;
+        standby.listener = local_listen(config.standby_socket, SOCK_SEQPACKET | SOCK_CLOEXEC,
+                                        0600, 1);
+        if (standby.listener < 0 ||
+            pthread_create(&standby_id, NULL, standby_thread, NULL) != 0) {
+            log_message("WARNING", "Socket de réplique indisponible (clé standby_socket)");
+        } else {
+            pthread_detach(standby_id);
+        }
+    }
+
+    // Socket d'administration (worker 0 seul: leaderboard partagé)
+    if (workers.index == 0 && admin_listen() < 0) {
+        log_message("WARNING", "Socket d'administration indisponible (clé admin_socket)");
+    }
 
     // Affichage des informations de démarrage
     log_message("SUCCESS", "Serveur démarré avec succès");
-    printf("📡 Port d'écoute        : %d\n", PORT);
-    printf("👥 Clients max          : %d\n", MAX_CLIENTS);
-    printf("🎯 Plage de nombres     : %d - %d\n", MIN_NUMBER, MAX_NUMBER);
+    printf("⚙️  Configuration        : %s (SIGHUP pour recharger)\n",
+           config_path ? config_path : "défauts");
+    for (int i = 0; i < listener_count; i++) {
+        char address[ADDRESS_TEXT_MAX];
+        printf("%s: %s%s%s\n",
+               listeners[i].websocket ? "🕸️  Écoute WebSocket     " : "📡 Écoute TCP           ",
+               format_address((struct sockaddr *)&listeners[i].addr, address, sizeof(address)),
+               listeners[i].dual_stack ? " (IPv4 et IPv6)" : "",
+               takeover ? " (socket repris par bascule)" : "");
+    }
+    if (local_socket >= 0) {
+        printf("🔌 Socket Unix de jeu   : %s (proxy local)\n", config.unix_socket);
+    }
+    if (takeover) {
+        printf("🔁 Sessions reprises    : %lu\n", handoff.adopted);
+    }
+    if (handoff.listener >= 0) {
+        printf("🔁 Bascule à chaud      : %s (./server -u %s)\n",
+               config.handoff_socket, config.handoff_socket);
+    }
+    if (standby.listener >= 0) {
+        printf("🛟 Réplique de secours  : %s (./server -r %s)\n",
+               config.standby_socket, config.standby_socket);
+    }
+    if (admin_listener >= 0) {
+        printf("🔧 Administration       : %s (metrics, swap <fichier>)\n", config.admin_socket);
+    }
+    printf("👥 Clients max          : %d%s\n", config.max_clients,
+           workers.count > 1 ? " (par worker)" : "");
+    if (workers.count > 1) {
+        printf("🧩 Worker               : %d / %d (pid %d, SO_REUSEPORT)\n",
+               workers.index, workers.count, (int)getpid());
+    }
+    if (cluster.enabled) {
+        printf("🌐 Cluster              : nœud %u, %s port %d, %d pair(s)\n", cluster.node,
+               config.cluster_bind[0] ? config.cluster_bind : "*", config.cluster_port,
+               cluster.peer_count);
+    }
+    for (int level = 0; level < DIFFICULTY_LEVELS; level++) {
+        printf("🎯 Difficulté %-9s : %lld - %lld (%d bits)%s\n", difficulties[level].name,
+               (long long)difficulties[level].min, (long long)difficulties[level].max,
+               difficulties[level].bits, (level == 0) ? ", par défaut" : "");
+    }
     printf("🏆 Top scores           : %d\n", TOP_SCORES);
-    printf("📊 Score initial        : %d pts\n", INITIAL_SCORE);
-    printf("⚡ Pénalité/tentative   : %d pts\n", ATTEMPT_PENALTY);
+    for (int mode = 0; mode < GAME_MODES; mode++) {
+        const prad_scoring_formula_t *formula = &scoring_by_mode[mode]->formula;
+        printf("📊 Score %-14s : %s (%d - essais × %d - secondes × %d%s)\n",
+               prad_mode_name(mode), scoring_by_mode[mode]->name, formula->initial,
+               formula->per_attempt, formula->per_second, formula->scaled ? ", ajusté" : "");
+    }
+    printf("🚦 Délestage (retard)   : %d / %d / %d ms\n",
+           config.shed_ms[0], config.shed_ms[1], config.shed_ms[2]);
     printf("\n");
     log_message("INFO", "En attente de connexions clients...");
     printf("\n");
+    if (following) {
+        standby.recovery_ms = monotonic_ms() - standby.lost_ms;
+        char log[96];
+        snprintf(log, sizeof(log), "Réplique promue: service repris en %lld ms après le primaire",
+                 (long long)standby.recovery_ms);
+        log_message("SUCCESS", log);
+    }
 
     // ========================================================================
     // BOUCLE PRINCIPALE DU SERVEUR
     // ========================================================================
-    while (1) {
-        // Allocation de la structure client
-        client_data_t *client = malloc(sizeof(client_data_t));
-        if (!client) {
-            log_message("ERROR", "Erreur d'allocation mémoire pour client");
-            continue;
-        }
-        memset(client, 0, sizeof(client_data_t));
-
-        // Accepter la connexion
-        client->socket = accept(server_socket,
-                                (struct sockaddr *)&client->address,
-                                &client_len);
-
-        if (client->socket < 0) {
-            log_message("ERROR", "Erreur d'acceptation de connexion");
-            free(client);
+    // Une pollfd par écoute TCP, plus le socket Unix de jeu et la bascule
+    struct pollfd watched[LISTENERS_MAX + 2];
+    int watched_count = 0;
+    watched[watched_count++] = (struct pollfd){ .fd = handoff.listener, .events = POLLIN };
+    watched[watched_count++] = (struct pollfd){ .fd = local_socket, .events = POLLIN };
+    for (int i = 0; i < listener_count; i++) {
+        watched[watched_count++] = (struct pollfd){ .fd = listeners[i].fd, .events = POLLIN };
+    }
+    while (!drain_active()) {
+        if (poll(watched, watched_count, -1) < 0) {
             continue;
         }
 
-        // Assigner un ID unique
-        client->client_id = ++client_counter;
-
-        // Vérifier le nombre maximum de clients
-        pthread_mutex_lock(&clients_mutex);
-        int current = active_clients;
-        pthread_mutex_unlock(&clients_mutex);
-
-        if (current >= MAX_CLIENTS) {
-            log_message("WARNING", "Nombre maximum de clients atteint");
-            send_json_error(client->socket,
-                "Serveur plein ! Maximum de clients atteint. Reessayez plus tard.");
-            close(client->socket);
-            free(client);
+        // Demande de bascule: en cas de succès, le nouveau processus accepte déjà
+        if (watched[0].revents & POLLIN) {
+            if (handoff_serve(client_counter) == 0) {
+                listeners_close(); // Partagés: ne pas les interrompre dans drain_start
+                if (local_socket >= 0) {
+                    close(local_socket);
+                    local_socket = -1;
+                }
+                drain_start("Bascule vers le nouveau processus");
+                break;
+            }
             continue;
         }
 
-        // Créer un thread pour gérer le client
-        pthread_t thread_id;
-        if (pthread_create(&thread_id, NULL, handle_client, (void *)client) != 0) {
-            log_message("ERROR", "Erreur de création du thread");
-            close(client->socket);
-            free(client);
-            continue;
+        // Une connexion par écoute prête et par tour: aucune adresse n'en prive une autre
+        for (int i = 1; i < watched_count; i++) {
+            if (watched[i].revents & (POLLIN | POLLERR | POLLHUP)) {
+                accept_client(watched[i].fd, i >= 2 && listeners[i - 2].websocket,
+                              &client_counter);
+            }
         }
-
-        // Détacher le thread (libération automatique des ressources)
-        pthread_detach(thread_id);
     }
 
-    // Nettoyage (code jamais atteint sauf signal)
-    close(server_socket);
+    // Arrêt progressif: fin des parties en cours, journaux et export vidés
+    drain_wait();
+    server_exit(EXIT_SUCCESS);
     return EXIT_SUCCESS;
 }